@@ -0,0 +1,128 @@
+/**
+ * Flight Recorder Example
+ * 
+ * Logs all traffic between the library and a SmartAudio VTX to LittleFS:
+ * frames in both directions, missed replies, command results and link
+ * state changes. The log rotates through four 64 KB files.
+ * 
+ * Serial commands:
+ *   m - Put a marker into the log
+ *   d - Dump the log files as hex, one "# path" line ahead of each
+ *       (on a PC, turn each file's lines back into binary with xxd -r -p
+ *       and print them with examples/recorder-decode)
+ *   h - Show recorder statistics
+ * 
+ * Hardware Setup:
+ * - ESP32 GPIO 16 (TX) / GPIO 17 (RX) to VTX control wire
+ * - Common ground between ESP32 and VTX
+ * - A partition table with a LittleFS (spiffs) partition
+ */
+
+#include <Arduino.h>
+#include <LittleFS.h>
+#include <BetaVTXControl.h>
+#include <FSRecordSink.h>
+
+#define VTX_TX_PIN      16
+#define VTX_RX_PIN      17
+#define LOG_SLOTS       4
+#define LOG_FILE_BYTES  (64 * 1024)
+
+HardwareSerialTransport vtxPort(&Serial2, VTX_TX_PIN, VTX_RX_PIN);
+BetaVTXControl vtx(VTX_PROTOCOL_SMARTAUDIO);
+FSRecordSink logSink(LittleFS, "/vtxlog", LOG_SLOTS);
+VTXFlightRecorder recorder(LOG_FILE_BYTES);
+uint8_t markCount = 0;
+
+void dumpLog() {
+  // Written blocks only; hand over the current one first
+  recorder.sync();
+  recorder.service();
+  
+  for (uint8_t slot = 0; slot < LOG_SLOTS; slot++) {
+    char path[48];
+    logSink.slotPath(slot, path, sizeof(path));
+    File file = LittleFS.open(path, FILE_READ);
+    if (!file) {
+      continue;
+    }
+    Serial.print("# ");
+    Serial.println(path);
+    uint8_t buf[32];
+    size_t n;
+    while ((n = file.read(buf, sizeof(buf))) > 0) {
+      for (size_t i = 0; i < n; i++) {
+        if (buf[i] < 0x10) Serial.print("0");
+        Serial.print(buf[i], HEX);
+      }
+      Serial.println();
+    }
+    file.close();
+  }
+}
+
+void printStatistics() {
+  VTXRecorderStatistics s = recorder.getStatistics();
+  Serial.print("Records: ");
+  Serial.print(s.records);
+  Serial.print(", dropped: ");
+  Serial.print(s.dropped);
+  Serial.print(", blocks: ");
+  Serial.print(s.blocks);
+  Serial.print(", write errors: ");
+  Serial.print(s.writeErrors);
+  Serial.print(", files: ");
+  Serial.print(s.files);
+  Serial.print(", max write: ");
+  Serial.print(s.maxWriteUs);
+  Serial.println(" us");
+}
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) delay(10);
+  
+  Serial.println("Flight Recorder Example");
+  Serial.println("=======================");
+  
+  if (!LittleFS.begin(true)) {
+    Serial.println("LittleFS mount failed");
+    while (1) delay(100);
+  }
+  if (!recorder.begin(&logSink)) {
+    Serial.println("Cannot create log file");
+    while (1) delay(100);
+  }
+  Serial.print("Logging to file ");
+  Serial.println(recorder.getFileSequence());
+  
+  vtx.setRecorder(&recorder);
+  if (!vtx.begin(&vtxPort)) {
+    Serial.println("VTX initialization failed!");
+  }
+}
+
+void loop() {
+  vtx.update();
+  
+  // File system writes happen here, not inside update()
+  recorder.service();
+  
+  if (Serial.available()) {
+    switch (Serial.read()) {
+      case 'm':
+        recorder.mark(1, ++markCount);
+        Serial.print("Marker ");
+        Serial.println(markCount);
+        break;
+      case 'd':
+        dumpLog();
+        break;
+      case 'h':
+        printStatistics();
+        break;
+      default:
+        break;
+    }
+  }
+}
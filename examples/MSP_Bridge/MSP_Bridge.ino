@@ -0,0 +1,52 @@
+/**
+ * MSP Bridge Example
+ * 
+ * Serves the VTX state to a flight controller or OSD over MSP
+ * (MSP_VTX_CONFIG / MSP_SET_VTX_CONFIG) on a second UART. Reads are
+ * answered from the cached state without touching the slow VTX link.
+ * 
+ * Hardware Setup:
+ * - ESP32 GPIO 16 (TX) / GPIO 17 (RX) to VTX control wire
+ *   (RX is needed so the cached state gets filled in)
+ * - ESP32 GPIO 4 (RX) / GPIO 5 (TX) to FC/OSD UART running MSP at 115200
+ * - Common ground between all devices
+ */
+
+#include <Arduino.h>
+#include <BetaVTXControl.h>
+#include <VTXMSPBridge.h>
+
+#define VTX_TX_PIN  16
+#define VTX_RX_PIN  17
+#define MSP_RX_PIN  4
+#define MSP_TX_PIN  5
+
+HardwareSerialTransport vtxPort(&Serial2, VTX_TX_PIN, VTX_RX_PIN);
+BetaVTXControl vtx(VTX_PROTOCOL_SMARTAUDIO);
+VTXMSPBridge msp(&vtx);
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) delay(10);
+  
+  Serial.println("VTX MSP Bridge Example");
+  Serial.println("======================");
+  
+  if (!vtx.begin(&vtxPort)) {
+    Serial.println("Failed to initialize VTX");
+    while (1) delay(100);
+  }
+  
+  if (!msp.begin(&Serial1, MSP_RX_PIN, MSP_TX_PIN)) {
+    Serial.println("Failed to open MSP port");
+    while (1) delay(100);
+  }
+  
+  Serial.println("Bridge running");
+}
+
+void loop() {
+  // Both in the same task: MSP writes go through the VTX setters
+  vtx.update();
+  msp.update();
+}
@@ -0,0 +1,48 @@
+/**
+ * Bus Sniffer Example
+ * 
+ * Listens to the SmartAudio line between a flight controller and its VTX
+ * and logs every request and reply as CSV on the USB serial port. A
+ * summary with the VTX response times is printed every 10 seconds.
+ * 
+ * Hardware Setup:
+ * - ESP32 GPIO 17 (RX) to the VTX control wire, nothing on TX
+ *   (for TRAMP or MSP change the protocol below)
+ * - Common ground with the flight controller
+ */
+
+#include <Arduino.h>
+#include <VTXSniffer.h>
+
+#define SNIFF_RX_PIN        17
+#define SUMMARY_INTERVAL_MS 10000
+
+HardwareSerialTransport sniffPort(&Serial2, -1, SNIFF_RX_PIN);
+VTXSniffer sniffer(VTX_PROTOCOL_SMARTAUDIO);
+unsigned long lastSummary = 0;
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) delay(10);
+  
+  Serial.println("VTX Bus Sniffer Example");
+  Serial.println("=======================");
+  
+  if (!sniffer.begin(&sniffPort)) {
+    Serial.println("Failed to open sniffer port");
+    while (1) delay(100);
+  }
+  
+  Serial.println(sniffer.isEventDriven() ? "Decoding in the UART callback" : "Polling the UART");
+  sniffer.setCapture(&Serial);
+}
+
+void loop() {
+  sniffer.update();
+  
+  if (millis() - lastSummary >= SUMMARY_INTERVAL_MS) {
+    lastSummary = millis();
+    Serial.print("# ");
+    sniffer.printSummary(Serial);
+  }
+}
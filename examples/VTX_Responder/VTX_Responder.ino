@@ -0,0 +1,65 @@
+/**
+ * VTX Responder Example
+ * 
+ * Turns an ESP32 into a stand-in SmartAudio v2.1 VTX for bench tests of
+ * flight controllers or of this library: frequency, power and pit mode
+ * changes are applied and answered like a real device would. Every 5
+ * seconds the current settings and request counters are printed.
+ * 
+ * Hardware Setup:
+ * - ESP32 GPIO 16 (TX) and GPIO 17 (RX) joined through a 1k resistor on TX,
+ *   to the host's SmartAudio wire (for TRAMP or MSP use TrampResponder or
+ *   MSPResponder)
+ * - Common ground with the host
+ */
+
+#include <Arduino.h>
+#include <VTXResponder.h>
+
+#define VTX_TX_PIN          16
+#define VTX_RX_PIN          17
+#define REPORT_INTERVAL_MS  5000
+
+HardwareSerialTransport vtxPort(&Serial2, VTX_TX_PIN, VTX_RX_PIN);
+SmartAudioResponder device;
+unsigned long lastReport = 0;
+
+void setup() {
+  Serial.begin(115200);
+  while (!Serial) delay(10);
+  
+  Serial.println("VTX Responder Example");
+  Serial.println("=====================");
+  
+  // 25, 100, 400 mW
+  const uint8_t powerDbm[] = { 14, 20, 26 };
+  device.setVersion(3);
+  device.setPowerTable(powerDbm, sizeof(powerDbm));
+  device.setTurnaround(5000, 20000);
+  
+  if (!device.begin(&vtxPort)) {
+    Serial.println("Failed to open VTX port");
+    while (1) delay(100);
+  }
+  
+  Serial.println("Waiting for requests");
+}
+
+void loop() {
+  device.update();
+  
+  if (millis() - lastReport >= REPORT_INTERVAL_MS) {
+    lastReport = millis();
+    const VTXResponderStatistics stats = device.getStatistics();
+    Serial.print(device.getFrequency());
+    Serial.print(" MHz, power ");
+    Serial.print(device.getPowerIndex());
+    Serial.print(device.getPitMode() ? ", pit on" : ", pit off");
+    Serial.print(" | requests ");
+    Serial.print(stats.requests);
+    Serial.print(", replies ");
+    Serial.print(stats.replies);
+    Serial.print(", errors ");
+    Serial.println(stats.errors);
+  }
+}
@@ -0,0 +1,309 @@
+/**
+ * await-check - host check of the C++20 awaitable set commands
+ *
+ * Runs coroutines that co_await setFrequencyAsync() against the emulated
+ * SmartAudio, TRAMP and MSP devices of the latency bench, on its simulated
+ * link and virtual clock. It checks that:
+ *
+ *   - a command the device applies resumes with VTX_RESULT_CONFIRMED;
+ *   - a command that is not sent while an older one for the field is still
+ *     pending returns VTX_RESULT_REJECTED without suspending, and the older
+ *     one still completes;
+ *   - a command whose replies are all lost resumes with
+ *     VTX_RESULT_FAILED_DEADLINE once the retry policy's deadline passes;
+ *   - destroying a suspended coroutine takes its waiter off the protocol,
+ *     so update() never resumes a destroyed frame.
+ *
+ * Coroutine frames are overwritten when freed, so a dangling waiter
+ * crashes instead of passing silently.
+ *
+ * Usage:
+ *   await-check
+ *
+ * Exit status 1 if any check fails.
+ */
+
+#include <BetaVTXControl.h>
+
+#include <stdlib.h>
+
+#include <coroutine>
+
+#include "EmulatedVTX.h"
+#include "SimLink.h"
+
+#if !BETAVTX_ENABLE_COROUTINES
+#error "await-check needs C++20 coroutines (-std=gnu++20)"
+#endif
+
+#define CHECK_LOOP_US           1000        // update() period of the host loop
+#define CHECK_DEVICE_TICK_US    100         // update() period of the device
+#define CHECK_WARMUP_US         3000000     // Link bring-up
+#define CHECK_OP_TIMEOUT_US     5000000
+#define CHECK_DEADLINE_MS       300         // Retry deadline of the lost-reply check
+#define CHECK_FREED_BYTE        0xA5
+
+uint64_t vtxHostVirtualUs = 1000000;
+
+static unsigned checks = 0;
+static unsigned failures = 0;
+
+#define CHECK(cond) check((cond), #cond, __LINE__)
+
+static void check(bool ok, const char* what, int line) {
+    checks++;
+    if (!ok) {
+        failures++;
+        fprintf(stderr, "await-check: line %d: %s\n", line, what);
+    }
+}
+
+static const char* resultName(VTXCommandResult result) {
+    switch (result) {
+        case VTX_RESULT_NONE:               return "none";
+        case VTX_RESULT_PENDING:            return "pending";
+        case VTX_RESULT_CONFIRMED:          return "confirmed";
+        case VTX_RESULT_UNCONFIRMED:        return "unconfirmed";
+        case VTX_RESULT_REJECTED:           return "rejected";
+        case VTX_RESULT_FAILED_RETRIES:     return "failed (retries)";
+        case VTX_RESULT_FAILED_DEADLINE:    return "failed (deadline)";
+    }
+    return "?";
+}
+
+/**
+ * @brief Minimal coroutine type: starts at once, keeps its result until destroyed
+ */
+struct Task {
+    struct promise_type {
+        VTXCommandResult result = VTX_RESULT_NONE;
+
+        Task get_return_object() { return Task(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        std::suspend_always final_suspend() noexcept { return {}; }
+        void return_value(VTXCommandResult r) { result = r; }
+        void unhandled_exception() { abort(); }
+
+        // Freed frames are overwritten, so resuming one jumps through garbage
+        static void* operator new(size_t size) {
+            void* frame = malloc(size);
+            if (!frame) {
+                abort();
+            }
+            return frame;
+        }
+        static void operator delete(void* frame, size_t size) {
+            memset(frame, CHECK_FREED_BYTE, size);
+            free(frame);
+        }
+    };
+
+    explicit Task(std::coroutine_handle<promise_type> handle) : _handle(handle) {}
+    Task(Task&& other) noexcept : _handle(other._handle) { other._handle = nullptr; }
+    Task(const Task&) = delete;
+    Task& operator=(const Task&) = delete;
+    ~Task() { destroy(); }
+
+    bool done() const { return !_handle || _handle.done(); }
+    VTXCommandResult result() const { return _handle ? _handle.promise().result : VTX_RESULT_NONE; }
+
+    void destroy() {
+        if (_handle) {
+            _handle.destroy();
+            _handle = nullptr;
+        }
+    }
+
+private:
+    std::coroutine_handle<promise_type> _handle;
+};
+
+static Task retune(BetaVTXControl& vtx, uint16_t freq, bool* resumed = nullptr) {
+    const VTXCommandResult result = co_await vtx.setFrequencyAsync(freq);
+    if (resumed) {
+        *resumed = true;
+    }
+    co_return result;
+}
+
+/**
+ * @brief One engine, its emulated device and the link between them
+ */
+struct Rig {
+    SimWire toVtx;
+    SimWire toHost;
+    SimTransport port;
+    BetaVTXControl control;
+    SmartAudioResponder smartAudioResponder;
+    TrampResponder trampResponder;
+    MSPResponder mspResponder;
+    EmulatedVTX smartAudioDevice;
+    EmulatedVTX trampDevice;
+    EmulatedVTX mspDevice;
+    EmulatedVTX* device = nullptr;
+
+    explicit Rig(VTXProtocolType protocol)
+        : port(&toVtx, &toHost),
+          control(protocol),
+          smartAudioDevice(&smartAudioResponder, &toVtx, &toHost),
+          trampDevice(&trampResponder, &toVtx, &toHost),
+          mspDevice(&mspResponder, &toVtx, &toHost) {
+        switch (protocol) {
+            case VTX_PROTOCOL_SMARTAUDIO:   device = &smartAudioDevice; break;
+            case VTX_PROTOCOL_TRAMP:        device = &trampDevice; break;
+            default:                        device = &mspDevice; break;
+        }
+    }
+};
+
+static void serviceDevice(void* context) {
+    static_cast<Rig*>(context)->device->service();
+}
+
+static void step(Rig& rig) {
+    const uint64_t end = vtxHostVirtualUs + CHECK_LOOP_US;
+    while (vtxHostVirtualUs + CHECK_DEVICE_TICK_US < end) {
+        vtxHostVirtualUs += CHECK_DEVICE_TICK_US;
+        rig.device->service();
+    }
+    vtxHostVirtualUs = end;
+    rig.device->service();
+    rig.control.update();
+}
+
+/**
+ * @brief Run the loop until task is done or the operation times out
+ */
+static bool runUntilDone(Rig& rig, const Task& task) {
+    const uint64_t end = vtxHostVirtualUs + CHECK_OP_TIMEOUT_US;
+    while (!task.done() && vtxHostVirtualUs < end) {
+        step(rig);
+    }
+    return task.done();
+}
+
+static bool setup(Rig& rig) {
+    if (!rig.device->begin()) {
+        return false;
+    }
+    rig.port.setFlushTick(serviceDevice, &rig, CHECK_DEVICE_TICK_US);
+    if (!rig.control.begin(&rig.port)) {
+        return false;
+    }
+
+    const uint64_t end = vtxHostVirtualUs + CHECK_WARMUP_US;
+    while (vtxHostVirtualUs < end) {
+        step(rig);
+    }
+    return rig.control.getProtocol()->getLinkState() == VTX_LINK_UP;
+}
+
+static void checkConfirmed(VTXProtocolType protocol, const char* name) {
+    Rig rig(protocol);
+    if (!setup(rig)) {
+        failures++;
+        fprintf(stderr, "await-check: %s: link did not come up\n", name);
+        return;
+    }
+
+    const uint16_t freq = rig.device->frequency() == 5732 ? 5769 : 5732;
+    Task task = retune(rig.control, freq);
+    CHECK(!task.done());        // Suspended until a reply confirms it
+    CHECK(runUntilDone(rig, task));
+    printf("%-11s confirmed  %s\n", name, resultName(task.result()));
+    CHECK(task.result() == VTX_RESULT_CONFIRMED);
+    CHECK(rig.device->frequency() == freq);
+}
+
+static void checkRejected() {
+    Rig rig(VTX_PROTOCOL_MSP);
+    if (!setup(rig)) {
+        failures++;
+        fprintf(stderr, "await-check: rejected: link did not come up\n");
+        return;
+    }
+
+    // 6200 MHz is refused by the setter while 5732 is still pending
+    Task first = retune(rig.control, 5732);
+    Task second = retune(rig.control, 6200);
+    CHECK(!first.done());
+    CHECK(second.done());
+    printf("%-11s rejected   %s\n", "msp", resultName(second.result()));
+    CHECK(second.result() == VTX_RESULT_REJECTED);
+
+    CHECK(runUntilDone(rig, first));
+    CHECK(first.result() == VTX_RESULT_CONFIRMED);
+    CHECK(rig.device->frequency() == 5732);
+}
+
+static void checkDeadline() {
+    Rig rig(VTX_PROTOCOL_MSP);
+    if (!setup(rig)) {
+        failures++;
+        fprintf(stderr, "await-check: deadline: link did not come up\n");
+        return;
+    }
+
+    const VTXRetryPolicy policy = { CHECK_DEADLINE_MS, 10, 40, 320, 0 };
+    rig.control.getProtocol()->setRetryPolicy(policy);
+    rig.device->dropReplies(255);
+
+    const uint64_t startUs = vtxHostVirtualUs;
+    Task task = retune(rig.control, 5732);
+    CHECK(runUntilDone(rig, task));
+    const uint64_t elapsedMs = (vtxHostVirtualUs - startUs) / 1000;
+    printf("%-11s deadline   %s after %llu ms\n", "msp", resultName(task.result()), (unsigned long long)elapsedMs);
+    CHECK(task.result() == VTX_RESULT_FAILED_DEADLINE);
+    CHECK(elapsedMs + 1 >= CHECK_DEADLINE_MS && elapsedMs < 2 * CHECK_DEADLINE_MS);  // millis() resolution
+}
+
+static void checkDestroyed() {
+    Rig rig(VTX_PROTOCOL_SMARTAUDIO);
+    if (!setup(rig)) {
+        failures++;
+        fprintf(stderr, "await-check: destroyed: link did not come up\n");
+        return;
+    }
+
+    // Two waiters on one command; the first is destroyed while suspended
+    bool destroyedResumed = false;
+    Task destroyed = retune(rig.control, 5732, &destroyedResumed);
+    bool keptResumed = false;
+    Task kept = retune(rig.control, 5732, &keptResumed);
+    CHECK(!destroyed.done() && !kept.done());
+    destroyed.destroy();
+
+    CHECK(runUntilDone(rig, kept));
+    printf("%-11s destroyed  other waiter %s\n", "smartaudio", resultName(kept.result()));
+    CHECK(keptResumed && kept.result() == VTX_RESULT_CONFIRMED);
+    CHECK(!destroyedResumed);
+
+    // And once more, with the only waiter destroyed and the command left to finish
+    Task alone = retune(rig.control, 5769, &destroyedResumed);
+    CHECK(!alone.done());
+    alone.destroy();
+    const uint64_t end = vtxHostVirtualUs + CHECK_OP_TIMEOUT_US;
+    while (rig.control.getProtocol()->getCommandResult(VTX_FIELD_FREQUENCY) == VTX_RESULT_PENDING &&
+           vtxHostVirtualUs < end) {
+        step(rig);
+    }
+    CHECK(rig.control.getProtocol()->getCommandResult(VTX_FIELD_FREQUENCY) == VTX_RESULT_CONFIRMED);
+    CHECK(!destroyedResumed);
+}
+
+int main(int argc, char**) {
+    if (argc != 1) {
+        fprintf(stderr, "usage: await-check\n");
+        return 2;
+    }
+
+    checkConfirmed(VTX_PROTOCOL_SMARTAUDIO, "smartaudio");
+    checkConfirmed(VTX_PROTOCOL_TRAMP, "tramp");
+    checkConfirmed(VTX_PROTOCOL_MSP, "msp");
+    checkRejected();
+    checkDeadline();
+    checkDestroyed();
+
+    printf("%u checks, %u failed\n", checks, failures);
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,69 @@
+#!/usr/bin/env python3
+"""
+Build every footprint configuration and report the library's flash/RAM cost.
+
+Usage:
+    python footprint.py [env ...]
+
+Without arguments all environments from platformio.ini are built. Sizes are
+taken from PlatformIO's own "RAM:"/"Flash:" summary; costs are relative to the
+"baseline" environment (same sketch without the library).
+"""
+
+import configparser
+import os
+import re
+import subprocess
+import sys
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+BASELINE = "baseline"
+FULL = "full"
+SIZE_RE = re.compile(r"^(RAM|Flash):.*\(used (\d+) bytes from (\d+) bytes\)", re.MULTILINE)
+
+
+def list_envs():
+    config = configparser.ConfigParser(interpolation=None)
+    config.read(os.path.join(HERE, "platformio.ini"))
+    return [s.split(":", 1)[1] for s in config.sections() if s.startswith("env:")]
+
+
+def build(env):
+    proc = subprocess.run(["pio", "run", "-e", env], cwd=HERE,
+                          stdout=subprocess.PIPE, stderr=subprocess.STDOUT,
+                          universal_newlines=True)
+    if proc.returncode != 0:
+        sys.stderr.write(proc.stdout)
+        raise SystemExit("footprint: build of '%s' failed" % env)
+
+    sizes = {kind: int(used) for kind, used, _ in SIZE_RE.findall(proc.stdout)}
+    if "RAM" not in sizes or "Flash" not in sizes:
+        raise SystemExit("footprint: no size summary in output of '%s'" % env)
+    return sizes["Flash"], sizes["RAM"]
+
+
+def main():
+    envs = sys.argv[1:] or list_envs()
+    if BASELINE not in envs:
+        envs.insert(0, BASELINE)
+
+    results = {}
+    for env in envs:
+        sys.stderr.write("building %s...\n" % env)
+        results[env] = build(env)
+
+    base_flash, base_ram = results[BASELINE]
+    full = results.get(FULL)
+
+    print("%-24s %10s %8s %12s %10s %14s %12s" % (
+        "ENV", "FLASH", "RAM", "LIB FLASH", "LIB RAM", "vs FULL FLASH", "vs FULL RAM"))
+    for env in envs:
+        flash, ram = results[env]
+        line = "%-24s %10d %8d %12d %10d" % (env, flash, ram, flash - base_flash, ram - base_ram)
+        if full and env not in (BASELINE, FULL):
+            line += " %+14d %+12d" % (flash - full[0], ram - full[1])
+        print(line)
+
+
+if __name__ == "__main__":
+    main()
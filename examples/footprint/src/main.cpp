@@ -0,0 +1,55 @@
+/**
+ * Footprint probe
+ *
+ * The smallest realistic use of the library: begin, one full configuration
+ * and update() in the loop. platformio.ini builds it once per feature
+ * configuration; footprint.py compares every build against "baseline",
+ * which is the same sketch without the library.
+ */
+
+#include <Arduino.h>
+
+#define VTX_TX_PIN  21
+
+#ifndef FOOTPRINT_BASELINE
+#include <BetaVTXControl.h>
+
+// Static instances so the engines show up in the RAM summary; every
+// compiled-in engine is linked, as with BetaVTXControl's runtime choice
+#if BETAVTX_ENABLE_SMARTAUDIO
+SmartAudioVTX smartAudio;
+#endif
+#if BETAVTX_ENABLE_TRAMP
+TrampVTX tramp;
+#endif
+#if BETAVTX_ENABLE_MSP
+MSPVTX msp;
+#endif
+
+VTXProtocol* vtx = nullptr;
+#endif
+
+void setup() {
+    Serial.begin(115200);
+
+#ifndef FOOTPRINT_BASELINE
+#if BETAVTX_ENABLE_SMARTAUDIO
+    vtx = &smartAudio;
+#elif BETAVTX_ENABLE_TRAMP
+    vtx = &tramp;
+#else
+    vtx = &msp;
+#endif
+    vtx->begin(&Serial1, VTX_TX_PIN, &Serial);
+    vtx->setFrequency(5800);
+    vtx->setPower(25);
+    vtx->setPitMode(false);
+#endif
+}
+
+void loop() {
+#ifndef FOOTPRINT_BASELINE
+    vtx->update();
+#endif
+    delay(1);
+}
@@ -0,0 +1,69 @@
+/**
+ * @file EmulatedVTX.h
+ * @brief Power switch around the library's device responders for the latency bench
+ *
+ * The SmartAudio, TRAMP and MSP device models are the library's
+ * VTXResponder classes, running on the device end of a SimLink. This
+ * wrapper adds a power cycle, during which the device ignores the host and
+ * after which it restarts with its default settings.
+ */
+
+#ifndef EMULATEDVTX_H
+#define EMULATEDVTX_H
+
+#include <VTXResponder.h>
+
+#include "SimLink.h"
+
+class EmulatedVTX {
+public:
+    EmulatedVTX(VTXResponder* responder, SimWire* fromHost, SimWire* toHost)
+        : _responder(responder), _fromHost(fromHost), _port(toHost, fromHost) {}
+
+    bool begin() { return _responder->begin(&_port); }
+
+    /**
+     * @brief Decode what has arrived by now and send the replies that are due
+     */
+    void service() {
+        if (_powerOnPending) {
+            // Powered off: whatever arrived meanwhile is lost
+            uint8_t c;
+            while (_fromHost->pop(vtxHostVirtualUs < _offUntilUs ? vtxHostVirtualUs : _offUntilUs, &c)) {
+            }
+            if (vtxHostVirtualUs < _offUntilUs) {
+                return;
+            }
+            _powerOnPending = false;
+            _responder->reset();
+        }
+        _responder->update();
+    }
+
+    void seed(uint32_t seed) { _responder->setSeed(seed); }
+
+    /**
+     * @brief Lose the next count replies (the command itself is still applied)
+     */
+    void dropReplies(uint8_t count) { _responder->dropReplies(count); }
+
+    /**
+     * @brief Ignore the host until upUs, then restart with default settings
+     */
+    void powerCycle(uint64_t upUs) {
+        _offUntilUs = upUs;
+        _powerOnPending = true;
+    }
+
+    uint16_t frequency() const { return _responder->getFrequency(); }
+    bool pitMode() const { return _responder->getPitMode(); }
+
+private:
+    VTXResponder* _responder;
+    SimWire* _fromHost;
+    SimTransport _port;
+    uint64_t _offUntilUs = 0;
+    bool _powerOnPending = false;
+};
+
+#endif // EMULATEDVTX_H
@@ -0,0 +1,176 @@
+/**
+ * @file SimLink.h
+ * @brief Simulated UART link with wire-time modelling on a virtual clock
+ *
+ * Each direction is a SimWire: bytes leave the sender back to back and
+ * arrive one character time (start + 8 data + stop bits at the configured
+ * baud) after the previous one. The host side is a VTXTransport, so the
+ * unmodified protocol engines run on it; the device side is read by the
+ * emulators with per-byte arrival times.
+ */
+
+#ifndef SIMLINK_H
+#define SIMLINK_H
+
+#include <VTXTransport.h>
+
+#ifndef BETAVTX_HOST_VIRTUAL_CLOCK
+#error "SimLink needs the virtual host clock (-DBETAVTX_HOST_VIRTUAL_CLOCK)"
+#endif
+
+#define SIM_WIRE_CAPACITY   512     // Bytes in flight per direction
+
+/**
+ * @brief One direction of a simulated UART line
+ */
+class SimWire {
+public:
+    void configure(uint32_t baud, VTXFraming framing) {
+        const uint32_t bitsPerByte = (framing == VTX_FRAMING_8N2) ? 11 : 10;
+        _byteNs = (uint64_t)bitsPerByte * 1000000000ULL / baud;
+    }
+
+    /**
+     * @brief Queue bytes for transmission, starting no earlier than startUs
+     * @return Bytes accepted
+     */
+    size_t sendAt(const uint8_t* buf, size_t len, uint64_t startUs) {
+        uint64_t t = startUs * 1000ULL;
+        if (t < _freeAtNs) {
+            t = _freeAtNs;
+        }
+
+        size_t n = 0;
+        while (n < len && _count < SIM_WIRE_CAPACITY) {
+            t += _byteNs;
+            Slot& slot = _slots[(_head + _count) % SIM_WIRE_CAPACITY];
+            slot.value = buf[n++];
+            slot.arrivalNs = t;
+            _count++;
+        }
+        if (n > 0) {
+            _freeAtNs = t;
+            _bytes += n;
+        }
+        return n;
+    }
+
+    size_t send(const uint8_t* buf, size_t len) { return sendAt(buf, len, vtxHostVirtualUs); }
+
+    /**
+     * @brief Take the next byte if it has fully arrived by nowUs
+     * @param arrivalUs Set to the time its stop bit ended
+     */
+    bool pop(uint64_t nowUs, uint8_t* value, uint64_t* arrivalUs = nullptr) {
+        if (_count == 0 || _slots[_head].arrivalNs > nowUs * 1000ULL) {
+            return false;
+        }
+        *value = _slots[_head].value;
+        if (arrivalUs) {
+            *arrivalUs = (_slots[_head].arrivalNs + 999) / 1000;
+        }
+        _head = (_head + 1) % SIM_WIRE_CAPACITY;
+        _count--;
+        return true;
+    }
+
+    /**
+     * @return Bytes that have arrived by nowUs and not been read
+     */
+    size_t arrived(uint64_t nowUs) const {
+        size_t n = 0;
+        while (n < _count && _slots[(_head + n) % SIM_WIRE_CAPACITY].arrivalNs <= nowUs * 1000ULL) {
+            n++;
+        }
+        return n;
+    }
+
+    /**
+     * @return Bytes still being shifted out at nowUs
+     */
+    size_t inFlight(uint64_t nowUs) const { return _count - arrived(nowUs); }
+
+    /**
+     * @return Time the last queued byte has fully arrived
+     */
+    uint64_t idleAtUs() const { return (_freeAtNs + 999) / 1000; }
+
+    /**
+     * @return Total bytes sent over this wire
+     */
+    uint32_t bytes() const { return _bytes; }
+
+private:
+    struct Slot {
+        uint8_t value;
+        uint64_t arrivalNs;
+    };
+
+    Slot _slots[SIM_WIRE_CAPACITY];
+    uint16_t _head = 0;
+    uint16_t _count = 0;
+    uint64_t _byteNs = 1000000000ULL / 960;  // 9600 8N1 until configured
+    uint64_t _freeAtNs = 0;
+    uint32_t _bytes = 0;
+};
+
+/**
+ * @brief Host end of a simulated link, used by the protocol engines
+ */
+class SimTransport : public VTXTransport {
+public:
+    SimTransport(SimWire* tx, SimWire* rx) : _tx(tx), _rx(rx) {}
+
+    bool open() override { return true; }
+    void close() override {}
+
+    bool configure(uint32_t baud, VTXFraming framing) override {
+        _tx->configure(baud, framing);
+        _rx->configure(baud, framing);
+        return true;
+    }
+
+    int available() override { return (int)_rx->arrived(vtxHostVirtualUs); }
+
+    size_t read(uint8_t* buf, size_t len) override {
+        size_t n = 0;
+        while (n < len && _rx->pop(vtxHostVirtualUs, &buf[n])) {
+            n++;
+        }
+        return n;
+    }
+
+    size_t write(const uint8_t* buf, size_t len) override { return _tx->send(buf, len); }
+
+    size_t txPending() override { return _tx->inFlight(vtxHostVirtualUs); }
+
+    // Blocking transmit: the caller's clock moves on until the line is idle
+    void flush() override {
+        const uint64_t idleUs = _tx->idleAtUs();
+        while (vtxHostVirtualUs < idleUs) {
+            vtxHostVirtualUs = (_tickUs && vtxHostVirtualUs + _tickUs < idleUs) ? vtxHostVirtualUs + _tickUs : idleUs;
+            if (_tick) {
+                _tick(_tickContext);
+            }
+        }
+    }
+
+    /**
+     * @brief Keep the other end running while flush() blocks
+     * @param tick Called every tickUs of the wait, and once at its end
+     */
+    void setFlushTick(void (*tick)(void*), void* context, uint32_t tickUs) {
+        _tick = tick;
+        _tickContext = context;
+        _tickUs = tickUs;
+    }
+
+private:
+    SimWire* _tx;
+    SimWire* _rx;
+    void (*_tick)(void*) = nullptr;
+    void* _tickContext = nullptr;
+    uint32_t _tickUs = 0;
+};
+
+#endif // SIMLINK_H
@@ -0,0 +1,620 @@
+/**
+ * latency-bench - end-to-end command latency against emulated VTXs
+ *
+ * Runs the library's SmartAudioVTX, TrampVTX and MSPVTX engines against
+ * its SmartAudio, TRAMP and MSP device responders over simulated UART
+ * links (4800 8N2, 9600 8N1 and 115200 8N1 with per-byte wire time) on a
+ * virtual clock. For each scenario it measures
+ * the time from the setter call until the engine reports the command as
+ * confirmed, and the bytes on the wire in both directions meanwhile. The
+ * brownout scenario instead measures from the device powering back up
+ * until the link supervisor has restored the settings, safe-boot from
+ * begin() until pit mode is confirmed, scheduled from the deadline of
+ * a scheduled pit mode change until it is confirmed, and switch from
+ * switchProtocol() back to the protocol until the VTX answers.
+ *
+ * With -r the whole run is also logged by a flight recorder, and the
+ * recorder's cost per event is measured on the host.
+ *
+ * Usage:
+ *   latency-bench [-n iterations] [-l loop_us] [-b budget_us] [-s seed] [-r log_prefix] [-c]
+ */
+
+#include <BetaVTXControl.h>
+#include <StdioRecordSink.h>
+
+#include <unistd.h>
+
+#include <algorithm>
+#include <chrono>
+#include <vector>
+
+#include "EmulatedVTX.h"
+#include "SimLink.h"
+
+#define BENCH_DEFAULT_ITERATIONS    200
+#define BENCH_DEFAULT_LOOP_US       1000        // update() period of the host loop
+#define BENCH_DEVICE_TICK_US        100         // update() period of the device, bounds its turnaround error
+#define BENCH_WARMUP_US             3000000     // Link bring-up and first RTT samples
+#define BENCH_QUIET_US              20000       // Idle line before an isolated operation
+#define BENCH_OP_TIMEOUT_US         5000000
+#define BENCH_BROWNOUT_US           4000000     // Off time, longer than TRAMP link-down detection (3 polls)
+#define BENCH_SAFE_BOOT_FRAME_US    25000       // Pit-on frame must be on the wire within (8 SmartAudio bytes take 18.3 ms)
+#define BENCH_SAFE_BOOT_BOUND_US    250000      // Time-to-pit a safe boot must confirm within
+#define BENCH_SCHEDULE_LEAD_US      300000      // Minimum time from scheduling to the deadline
+#define BENCH_SCHEDULE_ERROR_US     500         // Start time error a scheduled frame must stay within
+#define BENCH_RECORDER_FILE_BYTES   (1024UL * 1024UL)
+#define BENCH_RECORDER_SLOTS        8
+#define BENCH_RECORDER_COST_EVENTS  1000000     // Events timed for the per-event cost
+
+uint64_t vtxHostVirtualUs = 1000000;
+
+enum Scenario {
+    SCENARIO_RETUNE,        // setFrequency() on an idle link
+    SCENARIO_RECONFIG,      // Frequency, power and pit mode back to back
+    SCENARIO_DROPPED_REPLY, // Retune whose first confirmation is lost
+    SCENARIO_POLLING,       // Retune at a random point of the status polling cycle
+    SCENARIO_BROWNOUT,      // Device power-cycles and comes back with default settings
+    SCENARIO_SAFE_BOOT,     // Engine and device power up together, pit mode from begin()
+    SCENARIO_SCHEDULED,     // Pit mode toggled at a deadline, amid status polling
+    SCENARIO_SWITCH,        // Switch to another protocol and VTX, then back
+    SCENARIO_COUNT
+};
+
+static const char* const scenarioNames[SCENARIO_COUNT] = {
+    "retune", "reconfig", "dropped-reply", "polling", "brownout", "safe-boot", "scheduled", "switch"
+};
+
+enum Variant {
+    VARIANT_SMARTAUDIO,
+    VARIANT_TRAMP,
+    VARIANT_TRAMP_CONSERVATIVE,     // One TRAMP parameter per request gap
+    VARIANT_MSP,
+    VARIANT_COUNT
+};
+
+static const char* const variantNames[VARIANT_COUNT] = {
+    "smartaudio", "tramp", "tramp-conservative", "msp"
+};
+
+static uint32_t iterations = BENCH_DEFAULT_ITERATIONS;
+static uint32_t loopUs = BENCH_DEFAULT_LOOP_US;
+static uint32_t budgetUs = 0;       // update(budgetUs) instead of update() if set
+static uint32_t seed = 1;
+static bool csv = false;
+static VTXFlightRecorder* recorder = nullptr;   // -r
+
+static uint32_t rng = 1;
+
+static uint32_t random32() {
+    // xorshift32
+    rng ^= rng << 13;
+    rng ^= rng >> 17;
+    rng ^= rng << 5;
+    return rng;
+}
+
+/**
+ * @brief One engine, its emulated device and the link between them
+ */
+struct Rig {
+    SimWire toVtx;
+    SimWire toHost;
+    SimTransport port;
+    BetaVTXControl control;
+    SmartAudioResponder smartAudioResponder;
+    TrampResponder trampResponder;
+    MSPResponder mspResponder;
+    EmulatedVTX smartAudioDevice;
+    EmulatedVTX trampDevice;
+    EmulatedVTX mspDevice;
+
+    VTXProtocol* vtx;           // control's engine in use
+    EmulatedVTX* device;
+    uint32_t pollPeriodUs;      // Status polling interval of the device profile in use
+    uint8_t droppedReplies;     // Replies answering the first attempt of a retune
+
+    uint8_t finished;           // VTXStateField bits done since the last operation started
+    uint8_t failed;
+    uint64_t finishedUs;
+    uint64_t linkUpUs;          // Last time the link supervisor reported VTX_LINK_UP
+
+    bool pit = false;
+    bool highPower = false;
+
+    Rig()
+        : port(&toVtx, &toHost),
+          control(VTX_PROTOCOL_SMARTAUDIO),
+          smartAudioDevice(&smartAudioResponder, &toVtx, &toHost),
+          trampDevice(&trampResponder, &toVtx, &toHost),
+          mspDevice(&mspResponder, &toVtx, &toHost) {}
+};
+
+struct Result {
+    std::vector<uint32_t> latencyUs;
+    uint32_t failures = 0;
+    uint64_t txBytes = 0;
+    uint64_t rxBytes = 0;
+};
+
+static void onCommand(VTXStateField field, VTXCommandResult result, void* context) {
+    Rig* rig = static_cast<Rig*>(context);
+    if (result == VTX_RESULT_PENDING) {
+        return;
+    }
+    rig->finished |= field;
+    if (result != VTX_RESULT_CONFIRMED) {
+        rig->failed |= field;
+    }
+    rig->finishedUs = vtxHostVirtualUs;
+}
+
+static void onLink(VTXLinkState state, void* context) {
+    Rig* rig = static_cast<Rig*>(context);
+    if (state == VTX_LINK_UP) {
+        rig->linkUpUs = vtxHostVirtualUs;
+    }
+}
+
+static void serviceDevice(void* context) {
+    static_cast<Rig*>(context)->device->service();
+}
+
+static void step(Rig& rig) {
+    const uint64_t end = vtxHostVirtualUs + loopUs;
+    while (vtxHostVirtualUs + BENCH_DEVICE_TICK_US < end) {
+        vtxHostVirtualUs += BENCH_DEVICE_TICK_US;
+        rig.device->service();
+    }
+    vtxHostVirtualUs = end;
+    rig.device->service();
+    if (budgetUs) {
+        rig.control.update(budgetUs);
+    } else {
+        rig.control.update();
+    }
+    if (recorder) {
+        recorder->service();
+    }
+}
+
+static void runFor(Rig& rig, uint64_t us) {
+    const uint64_t end = vtxHostVirtualUs + us;
+    while (vtxHostVirtualUs < end) {
+        step(rig);
+    }
+}
+
+static void waitQuiet(Rig& rig) {
+    for (;;) {
+        const uint64_t idle = std::max(rig.toVtx.idleAtUs(), rig.toHost.idleAtUs());
+        if (vtxHostVirtualUs >= idle + BENCH_QUIET_US) {
+            break;
+        }
+        step(rig);
+    }
+}
+
+static EmulatedVTX* deviceFor(Rig& rig, VTXProtocolType protocol) {
+    switch (protocol) {
+        case VTX_PROTOCOL_SMARTAUDIO:   return &rig.smartAudioDevice;
+        case VTX_PROTOCOL_TRAMP:        return &rig.trampDevice;
+        default:                        return &rig.mspDevice;
+    }
+}
+
+static bool setup(Rig& rig, Variant variant) {
+    VTXProtocolType protocol;
+    if (variant == VARIANT_SMARTAUDIO) {
+        protocol = VTX_PROTOCOL_SMARTAUDIO;
+        rig.droppedReplies = 2;     // SET echo and settings readback
+    } else if (variant == VARIANT_MSP) {
+        protocol = VTX_PROTOCOL_MSP;
+        rig.droppedReplies = 2;     // SET acknowledgement and config readback
+    } else {
+        protocol = VTX_PROTOCOL_TRAMP;
+        rig.droppedReplies = 1;     // Status readback
+    }
+
+    // All devices share the wires; the switch scenario swaps them
+    EmulatedVTX* devices[] = { &rig.smartAudioDevice, &rig.trampDevice, &rig.mspDevice };
+    for (EmulatedVTX* device : devices) {
+        device->seed(seed + 1);
+        if (!device->begin()) {
+            return false;
+        }
+    }
+    rig.device = deviceFor(rig, protocol);
+    rig.port.setFlushTick(serviceDevice, &rig, BENCH_DEVICE_TICK_US);
+
+    rig.control.switchProtocol(protocol);
+    if (!rig.control.begin(&rig.port)) {
+        return false;
+    }
+    rig.vtx = rig.control.getProtocol();
+    if (protocol == VTX_PROTOCOL_TRAMP) {
+        static_cast<TrampVTX*>(rig.vtx)->setPipelinedConfig(variant == VARIANT_TRAMP);
+    }
+    rig.vtx->setCommandCallback(onCommand, &rig);
+    rig.vtx->setLinkCallback(onLink, &rig);
+    runFor(rig, BENCH_WARMUP_US);
+    rig.pollPeriodUs = rig.vtx->getDeviceProfile().pollIntervalMs * 1000UL;
+    return rig.vtx->getFrequency() == rig.device->frequency();
+}
+
+static uint16_t nextFrequency(const Rig& rig) {
+    for (;;) {
+        const uint16_t freq = vtxDefaultFrequencyTable[random32() % 5][random32() % 8];
+        if (freq != rig.device->frequency()) {
+            return freq;
+        }
+    }
+}
+
+/**
+ * @brief Retune, power-cycle the device and time its recovery from power-up
+ */
+static void runBrownout(Rig& rig, Result& result) {
+    waitQuiet(rig);
+    rig.finished = 0;
+    const uint16_t freq = nextFrequency(rig);
+    rig.vtx->setFrequency(freq);
+    while (!(rig.finished & VTX_FIELD_FREQUENCY) && rig.vtx->getLinkState() == VTX_LINK_UP) {
+        step(rig);
+    }
+    waitQuiet(rig);
+
+    const uint64_t upUs = vtxHostVirtualUs + BENCH_BROWNOUT_US + random32() % loopUs;
+    rig.device->powerCycle(upUs);
+    while (vtxHostVirtualUs < upUs) {
+        step(rig);
+    }
+
+    const uint32_t startTx = rig.toVtx.bytes();
+    const uint32_t startRx = rig.toHost.bytes();
+    while (rig.vtx->getLinkState() != VTX_LINK_UP && vtxHostVirtualUs - upUs < BENCH_OP_TIMEOUT_US) {
+        step(rig);
+    }
+
+    if (rig.vtx->getLinkState() != VTX_LINK_UP || rig.device->frequency() != freq) {
+        result.failures++;
+        return;
+    }
+    result.latencyUs.push_back((uint32_t)(rig.linkUpUs - upUs));
+    result.txBytes += rig.toVtx.bytes() - startTx;
+    result.rxBytes += rig.toHost.bytes() - startRx;
+}
+
+/**
+ * @brief Restart engine and device together and time pit mode from begin()
+ */
+static void runSafeBoot(Rig& rig, Result& result) {
+    waitQuiet(rig);
+    vtxHostVirtualUs += random32() % loopUs;
+    rig.device->powerCycle(vtxHostVirtualUs);
+
+    const uint32_t startTx = rig.toVtx.bytes();
+    const uint32_t startRx = rig.toHost.bytes();
+    const uint64_t startUs = vtxHostVirtualUs;
+    rig.vtx->setSafeBoot(true);
+    if (!rig.vtx->begin(&rig.port)) {
+        result.failures++;
+        return;
+    }
+    while (rig.vtx->getSafeBootStatistics().confirmedUs == 0 && vtxHostVirtualUs - startUs < BENCH_OP_TIMEOUT_US) {
+        step(rig);
+    }
+
+    const VTXSafeBootStatistics stats = rig.vtx->getSafeBootStatistics();
+    const uint32_t timeToPitUs = stats.confirmedUs;
+    if (stats.firstFrameUs > BENCH_SAFE_BOOT_FRAME_US ||
+        timeToPitUs == 0 || timeToPitUs > BENCH_SAFE_BOOT_BOUND_US || !rig.device->pitMode()) {
+        result.failures++;
+        return;
+    }
+    result.latencyUs.push_back(timeToPitUs);
+    result.txBytes += rig.toVtx.bytes() - startTx;
+    result.rxBytes += rig.toHost.bytes() - startRx;
+}
+
+/**
+ * @brief Schedule a pit mode toggle and time its confirmation from the deadline
+ */
+static void runScheduled(Rig& rig, Result& result) {
+    runFor(rig, random32() % rig.pollPeriodUs);
+    vtxHostVirtualUs += random32() % loopUs;
+
+    rig.finished = 0;
+    rig.failed = 0;
+    const uint32_t startTx = rig.toVtx.bytes();
+    const uint32_t startRx = rig.toHost.bytes();
+    const uint64_t deadlineUs = vtxHostVirtualUs + BENCH_SCHEDULE_LEAD_US + random32() % BENCH_SCHEDULE_LEAD_US;
+    rig.pit = !rig.pit;
+    if (!rig.vtx->schedulePitMode(rig.pit, (uint32_t)deadlineUs)) {
+        result.failures++;
+        return;
+    }
+    while (!(rig.finished & VTX_FIELD_PIT_MODE) && vtxHostVirtualUs < deadlineUs + BENCH_OP_TIMEOUT_US) {
+        step(rig);
+    }
+
+    const VTXScheduleResult schedule = rig.vtx->getScheduleResult(VTX_FIELD_PIT_MODE);
+    const int32_t errorUs = schedule.startErrorUs < 0 ? -schedule.startErrorUs : schedule.startErrorUs;
+    if (!(rig.finished & VTX_FIELD_PIT_MODE) || rig.failed || !schedule.sent ||
+        errorUs > BENCH_SCHEDULE_ERROR_US || rig.device->pitMode() != rig.pit) {
+        result.failures++;
+        return;
+    }
+    result.latencyUs.push_back((uint32_t)(rig.finishedUs - deadlineUs));
+    result.txBytes += rig.toVtx.bytes() - startTx;
+    result.rxBytes += rig.toHost.bytes() - startRx;
+}
+
+static bool switchTo(Rig& rig, VTXProtocolType protocol) {
+    rig.device = deviceFor(rig, protocol);
+    if (!rig.control.switchProtocol(protocol)) {
+        return false;
+    }
+    rig.vtx = rig.control.getProtocol();
+    return true;
+}
+
+static bool waitSwitchReady(Rig& rig) {
+    const uint64_t startUs = vtxHostVirtualUs;
+    while (rig.control.getSwitchStatistics().lastReadyUs == 0 && vtxHostVirtualUs - startUs < BENCH_OP_TIMEOUT_US) {
+        step(rig);
+    }
+    return rig.control.getSwitchStatistics().lastReadyUs != 0;
+}
+
+/**
+ * @brief Swap to a VTX of another protocol and back, timing the return until the VTX answers
+ */
+static void runSwitch(Rig& rig, Result& result) {
+    const VTXProtocolType home = rig.control.getProtocolType();
+    const VTXProtocolType away = (home == VTX_PROTOCOL_MSP) ? VTX_PROTOCOL_SMARTAUDIO : VTX_PROTOCOL_MSP;
+
+    waitQuiet(rig);
+    if (!switchTo(rig, away) || !waitSwitchReady(rig)) {
+        result.failures++;
+        return;
+    }
+    waitQuiet(rig);
+    vtxHostVirtualUs += random32() % loopUs;
+
+    const uint32_t startTx = rig.toVtx.bytes();
+    const uint32_t startRx = rig.toHost.bytes();
+    if (!switchTo(rig, home)) {
+        result.failures++;
+        return;
+    }
+    // Cached state is kept while the engine is suspended
+    const bool cached = rig.vtx->getFrequency() == rig.device->frequency();
+    if (!waitSwitchReady(rig) || !cached) {
+        result.failures++;
+        return;
+    }
+    result.latencyUs.push_back(rig.control.getSwitchStatistics().lastReadyUs);
+    result.txBytes += rig.toVtx.bytes() - startTx;
+    result.rxBytes += rig.toHost.bytes() - startRx;
+}
+
+static void runOperation(Rig& rig, Scenario scenario, Result& result) {
+    if (scenario == SCENARIO_BROWNOUT) {
+        runBrownout(rig, result);
+        return;
+    }
+    if (scenario == SCENARIO_SAFE_BOOT) {
+        runSafeBoot(rig, result);
+        return;
+    }
+    if (scenario == SCENARIO_SCHEDULED) {
+        runScheduled(rig, result);
+        return;
+    }
+    if (scenario == SCENARIO_SWITCH) {
+        runSwitch(rig, result);
+        return;
+    }
+
+    if (scenario == SCENARIO_POLLING) {
+        runFor(rig, random32() % rig.pollPeriodUs);
+    } else {
+        waitQuiet(rig);
+    }
+    // Land anywhere between two update() calls
+    vtxHostVirtualUs += random32() % loopUs;
+
+    if (scenario == SCENARIO_DROPPED_REPLY) {
+        rig.device->dropReplies(rig.droppedReplies);
+    }
+
+    rig.finished = 0;
+    rig.failed = 0;
+    const uint64_t startUs = vtxHostVirtualUs;
+    const uint32_t startTx = rig.toVtx.bytes();
+    const uint32_t startRx = rig.toHost.bytes();
+
+    uint8_t expected = VTX_FIELD_FREQUENCY;
+    rig.vtx->setFrequency(nextFrequency(rig));
+    if (scenario == SCENARIO_RECONFIG) {
+        rig.highPower = !rig.highPower;
+        rig.pit = !rig.pit;
+        rig.vtx->setPower(rig.highPower ? 200 : 25);
+        rig.vtx->setPitMode(rig.pit);
+        expected |= VTX_FIELD_POWER | VTX_FIELD_PIT_MODE;
+    }
+
+    while ((rig.finished & expected) != expected && vtxHostVirtualUs - startUs < BENCH_OP_TIMEOUT_US) {
+        step(rig);
+    }
+
+    if ((rig.finished & expected) != expected || rig.failed) {
+        result.failures++;
+        rig.device->dropReplies(0);
+        return;
+    }
+    result.latencyUs.push_back((uint32_t)(rig.finishedUs - startUs));
+    result.txBytes += rig.toVtx.bytes() - startTx;
+    result.rxBytes += rig.toHost.bytes() - startRx;
+}
+
+static double percentileMs(const std::vector<uint32_t>& sorted, uint32_t percent) {
+    if (sorted.empty()) {
+        return 0;
+    }
+    // Nearest rank
+    size_t rank = (sorted.size() * percent + 99) / 100;
+    if (rank == 0) {
+        rank = 1;
+    }
+    return sorted[rank - 1] / 1000.0;
+}
+
+static void printHeader() {
+    if (csv) {
+        printf("protocol,scenario,ops,failed,min_ms,p50_ms,p90_ms,p99_ms,max_ms,tx_bytes_per_op,rx_bytes_per_op\n");
+        return;
+    }
+    printf("%-19s %-14s %5s %6s %8s %8s %8s %8s %8s %8s %8s\n",
+           "protocol", "scenario", "ops", "failed",
+           "min ms", "p50 ms", "p90 ms", "p99 ms", "max ms", "tx B/op", "rx B/op");
+}
+
+static void printResult(Variant variant, Scenario scenario, Result& result) {
+    std::vector<uint32_t>& sorted = result.latencyUs;
+    std::sort(sorted.begin(), sorted.end());
+
+    const size_t ops = sorted.size();
+    const double tx = ops ? (double)result.txBytes / ops : 0;
+    const double rx = ops ? (double)result.rxBytes / ops : 0;
+    const double minMs = ops ? sorted.front() / 1000.0 : 0;
+    const double maxMs = ops ? sorted.back() / 1000.0 : 0;
+
+    printf(csv ? "%s,%s,%zu,%u,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f,%.1f\n"
+               : "%-19s %-14s %5zu %6u %8.1f %8.1f %8.1f %8.1f %8.1f %8.1f %8.1f\n",
+           variantNames[variant], scenarioNames[scenario], ops, result.failures,
+           minMs, percentileMs(sorted, 50), percentileMs(sorted, 90), percentileMs(sorted, 99), maxMs,
+           tx, rx);
+}
+
+/**
+ * @brief Sink that takes every block and keeps nothing
+ */
+class DiscardSink : public VTXRecordSink {
+public:
+    uint8_t slots() const override { return 1; }
+    size_t readSlot(uint8_t, uint8_t*, size_t) override { return 0; }
+    bool openSlot(uint8_t) override { return true; }
+    bool write(const uint8_t*, size_t) override { return true; }
+    void close() override {}
+};
+
+/**
+ * @return Host wall time of recording one frame event, including the block writes, in ns
+ */
+static double recorderCostNs() {
+    static VTXFlightRecorder costRecorder;
+    DiscardSink sink;
+    costRecorder.begin(&sink);
+
+    const uint8_t frame[] = { 0xAA, 0x55, 0x09, 0x02, 0x16, 0x64, 0x7E, 0x00 };
+    const auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < BENCH_RECORDER_COST_EVENTS; i++) {
+        costRecorder.recordFrame(VTX_REC_TX, VTX_DEVICE_SMARTAUDIO, 0, frame, sizeof(frame), i);
+        costRecorder.service();
+    }
+    const auto end = std::chrono::steady_clock::now();
+    costRecorder.end();
+
+    return std::chrono::duration<double, std::nano>(end - start).count() / BENCH_RECORDER_COST_EVENTS;
+}
+
+static void usage() {
+    fprintf(stderr, "usage: latency-bench [-n iterations] [-l loop_us] [-b budget_us] [-s seed] [-r log_prefix] [-c]\n");
+}
+
+int main(int argc, char** argv) {
+    const char* logPrefix = nullptr;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:l:b:s:r:ch")) != -1) {
+        switch (opt) {
+            case 'n': iterations = strtoul(optarg, nullptr, 10); break;
+            case 'l': loopUs = strtoul(optarg, nullptr, 10); break;
+            case 'b': budgetUs = strtoul(optarg, nullptr, 10); break;
+            case 's': seed = strtoul(optarg, nullptr, 10); break;
+            case 'r': logPrefix = optarg; break;
+            case 'c': csv = true; break;
+            default:
+                usage();
+                return 2;
+        }
+    }
+    if (optind != argc || iterations == 0 || loopUs == 0) {
+        usage();
+        return 2;
+    }
+
+    static StdioRecordSink sink(logPrefix ? logPrefix : "", BENCH_RECORDER_SLOTS);
+    static VTXFlightRecorder runRecorder(BENCH_RECORDER_FILE_BYTES);
+    if (logPrefix) {
+        if (!runRecorder.begin(&sink)) {
+            fprintf(stderr, "latency-bench: cannot write %s\n", logPrefix);
+            return 1;
+        }
+        recorder = &runRecorder;
+    }
+
+    printHeader();
+
+    bool ok = true;
+    for (uint8_t v = 0; v < VARIANT_COUNT; v++) {
+        const Variant variant = (Variant)v;
+
+        for (uint8_t s = 0; s < SCENARIO_COUNT; s++) {
+            const Scenario scenario = (Scenario)s;
+
+            // Fresh engine and device per scenario, same random sequence for every variant
+            Rig* rig = new Rig();
+            rng = seed ? seed : 1;
+            if (recorder) {
+                rig->control.setRecorder(recorder);
+                recorder->mark(variant, scenario);
+            }
+
+            if (!setup(*rig, variant)) {
+                fprintf(stderr, "latency-bench: %s did not come up\n", variantNames[variant]);
+                delete rig;
+                return 1;
+            }
+
+            Result result;
+            for (uint32_t i = 0; i < iterations; i++) {
+                runOperation(*rig, scenario, result);
+            }
+            printResult(variant, scenario, result);
+            ok = ok && result.failures == 0;
+
+            const VTXUpdateStatistics stats = rig->vtx->getUpdateStatistics();
+            if (stats.overruns > 0) {
+                fprintf(stderr, "latency-bench: %s %s: update(%u) overran %u times, worst %u us\n",
+                        variantNames[variant], scenarioNames[scenario], (unsigned)budgetUs,
+                        (unsigned)stats.overruns, (unsigned)stats.maxUs);
+                ok = false;
+            }
+
+            delete rig;
+        }
+    }
+
+    if (recorder) {
+        recorder->end();
+        const VTXRecorderStatistics stats = recorder->getStatistics();
+        fprintf(stderr, "latency-bench: recorded %u events in %u files, %u dropped, %u write errors, %.0f ns per event\n",
+                (unsigned)stats.records, (unsigned)stats.files, (unsigned)stats.dropped,
+                (unsigned)stats.writeErrors, recorderCostNs());
+        ok = ok && stats.dropped == 0 && stats.writeErrors == 0;
+    }
+
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,236 @@
+/**
+ * recorder-decode - print flight recorder logs written by VTXFlightRecorder
+ *
+ * Takes the slot files of one log in any order (e.g. vtxlog*.bin copied
+ * off LittleFS), sorts them by file sequence and prints one line per
+ * record: time since the start of its session, engine, event and details.
+ * Gaps in the record sequence (records dropped on the device) are
+ * reported where they happened.
+ *
+ * Usage:
+ *   recorder-decode [-c] vtxlog0.bin vtxlog1.bin ...
+ */
+
+#include <VTXRecorder.h>
+#include <VTXDeviceProfile.h>
+#include <VTXRetry.h>
+#include <VTXState.h>
+
+#include <algorithm>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+struct LogFile {
+    std::string path;
+    VTXRecordFileHeader header;
+    std::vector<VTXRecord> records;
+};
+
+static bool csv = false;
+
+static const char* sourceName(uint8_t source) {
+    switch (source) {
+        case VTX_DEVICE_SMARTAUDIO: return "SA";
+        case VTX_DEVICE_TRAMP:      return "TRAMP";
+        case VTX_DEVICE_MSP:        return "MSP";
+        default:                    return "-";
+    }
+}
+
+static const char* typeName(uint8_t type) {
+    switch (type) {
+        case VTX_REC_TX:        return "TX";
+        case VTX_REC_RX:        return "RX";
+        case VTX_REC_TIMEOUT:   return "TIMEOUT";
+        case VTX_REC_COMMAND:   return "COMMAND";
+        case VTX_REC_RETRY:     return "RETRY";
+        case VTX_REC_LINK:      return "LINK";
+        case VTX_REC_PHASE:     return "PHASE";
+        case VTX_REC_MARK:      return "MARK";
+        default:                return "?";
+    }
+}
+
+static const char* fieldName(uint8_t field) {
+    switch (field) {
+        case VTX_FIELD_FREQUENCY:   return "frequency";
+        case VTX_FIELD_POWER:       return "power";
+        case VTX_FIELD_PIT_MODE:    return "pit";
+        default:                    return "?";
+    }
+}
+
+static const char* resultName(uint16_t result) {
+    static const char* const names[] = {
+        "none", "pending", "confirmed", "unconfirmed", "rejected", "failed-retries", "failed-deadline"
+    };
+    return result < sizeof(names) / sizeof(names[0]) ? names[result] : "?";
+}
+
+static const char* linkName(uint16_t state) {
+    static const char* const names[] = { "unknown", "up", "down", "restoring" };
+    return state < sizeof(names) / sizeof(names[0]) ? names[state] : "?";
+}
+
+// Mirrors SmartAudioVTX::InitPhase and TrampVTX::Status
+static const char* phaseName(uint8_t source, uint16_t phase) {
+    static const char* const smartAudio[] = { "start", "wait-settings", "wait-pitfreq", "done" };
+    static const char* const tramp[] = { "offline", "init", "monitor", "monitor-temp", "config" };
+    if (source == VTX_DEVICE_SMARTAUDIO && phase < sizeof(smartAudio) / sizeof(smartAudio[0])) {
+        return smartAudio[phase];
+    }
+    if (source == VTX_DEVICE_TRAMP && phase < sizeof(tramp) / sizeof(tramp[0])) {
+        return tramp[phase];
+    }
+    return "?";
+}
+
+static bool load(const char* path, LogFile& file) {
+    FILE* in = fopen(path, "rb");
+    if (!in) {
+        fprintf(stderr, "recorder-decode: cannot open %s\n", path);
+        return false;
+    }
+    file.path = path;
+    bool ok = fread(&file.header, sizeof(file.header), 1, in) == 1 &&
+              file.header.magic == VTX_RECORD_MAGIC &&
+              file.header.version == VTX_RECORD_VERSION &&
+              file.header.recordSize == VTX_RECORD_SIZE;
+    if (!ok) {
+        fprintf(stderr, "recorder-decode: %s is not a VTX flight recorder log\n", path);
+        fclose(in);
+        return false;
+    }
+
+    // A trailing partial record is what a power loss mid-write leaves behind
+    VTXRecord record;
+    while (fread(&record, sizeof(record), 1, in) == 1) {
+        file.records.push_back(record);
+    }
+    fclose(in);
+    return true;
+}
+
+static void printDetails(const VTXRecord& r) {
+    char text[96] = "";
+    switch (r.type) {
+        case VTX_REC_TX:
+            snprintf(text, sizeof(text), "%s", r.code ? "scheduled" : "");
+            break;
+        case VTX_REC_RX:
+            snprintf(text, sizeof(text), r.code == 1 ? "ok" : "error %u", (unsigned)r.code);
+            break;
+        case VTX_REC_COMMAND:
+            snprintf(text, sizeof(text), "%s %s", fieldName(r.code), resultName(r.value));
+            break;
+        case VTX_REC_RETRY:
+            snprintf(text, sizeof(text), "%s attempt %u", fieldName(r.code), (unsigned)r.value + 1);
+            break;
+        case VTX_REC_LINK:
+            snprintf(text, sizeof(text), "%s -> %s", linkName(r.value), linkName(r.code));
+            break;
+        case VTX_REC_PHASE:
+            snprintf(text, sizeof(text), "%s -> %s", phaseName(r.source, r.value), phaseName(r.source, r.code));
+            break;
+        case VTX_REC_MARK:
+            snprintf(text, sizeof(text), "%u %u", (unsigned)r.code, (unsigned)r.value);
+            break;
+        default:
+            break;
+    }
+    printf(csv ? ",%s," : "  %-24s", text);
+
+    const uint8_t kept = r.size < VTX_RECORD_DATA_MAX ? r.size : VTX_RECORD_DATA_MAX;
+    for (uint8_t i = 0; i < kept; i++) {
+        printf(i ? " %02X" : "%02X", r.data[i]);
+    }
+    if (r.size > kept) {
+        printf(" ... (%u bytes)", (unsigned)r.size);
+    }
+    printf("\n");
+}
+
+static void usage() {
+    fprintf(stderr, "usage: recorder-decode [-c] log.bin ...\n");
+}
+
+int main(int argc, char** argv) {
+    int opt;
+    while ((opt = getopt(argc, argv, "c")) != -1) {
+        switch (opt) {
+            case 'c': csv = true; break;
+            default: usage(); return 2;
+        }
+    }
+    if (optind >= argc) {
+        usage();
+        return 2;
+    }
+
+    std::vector<LogFile> files;
+    for (int i = optind; i < argc; i++) {
+        LogFile file;
+        if (load(argv[i], file)) {
+            files.push_back(file);
+        }
+    }
+    std::sort(files.begin(), files.end(), [](const LogFile& a, const LogFile& b) {
+        return (int32_t)(a.header.sequence - b.header.sequence) < 0;
+    });
+
+    if (csv) {
+        printf("session,file,seq,time_us,source,event,details,data\n");
+    }
+
+    bool first = true;
+    uint16_t session = 0;
+    uint16_t nextSeq = 0;
+    uint32_t lastUs = 0;
+    uint64_t sessionUs = 0;     // micros() unwrapped, from the first record of the session
+    uint32_t dropped = 0;
+
+    for (const LogFile& file : files) {
+        if (first || file.header.session != session) {
+            session = file.header.session;
+            first = true;
+            if (!csv) {
+                printf("== session %u (file %u, %s)\n", (unsigned)session,
+                       (unsigned)file.header.sequence, file.path.c_str());
+            }
+        } else if (!csv) {
+            printf("-- file %u (%s)\n", (unsigned)file.header.sequence, file.path.c_str());
+        }
+
+        for (const VTXRecord& r : file.records) {
+            if (first) {
+                sessionUs = 0;
+                first = false;
+            } else {
+                sessionUs += (uint32_t)(r.timeUs - lastUs);
+                if (r.seq != nextSeq) {
+                    const uint16_t gap = (uint16_t)(r.seq - nextSeq);
+                    dropped += gap;
+                    if (!csv) {
+                        printf("   (%u records dropped)\n", (unsigned)gap);
+                    }
+                }
+            }
+            lastUs = r.timeUs;
+            nextSeq = r.seq + 1;
+
+            if (csv) {
+                printf("%u,%u,%u,%llu,%s,%s", (unsigned)session, (unsigned)file.header.sequence,
+                       (unsigned)r.seq, (unsigned long long)sessionUs, sourceName(r.source), typeName(r.type));
+            } else {
+                printf("%12.3f ms  %-5s %-8s", sessionUs / 1000.0, sourceName(r.source), typeName(r.type));
+            }
+            printDetails(r);
+        }
+    }
+
+    if (dropped) {
+        fprintf(stderr, "recorder-decode: %u records dropped on the device\n", (unsigned)dropped);
+    }
+    return files.empty() ? 1 : 0;
+}
@@ -0,0 +1,151 @@
+/**
+ * seqlock-stress - host stress test of the VTXState seqlock
+ *
+ * One writer thread publishes snapshots through VTXSeqlock<VTXState>, as
+ * update() does, while one reader thread copies them like getState() on
+ * the other core. Every field of a snapshot is derived from the same
+ * counter, so the reader can tell a torn copy (fields from two writes)
+ * from a consistent one. It also checks that versions never go backwards.
+ *
+ * Usage:
+ *   seqlock-stress [-n writes]
+ *
+ * Exit status 1 on a torn read or a version going backwards.
+ */
+
+#include <VTXSeqlock.h>
+#include <VTXState.h>
+
+#include <unistd.h>
+
+#include <atomic>
+#include <chrono>
+#include <thread>
+
+#define STRESS_DEFAULT_WRITES   20000000UL
+#define STRESS_TIMED_READS      10000000UL  // Uncontended reads timed at the end
+
+static VTXSeqlock<VTXState> published;
+static std::atomic<bool> writing{true};
+
+static VTXState snapshot(uint32_t i) {
+    VTXState state;
+    state.frequency = (uint16_t)i;
+    state.power = (uint16_t)~i;
+    state.actualPower = (uint16_t)(i * 3);
+    state.temperature = (int16_t)(i ^ 0x5A5A);
+    state.powerIndex = (uint8_t)(i >> 3);
+    state.pitMode = (i & 1) != 0;
+    state.valid = true;
+    return state;
+}
+
+static bool consistent(const VTXState& state) {
+    // All zero before the first write
+    if (!state.valid) {
+        return state.frequency == 0 && state.power == 0 && state.actualPower == 0 &&
+               state.temperature == 0 && state.powerIndex == 0 && !state.pitMode;
+    }
+    const VTXState expected = snapshot(state.frequency);
+    return state.power == expected.power && state.actualPower == expected.actualPower &&
+           state.temperature == expected.temperature && state.powerIndex == expected.powerIndex &&
+           state.pitMode == expected.pitMode;
+}
+
+struct ReaderResult {
+    uint64_t reads;
+    uint64_t changes;       // Reads that saw a newer snapshot than the one before
+    uint64_t torn;
+    uint64_t backwards;
+};
+
+static void reader(ReaderResult* result) {
+    uint32_t lastVersion = 0;
+    uint16_t lastFrequency = 0;
+    
+    while (writing.load(std::memory_order_relaxed)) {
+        const uint32_t version = published.version();
+        const VTXState state = published.read();
+        result->reads++;
+        
+        if (!consistent(state)) {
+            result->torn++;
+            if (result->torn <= 5) {
+                fprintf(stderr, "seqlock-stress: torn read: freq %u power %u actual %u temp %d index %u pit %u\n",
+                        (unsigned)state.frequency, (unsigned)state.power, (unsigned)state.actualPower,
+                        (int)state.temperature, (unsigned)state.powerIndex, (unsigned)state.pitMode);
+            }
+        }
+        if ((int32_t)(version - lastVersion) < 0) {
+            result->backwards++;
+        }
+        if (state.frequency != lastFrequency) {
+            result->changes++;
+        }
+        lastVersion = version;
+        lastFrequency = state.frequency;
+    }
+}
+
+static void usage() {
+    fprintf(stderr, "usage: seqlock-stress [-n writes]\n");
+}
+
+int main(int argc, char** argv) {
+    unsigned long writes = STRESS_DEFAULT_WRITES;
+    int opt;
+    while ((opt = getopt(argc, argv, "n:h")) != -1) {
+        switch (opt) {
+            case 'n': writes = strtoul(optarg, nullptr, 10); break;
+            default:
+                usage();
+                return 2;
+        }
+    }
+    if (optind != argc || writes == 0) {
+        usage();
+        return 2;
+    }
+    
+    ReaderResult result = {};
+    std::thread readerThread(reader, &result);
+    
+    for (uint32_t i = 1; i <= writes; i++) {
+        published.write(snapshot(i));
+        
+        // Lets the reader in on a single core as well; it then lands
+        // between or inside writes wherever the scheduler preempts
+        if ((i & 0x3FF) == 0) {
+            std::this_thread::yield();
+        }
+    }
+    writing.store(false, std::memory_order_relaxed);
+    readerThread.join();
+    
+    // Uncontended cost of getState()
+    const auto readStart = std::chrono::steady_clock::now();
+    uint32_t sink = 0;
+    for (uint32_t i = 0; i < STRESS_TIMED_READS; i++) {
+        sink += published.read().frequency;
+    }
+    const auto readEnd = std::chrono::steady_clock::now();
+    
+    const double readNs = std::chrono::duration<double, std::nano>(readEnd - readStart).count() / STRESS_TIMED_READS;
+    printf("writes     %lu\n", writes);
+    printf("reads      %llu, %llu saw a new snapshot\n",
+           (unsigned long long)result.reads, (unsigned long long)result.changes);
+    printf("torn       %llu\n", (unsigned long long)result.torn);
+    printf("backwards  %llu\n", (unsigned long long)result.backwards);
+    printf("read       %.1f ns uncontended (%u)\n", readNs, (unsigned)(sink & 1));
+    
+    const VTXState last = published.read();
+    if (!consistent(last) || last.frequency != (uint16_t)writes) {
+        fprintf(stderr, "seqlock-stress: last snapshot is not the last write\n");
+        return 1;
+    }
+    if (result.changes == 0) {
+        fprintf(stderr, "seqlock-stress: reader never overlapped the writer, nothing was tested\n");
+        return 1;
+    }
+    return (result.torn == 0 && result.backwards == 0) ? 0 : 1;
+}
@@ -12,7 +12,7 @@
  *   8 - Pit Mode ON
  *   9 - Pit Mode OFF
  *   s - Switch protocol (SmartAudio/TRAMP)
- *   d - Toggle debug mode
+ *   d - Toggle debug mode (restarts the VTX engine)
  *   h - Show help
  * 
  * Hardware:
@@ -26,7 +26,7 @@
 #define VTX_TX_PIN 16
 
 // Start with SmartAudio
-BetaVTXControl* vtx = nullptr;
+BetaVTXControl vtx(VTX_PROTOCOL_SMARTAUDIO);
 VTXProtocolType currentProtocol = VTX_PROTOCOL_SMARTAUDIO;
 bool debugEnabled = false;
 
@@ -56,16 +56,11 @@ void printHelp() {
 }
 
 void initVTX() {
-  if (vtx) {
-    delete vtx;
-  }
-  
-  vtx = new BetaVTXControl(currentProtocol);
-  
   // Pass debug serial if debug enabled
   HardwareSerial* debugSerial = debugEnabled ? &Serial : nullptr;
   
-  if (vtx->begin(&Serial2, VTX_TX_PIN, debugSerial)) {
+  vtx.switchProtocol(currentProtocol);
+  if (vtx.begin(&Serial2, VTX_TX_PIN, debugSerial)) {
     Serial.print("VTX initialized (");
     Serial.print(currentProtocol == VTX_PROTOCOL_SMARTAUDIO ? "SmartAudio" : "TRAMP");
     if (debugEnabled) {
@@ -95,63 +90,63 @@ void loop() {
     switch (cmd) {
       case '1':
         Serial.println("Setting Raceband CH1 (5658 MHz)...");
-        vtx->setFrequency(5658);
+        vtx.setFrequency(5658);
         delay(300);
         Serial.println("Done");
         break;
         
       case '2':
         Serial.println("Setting Raceband CH3 (5732 MHz)...");
-        vtx->setFrequency(5732);
+        vtx.setFrequency(5732);
         delay(300);
         Serial.println("Done");
         break;
         
       case '3':
         Serial.println("Setting FatShark CH1 (5740 MHz)...");
-        vtx->setFrequency(5740);
+        vtx.setFrequency(5740);
         delay(300);
         Serial.println("Done");
         break;
         
       case '4':
         Serial.println("Setting Power 25mW...");
-        vtx->setPower(25);
+        vtx.setPower(25);
         delay(300);
         Serial.println("Done");
         break;
         
       case '5':
         Serial.println("Setting Power 200mW...");
-        vtx->setPower(200);
+        vtx.setPower(200);
         delay(300);
         Serial.println("Done");
         break;
         
       case '6':
         Serial.println("Setting Power 400mW...");
-        vtx->setPower(400);
+        vtx.setPower(400);
         delay(300);
         Serial.println("Done");
         break;
         
       case '7':
         Serial.println("Setting Power 800mW...");
-        vtx->setPower(800);
+        vtx.setPower(800);
         delay(300);
         Serial.println("Done");
         break;
         
       case '8':
         Serial.println("Enabling Pit Mode...");
-        vtx->setPitMode(true);
+        vtx.setPitMode(true);
         delay(300);
         Serial.println("Done");
         break;
         
       case '9':
         Serial.println("Disabling Pit Mode...");
-        vtx->setPitMode(false);
+        vtx.setPitMode(false);
         delay(300);
         Serial.println("Done");
         break;
@@ -163,15 +158,17 @@ void loop() {
                           : VTX_PROTOCOL_SMARTAUDIO;
         Serial.print("Switching to ");
         Serial.println(currentProtocol == VTX_PROTOCOL_SMARTAUDIO ? "SmartAudio" : "TRAMP");
-        initVTX();
+        if (!vtx.switchProtocol(currentProtocol)) {
+          Serial.println("Switch failed!");
+        }
         break;
         
       case 'd':
       case 'D':
         debugEnabled = !debugEnabled;
         Serial.print("Debug mode: ");
-        Serial.println(debugEnabled ? "ON (reinitialize VTX to apply)" : "OFF");
-        Serial.println("Press 's' to reinitialize with new debug setting");
+        Serial.println(debugEnabled ? "ON" : "OFF");
+        initVTX();
         break;
         
       case 'h':
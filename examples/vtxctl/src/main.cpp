@@ -0,0 +1,362 @@
+/**
+ * vtxctl - batch VTX provisioning for Linux benches
+ *
+ * Reads a job file (port, protocol, freq, power, pit), drives every port
+ * concurrently from one poll() loop using the library's SmartAudio/TRAMP
+ * engines, verifies each result by readback where RX is wired, and prints
+ * per-device timing plus a throughput summary. Each command goes out once
+ * the previous one is confirmed or has failed; ports that never answer
+ * (wired TX-only) get a fixed gap between commands instead.
+ *
+ * Usage:
+ *   vtxctl [-g gap_ms] [-t verify_timeout_ms] [-v] jobs.txt
+ *
+ * Job file (one device per line, '#' starts a comment):
+ *   /dev/ttyUSB0   smartaudio   5732   200   off
+ *   /dev/ttyUSB1   tramp        5806   25    on
+ */
+
+#include <BetaVTXControl.h>
+#include <PosixSerialTransport.h>
+
+#include <poll.h>
+#include <strings.h>
+#include <unistd.h>
+
+#define VTXCTL_MAX_JOBS         32
+#define VTXCTL_DEFAULT_GAP_MS   300     // Spacing between commands to a VTX that doesn't answer
+#define VTXCTL_DEFAULT_TIMEOUT_MS 3000  // Readback wait after the last command
+#define VTXCTL_POLL_MS          5
+
+enum JobPhase {
+    PHASE_OPEN,
+    PHASE_SET_FREQ,
+    PHASE_SET_POWER,
+    PHASE_SET_PIT,
+    PHASE_VERIFY,
+    PHASE_DONE
+};
+
+enum JobResult {
+    RESULT_PENDING,
+    RESULT_VERIFIED,
+    RESULT_UNVERIFIED,  // Commands sent, no readback available
+    RESULT_MISMATCH,
+    RESULT_OPEN_FAILED
+};
+
+struct Job {
+    char port[VTX_POSIX_PATH_MAX];
+    VTXProtocolType protocol;
+    uint16_t freq;
+    uint16_t power;
+    bool pit;
+
+    PosixSerialTransport transport;
+    SmartAudioVTX smartAudio;
+    TrampVTX tramp;
+    VTXProtocol* vtx;
+
+    JobPhase phase;
+    JobResult result;
+    unsigned long phaseStartMs;
+    unsigned long startMs;
+    unsigned long sentMs;
+    unsigned long doneMs;
+};
+
+static Job jobs[VTXCTL_MAX_JOBS];
+static uint8_t jobCount = 0;
+
+static unsigned long gapMs = VTXCTL_DEFAULT_GAP_MS;
+static unsigned long verifyTimeoutMs = VTXCTL_DEFAULT_TIMEOUT_MS;
+static bool verbose = false;
+static StdioPrint debugOut(stderr);
+
+static const char* resultName(JobResult result) {
+    switch (result) {
+        case RESULT_VERIFIED:    return "OK";
+        case RESULT_UNVERIFIED:  return "SENT (no readback)";
+        case RESULT_MISMATCH:    return "MISMATCH";
+        case RESULT_OPEN_FAILED: return "OPEN FAILED";
+        default:                 return "PENDING";
+    }
+}
+
+static bool loadJobs(const char* path) {
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        fprintf(stderr, "vtxctl: cannot open %s\n", path);
+        return false;
+    }
+
+    char line[160];
+    unsigned lineNo = 0;
+    while (fgets(line, sizeof(line), f)) {
+        lineNo++;
+
+        char* hash = strchr(line, '#');
+        if (hash) {
+            *hash = '\0';
+        }
+
+        // Scanned at line width so an over-long port is caught below, not cut short
+        char port[sizeof(line)];
+        char protocol[16];
+        char pit[8];
+        unsigned freq;
+        unsigned power;
+        const int fields = sscanf(line, "%159s %15s %u %u %7s", port, protocol, &freq, &power, pit);
+        if (fields <= 0) {
+            continue;
+        }
+        if (fields != 5) {
+            fprintf(stderr, "vtxctl: %s:%u: expected 'port protocol freq power pit'\n", path, lineNo);
+            fclose(f);
+            return false;
+        }
+        if (jobCount >= VTXCTL_MAX_JOBS) {
+            fprintf(stderr, "vtxctl: more than %d jobs\n", VTXCTL_MAX_JOBS);
+            fclose(f);
+            return false;
+        }
+
+        const size_t portLen = strlen(port);
+        if (portLen >= sizeof(jobs[0].port)) {
+            fprintf(stderr, "vtxctl: %s:%u: port path longer than %u characters\n",
+                    path, lineNo, (unsigned)(sizeof(jobs[0].port) - 1));
+            fclose(f);
+            return false;
+        }
+
+        Job& job = jobs[jobCount];
+        memcpy(job.port, port, portLen + 1);
+
+        if (strcasecmp(protocol, "smartaudio") == 0 || strcasecmp(protocol, "sa") == 0) {
+            job.protocol = VTX_PROTOCOL_SMARTAUDIO;
+        } else if (strcasecmp(protocol, "tramp") == 0) {
+            job.protocol = VTX_PROTOCOL_TRAMP;
+        } else {
+            fprintf(stderr, "vtxctl: %s:%u: unknown protocol '%s'\n", path, lineNo, protocol);
+            fclose(f);
+            return false;
+        }
+
+        job.freq = (uint16_t)freq;
+        job.power = (uint16_t)power;
+        job.pit = (strcasecmp(pit, "on") == 0 || strcmp(pit, "1") == 0);
+        job.phase = PHASE_OPEN;
+        job.result = RESULT_PENDING;
+        jobCount++;
+    }
+
+    fclose(f);
+    return jobCount > 0;
+}
+
+static bool readbackMatches(Job& job) {
+    const VTXState state = job.vtx->getState();
+    if (!state.valid || state.frequency != job.freq || state.pitMode != job.pit) {
+        return false;
+    }
+
+    if (job.protocol == VTX_PROTOCOL_SMARTAUDIO) {
+        return state.powerIndex == job.smartAudio.powerMwToIndex(job.power);
+    }
+    return state.power == job.power;
+}
+
+static void enterPhase(Job& job, JobPhase phase, unsigned long now) {
+    job.phase = phase;
+    job.phaseStartMs = now;
+
+    switch (phase) {
+        case PHASE_SET_FREQ:
+            job.vtx->setFrequency(job.freq);
+            break;
+        case PHASE_SET_POWER:
+            job.vtx->setPower(job.power);
+            break;
+        case PHASE_SET_PIT:
+            job.vtx->setPitMode(job.pit);
+            break;
+        case PHASE_VERIFY:
+            job.sentMs = now;
+            break;
+        case PHASE_DONE:
+            job.doneMs = now;
+            break;
+        default:
+            break;
+    }
+}
+
+static VTXStateField phaseField(JobPhase phase) {
+    switch (phase) {
+        case PHASE_SET_FREQ:    return VTX_FIELD_FREQUENCY;
+        case PHASE_SET_POWER:   return VTX_FIELD_POWER;
+        default:                return VTX_FIELD_PIT_MODE;
+    }
+}
+
+/**
+ * @return true once the command of a set phase has been confirmed, has failed,
+ *         or (nothing to confirm on a silent port) the gap has passed
+ */
+static bool commandDone(Job& job, unsigned long now) {
+    const VTXCommandResult result = job.vtx->getCommandResult(phaseField(job.phase));
+    const bool gapElapsed = now - job.phaseStartMs >= gapMs;
+
+    if (result == VTX_RESULT_PENDING) {
+        // No readback from the port yet: it may be TX-only, where the retries
+        // would only run into their deadline
+        return !job.vtx->getState().valid && gapElapsed;
+    }
+    if (result == VTX_RESULT_UNCONFIRMED) {
+        return gapElapsed;
+    }
+    // Confirmed, or failed: the readback in PHASE_VERIFY reports the mismatch
+    return true;
+}
+
+static void stepJob(Job& job, unsigned long now) {
+    switch (job.phase) {
+        case PHASE_OPEN:
+            job.startMs = now;
+            job.transport.setPath(job.port);
+            job.vtx = (job.protocol == VTX_PROTOCOL_SMARTAUDIO)
+                      ? static_cast<VTXProtocol*>(&job.smartAudio)
+                      : static_cast<VTXProtocol*>(&job.tramp);
+            job.vtx->setBlockingTx(false);
+            if (!job.vtx->begin(&job.transport, verbose ? &debugOut : nullptr)) {
+                job.result = RESULT_OPEN_FAILED;
+                enterPhase(job, PHASE_DONE, now);
+                return;
+            }
+            enterPhase(job, PHASE_SET_FREQ, now);
+            return;
+
+        case PHASE_DONE:
+            return;
+
+        default:
+            break;
+    }
+
+    job.vtx->update();
+
+    if (job.phase == PHASE_VERIFY) {
+        if (readbackMatches(job)) {
+            job.result = RESULT_VERIFIED;
+            enterPhase(job, PHASE_DONE, now);
+        } else if (now - job.phaseStartMs >= verifyTimeoutMs) {
+            job.result = job.vtx->getState().valid ? RESULT_MISMATCH : RESULT_UNVERIFIED;
+            enterPhase(job, PHASE_DONE, now);
+        }
+        return;
+    }
+
+    if (commandDone(job, now)) {
+        enterPhase(job, (JobPhase)(job.phase + 1), now);
+    }
+}
+
+static void runJobs() {
+    struct pollfd fds[VTXCTL_MAX_JOBS];
+
+    for (;;) {
+        const unsigned long now = millis();
+        bool allDone = true;
+        nfds_t nfds = 0;
+
+        for (uint8_t i = 0; i < jobCount; i++) {
+            stepJob(jobs[i], now);
+            if (jobs[i].phase != PHASE_DONE) {
+                allDone = false;
+                fds[nfds].fd = jobs[i].transport.fd();
+                fds[nfds].events = POLLIN;
+                fds[nfds].revents = 0;
+                nfds++;
+            }
+        }
+
+        if (allDone) {
+            return;
+        }
+
+        // Wake on any reply, or after the poll interval to run timers
+        poll(fds, nfds, VTXCTL_POLL_MS);
+    }
+}
+
+static void printReport(unsigned long elapsedMs) {
+    printf("\n%-20s %-10s %6s %6s %4s  %-20s %9s %9s\n",
+           "PORT", "PROTOCOL", "FREQ", "POWER", "PIT", "RESULT", "SENT ms", "DONE ms");
+
+    unsigned verified = 0;
+    unsigned failed = 0;
+    for (uint8_t i = 0; i < jobCount; i++) {
+        const Job& job = jobs[i];
+        const bool sent = job.result != RESULT_OPEN_FAILED;
+
+        printf("%-20s %-10s %6u %6u %4s  %-20s ",
+               job.port, job.protocol == VTX_PROTOCOL_SMARTAUDIO ? "smartaudio" : "tramp",
+               job.freq, job.power, job.pit ? "on" : "off", resultName(job.result));
+        if (sent) {
+            printf("%9lu %9lu\n", job.sentMs - job.startMs, job.doneMs - job.startMs);
+        } else {
+            printf("%9s %9s\n", "-", "-");
+        }
+
+        if (job.result == RESULT_VERIFIED) {
+            verified++;
+        } else if (job.result == RESULT_MISMATCH || job.result == RESULT_OPEN_FAILED) {
+            failed++;
+        }
+    }
+
+    printf("\n%u device(s) in %lu ms: %u verified, %u unverified, %u failed",
+           jobCount, elapsedMs, verified, jobCount - verified - failed, failed);
+    if (elapsedMs > 0) {
+        printf(" (%.1f devices/min)", jobCount * 60000.0 / elapsedMs);
+    }
+    printf("\n");
+}
+
+static void usage() {
+    fprintf(stderr, "usage: vtxctl [-g gap_ms] [-t verify_timeout_ms] [-v] jobs.txt\n");
+}
+
+int main(int argc, char** argv) {
+    int opt;
+    while ((opt = getopt(argc, argv, "g:t:vh")) != -1) {
+        switch (opt) {
+            case 'g': gapMs = strtoul(optarg, nullptr, 10); break;
+            case 't': verifyTimeoutMs = strtoul(optarg, nullptr, 10); break;
+            case 'v': verbose = true; break;
+            default:
+                usage();
+                return 2;
+        }
+    }
+
+    if (optind != argc - 1) {
+        usage();
+        return 2;
+    }
+
+    if (!loadJobs(argv[optind])) {
+        return 2;
+    }
+
+    const unsigned long start = millis();
+    runJobs();
+    printReport(millis() - start);
+
+    for (uint8_t i = 0; i < jobCount; i++) {
+        if (jobs[i].result == RESULT_MISMATCH || jobs[i].result == RESULT_OPEN_FAILED) {
+            return 1;
+        }
+    }
+    return 0;
+}
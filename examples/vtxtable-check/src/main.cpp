@@ -0,0 +1,238 @@
+/**
+ * vtxtable-check - host check of the vtxtable parser
+ *
+ * Feeds VTXTable a Betaflight `diff all` dump, through parse() and through
+ * loadFile(), then malformed blocks that must be refused with the right
+ * errorLine(): a band with the wrong number of channels, a line longer
+ * than VTX_TABLE_MAX_LINE and a `band` line before `bands`. It also checks
+ * the reverse lookups on frequencies used by two bands and on power labels
+ * such as `1W` and `MAX`.
+ *
+ * Usage:
+ *   vtxtable-check
+ *
+ * Exit status 1 if any check fails.
+ */
+
+#include <VTXTable.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <string>
+
+#define CHECK(cond) check((cond), #cond, __LINE__)
+
+static unsigned checks = 0;
+static unsigned failures = 0;
+
+static void check(bool ok, const char* what, int line) {
+    checks++;
+    if (!ok) {
+        failures++;
+        fprintf(stderr, "vtxtable-check: line %d: %s\n", line, what);
+    }
+}
+
+// Abridged `diff all` from a Betaflight 4.4 board with a SmartAudio VTX
+static const char* DIFF_ALL =
+    "# diff all\n"
+    "\n"
+    "# version\n"
+    "# Betaflight / STM32F7X2 (S7X2) 4.4.2 Jun  9 2023 / 01:45:58 (4c3ecc0) MSP API: 1.45\n"
+    "# config rev: 9b1a7f3\n"
+    "\n"
+    "# start the command batch\n"
+    "batch start\n"
+    "\n"
+    "# reset configuration to default settings\n"
+    "defaults nosave\n"
+    "\n"
+    "board_name MAMBAF722_2022A\n"
+    "manufacturer_id DIAT\n"
+    "mcu_id 003a00283131510a33383937\n"
+    "signature \n"
+    "\n"
+    "# feature\n"
+    "feature -RX_PARALLEL_PWM\n"
+    "feature TELEMETRY\n"
+    "\n"
+    "# serial\n"
+    "serial 20 1 115200 57600 0 115200\n"
+    "serial 2 2048 115200 57600 0 115200\r\n"     // One CRLF line, as saved by some terminals
+    "\n"
+    "# vtxtable\n"
+    "vtxtable bands 6\n"
+    "vtxtable channels 8\n"
+    "vtxtable band 1 BOSCAM_A A FACTORY 5865 5845 5825 5805 5785 5765 5745 5725\n"
+    "vtxtable band 2 BOSCAM_B B FACTORY 5733 5752 5771 5790 5809 5828 5847 5866\n"
+    "vtxtable band 3 BOSCAM_E E FACTORY 5705 5685 5665    0 5885 5905    0    0\n"
+    "vtxtable band 4 FATSHARK F FACTORY 5740 5760 5780 5800 5820 5840 5860 5880\n"
+    "vtxtable band 5 RACEBAND R FACTORY 5658 5695 5732 5769 5806 5843 5880 5917\n"
+    "vtxtable band 6 LOWRACE L CUSTOM 5362 5399 5436 5473 5510 5547 5584 5621\n"
+    "vtxtable powerlevels 5\n"
+    "vtxtable powervalues 0 1 2 3 4\n"
+    "vtxtable powerlabels 25 200 500 1W MAX\n"
+    "\n"
+    "# master\n"
+    "set vtx_band = 5\n"
+    "set vtx_channel = 1\n"
+    "set vtx_power = 2\n"
+    "set vtx_freq = 5658\n"
+    "\n"
+    "batch end\n";
+
+static void checkDump(const VTXTable& table) {
+    CHECK(table.isValid());
+    CHECK(table.errorLine() == 0);
+    CHECK(table.bandCount() == 6);
+    CHECK(table.channelCount() == 8);
+    CHECK(table.powerLevelCount() == 5);
+
+    CHECK(std::string(table.bandName(1)) == "BOSCAM_A");
+    CHECK(table.bandLetter(5) == 'R');
+    CHECK(table.frequency(5, 1) == 5658);
+    CHECK(table.frequency(6, 8) == 5621);
+    CHECK(table.frequency(3, 4) == 0);
+    CHECK(table.frequency(7, 1) == 0);
+    CHECK(table.frequency(1, 0) == 0);
+
+    // FACTORY and CUSTOM tokens, any case
+    CHECK(table.isFactoryBand(1));
+    CHECK(table.isFactoryBand(5));
+    CHECK(!table.isFactoryBand(6));
+
+    // 5880 is FATSHARK 8 and RACEBAND 7: first band/channel wins
+    uint8_t band = 0;
+    uint8_t channel = 0;
+    CHECK(table.findFrequency(5880, &band, &channel) && band == 4 && channel == 8);
+    CHECK(table.findFrequency(5732, &band, &channel) && band == 5 && channel == 3);
+    CHECK(table.findFrequency(5362, &band, &channel) && band == 6 && channel == 1);
+    CHECK(!table.findFrequency(5881, &band, &channel));
+    CHECK(!table.findFrequency(0, &band, &channel));   // Unused BOSCAM_E slots
+
+    // Every used slot maps back to a slot with the same frequency
+    for (uint8_t b = 1; b <= table.bandCount(); b++) {
+        for (uint8_t ch = 1; ch <= table.channelCount(); ch++) {
+            const uint16_t freq = table.frequency(b, ch);
+            if (freq) {
+                CHECK(table.findFrequency(freq, &band, &channel) && table.frequency(band, channel) == freq);
+            }
+        }
+    }
+
+    // Labels: "1W" is 1000 mW, "MAX" has no mW value
+    CHECK(table.powerMw(1) == 25);
+    CHECK(table.powerMw(4) == 1000);
+    CHECK(table.powerMw(5) == 0);
+    CHECK(std::string(table.powerLabel(5)) == "MAX");
+    CHECK(table.findPowerLevel(25) == 1);
+    CHECK(table.findPowerLevel(350) == 2);      // Tie between 200 and 500: lower one
+    CHECK(table.findPowerLevel(800) == 4);
+    CHECK(table.findPowerLevel(5000) == 4);     // MAX is never picked by mW
+    CHECK(table.findPowerValue(4) == 5);
+    CHECK(table.findPowerValue(9) == 0);
+    CHECK(table.powerValue(5) == 4);
+}
+
+static bool writeFile(const char* path, const std::string& text) {
+    FILE* f = fopen(path, "w");
+    if (!f) {
+        return false;
+    }
+    const bool ok = fwrite(text.data(), 1, text.size(), f) == text.size();
+    return fclose(f) == 0 && ok;
+}
+
+// Refused with errorLine() == line, both from memory and from a file
+static void checkRefused(const char* what, const std::string& text, uint16_t line, const char* path) {
+    VTXTable table;
+    const bool parsed = table.parse(text.c_str());
+    if (parsed || table.errorLine() != line || table.isValid()) {
+        failures++;
+        fprintf(stderr, "vtxtable-check: %s: parse() %s, error line %u, expected %u\n",
+                what, parsed ? "accepted it" : "refused it", table.errorLine(), line);
+    }
+    checks++;
+
+    VTXTable fromFile;
+    const bool loaded = writeFile(path, text) && fromFile.loadFile(path);
+    if (loaded || fromFile.errorLine() != line || fromFile.isValid()) {
+        failures++;
+        fprintf(stderr, "vtxtable-check: %s: loadFile() %s, error line %u, expected %u\n",
+                what, loaded ? "accepted it" : "refused it", fromFile.errorLine(), line);
+    }
+    checks++;
+}
+
+int main(int argc, char**) {
+    if (argc != 1) {
+        fprintf(stderr, "usage: vtxtable-check\n");
+        return 2;
+    }
+
+    char path[] = "/tmp/vtxtable-check-XXXXXX";
+    const int fd = mkstemp(path);
+    if (fd < 0) {
+        fprintf(stderr, "vtxtable-check: cannot create a temporary file\n");
+        return 2;
+    }
+    close(fd);
+
+    static VTXTable table;
+    CHECK(table.parse(DIFF_ALL));
+    checkDump(table);
+
+    static VTXTable fromFile;
+    CHECK(writeFile(path, DIFF_ALL) && fromFile.loadFile(path));
+    checkDump(fromFile);
+
+    // A valid table, then a failed parse: nothing of the old one is left
+    CHECK(!table.parse("vtxtable bands 9\n"));
+    CHECK(!table.isValid() && table.bandCount() == 0 && table.frequency(5, 1) == 0);
+
+    const std::string head =
+        "vtxtable bands 1\n"
+        "vtxtable channels 8\n";
+    const std::string tail =
+        "vtxtable powerlevels 1\n"
+        "vtxtable powervalues 14\n"
+        "vtxtable powerlabels 25\n";
+
+    checkRefused("7 channels of 8",
+                 head + "vtxtable band 1 RACEBAND R FACTORY 5658 5695 5732 5769 5806 5843 5880\n" + tail,
+                 3, path);
+    checkRefused("9 channels of 8",
+                 head + "vtxtable band 1 RACEBAND R 5658 5695 5732 5769 5806 5843 5880 5917 5954\n" + tail,
+                 3, path);
+    checkRefused("band before bands",
+                 "vtxtable channels 8\n"
+                 "vtxtable band 1 RACEBAND R FACTORY 5658 5695 5732 5769 5806 5843 5880 5917\n"
+                 "vtxtable bands 1\n" + tail,
+                 2, path);
+    checkRefused("band above bands",
+                 head + "vtxtable band 2 RACEBAND R FACTORY 5658 5695 5732 5769 5806 5843 5880 5917\n" + tail,
+                 3, path);
+    checkRefused("powerlabels short of powerlevels",
+                 head + "vtxtable band 1 RACEBAND R FACTORY 5658 5695 5732 5769 5806 5843 5880 5917\n"
+                 "vtxtable powerlevels 2\n"
+                 "vtxtable powerlabels 25\n",
+                 5, path);
+
+    // The longest line that fits, then one character more, even in a comment
+    const std::string fits = "# " + std::string(VTX_TABLE_MAX_LINE - 3, 'x') + "\n";
+    const std::string tooLong = "# " + std::string(VTX_TABLE_MAX_LINE - 2, 'x') + "\n";
+    const std::string body =
+        "vtxtable band 1 RACEBAND R FACTORY 5658 5695 5732 5769 5806 5843 5880 5917\n" + tail;
+
+    VTXTable longest;
+    CHECK(longest.parse((head + fits + body).c_str()) && longest.isValid());
+    CHECK(writeFile(path, head + fits + body) && longest.loadFile(path) && longest.isValid());
+    checkRefused("over-long line", head + tooLong + body, 3, path);
+
+    unlink(path);
+
+    printf("%u checks, %u failed\n", checks, failures);
+    return failures == 0 ? 0 : 1;
+}
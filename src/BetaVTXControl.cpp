@@ -1,6 +1,6 @@
 /**
  * @file BetaVTXControl.cpp
- * @brief Main class implementation (TX-only mode, no auto-detection)
+ * @brief Main class implementation: protocol engines and runtime protocol switching
  */
 
 #include "BetaVTXControl.h"
@@ -10,28 +10,117 @@ BetaVTXControl::BetaVTXControl(VTXProtocolType protocolType) {
     _vtx = nullptr;
 }
 
-BetaVTXControl::~BetaVTXControl() {
-    if (_vtx) {
-        delete _vtx;
-        _vtx = nullptr;
+VTXProtocol* BetaVTXControl::engine(VTXProtocolType protocolType) {
+    // Protocols compiled out by VTXConfig.h make begin() and switchProtocol() fail
+    switch (protocolType) {
+#if BETAVTX_ENABLE_SMARTAUDIO
+        case VTX_PROTOCOL_SMARTAUDIO:   return &_smartAudio;
+#endif
+#if BETAVTX_ENABLE_TRAMP
+        case VTX_PROTOCOL_TRAMP:        return &_tramp;
+#endif
+#if BETAVTX_ENABLE_MSP
+        case VTX_PROTOCOL_MSP:          return &_msp;
+#endif
+        default:                        return nullptr;
     }
 }
 
-bool BetaVTXControl::begin(HardwareSerial* serial, uint8_t txPin, HardwareSerial* debugSerial) {
+#ifdef ARDUINO
+bool BetaVTXControl::begin(HardwareSerial* serial, uint8_t txPin, Print* debugSerial) {
     if (!serial) {
         return false;
     }
     
-    if (_protocolType == VTX_PROTOCOL_SMARTAUDIO) {
-        _vtx = new SmartAudioVTX();
-    } else if (_protocolType == VTX_PROTOCOL_TRAMP) {
-        _vtx = new TrampVTX();
+    _serialTransport.attach(serial, txPin);
+    return begin(&_serialTransport, debugSerial);
+}
+#endif
+
+bool BetaVTXControl::begin(VTXTransport* transport, Print* debugSerial) {
+    if (!transport) {
+        return false;
+    }
+    
+    VTXProtocol* next = engine(_protocolType);
+    if (!next) {
+        return false;
+    }
+    if (_vtx && _vtx != next) {
+        _vtx->suspend();
+    }
+    
+    // Other engines start over on this transport when switched to
+    _vtx = next;
+    _transport = transport;
+    _debugSerial = debugSerial;
+    _startedMask = 0;
+    _switchPending = false;
+    
+    _vtx->setSafeBoot(_safeBoot);
+    if (!_vtx->begin(transport, debugSerial)) {
+        return false;
+    }
+    _startedMask = 1 << _protocolType;
+    return true;
+}
+
+bool BetaVTXControl::switchProtocol(VTXProtocolType protocolType) {
+    VTXProtocol* next = engine(protocolType);
+    if (!next) {
+        return false;
+    }
+    if (!_vtx) {
+        _protocolType = protocolType;
+        return true;
+    }
+    if (next == _vtx) {
+        return true;
+    }
+    
+    const uint32_t startUs = micros();
+    _vtx->suspend();
+    
+    bool ok;
+    if (_startedMask & (1 << protocolType)) {
+        ok = next->resume();
+    } else {
+        next->setSafeBoot(false);
+        ok = next->begin(_transport, _debugSerial);
+    }
+    if (!ok) {
+        // Stay with the engine we had
+        _vtx->resume();
+        return false;
+    }
+    
+    _startedMask |= 1 << protocolType;
+    _vtx = next;
+    _protocolType = protocolType;
+    
+    _switchStats.switches++;
+    _switchStats.lastReadyUs = 0;
+    _switchStartUs = startUs;
+    _switchPending = true;
+    checkSwitchReady();
+    return true;
+}
+
+void BetaVTXControl::checkSwitchReady() {
+    if (!_switchPending) {
+        return;
+    }
+    
+    // TX-only links are ready once the port is reconfigured
+    if (BETAVTX_ENABLE_RX && _transport->hasRx() && _vtx->getLinkState() != VTX_LINK_UP) {
+        return;
     }
     
-    if (_vtx) {
-        return _vtx->begin(serial, txPin, debugSerial);
+    _switchPending = false;
+    _switchStats.lastReadyUs = micros() - _switchStartUs;
+    if (_switchStats.lastReadyUs > _switchStats.maxReadyUs) {
+        _switchStats.maxReadyUs = _switchStats.lastReadyUs;
     }
-    return false;
 }
 
 void BetaVTXControl::update() {
@@ -40,6 +129,16 @@ void BetaVTXControl::update() {
     }
     
     _vtx->update();
+    checkSwitchReady();
+}
+
+void BetaVTXControl::update(uint32_t budgetUs) {
+    if (!_vtx) {
+        return;
+    }
+    
+    _vtx->update(budgetUs);
+    checkSwitchReady();
 }
 
 bool BetaVTXControl::isReady() {
@@ -57,3 +156,83 @@ bool BetaVTXControl::setPower(uint16_t power) {
 bool BetaVTXControl::setPitMode(bool enable) {
     return _vtx ? _vtx->setPitMode(enable) : false;
 }
+
+VTXState BetaVTXControl::getState() {
+    if (!_vtx) {
+        VTXState empty = {};
+        return empty;
+    }
+    return _vtx->getState();
+}
+
+uint16_t BetaVTXControl::getFrequency() {
+    return _vtx ? _vtx->getFrequency() : 0;
+}
+
+uint16_t BetaVTXControl::getPower() {
+    return _vtx ? _vtx->getPower() : 0;
+}
+
+bool BetaVTXControl::getPitMode() {
+    return _vtx ? _vtx->getPitMode() : false;
+}
+
+int16_t BetaVTXControl::getTemperature() {
+    return _vtx ? _vtx->getTemperature() : 0;
+}
+
+bool BetaVTXControl::addStateListener(VTXStateCallback callback, void* context, uint8_t fieldMask) {
+    if (!callback) {
+        return false;
+    }
+    
+    // On every engine, like setRecorder(), so it carries over protocol switches.
+    // Check for room first: a rollback by (callback, context) would also drop
+    // registrations made before this call.
+    for (uint8_t type = VTX_PROTOCOL_SMARTAUDIO; type <= VTX_PROTOCOL_MSP; type++) {
+        VTXProtocol* vtx = engine((VTXProtocolType)type);
+        if (vtx && !vtx->hasFreeListenerSlot()) {
+            return false;
+        }
+    }
+    for (uint8_t type = VTX_PROTOCOL_SMARTAUDIO; type <= VTX_PROTOCOL_MSP; type++) {
+        VTXProtocol* vtx = engine((VTXProtocolType)type);
+        if (vtx) {
+            vtx->addStateListener(callback, context, fieldMask);
+        }
+    }
+    return true;
+}
+
+void BetaVTXControl::removeStateListener(VTXStateCallback callback, void* context) {
+    for (uint8_t type = VTX_PROTOCOL_SMARTAUDIO; type <= VTX_PROTOCOL_MSP; type++) {
+        VTXProtocol* vtx = engine((VTXProtocolType)type);
+        if (vtx) {
+            vtx->removeStateListener(callback, context);
+        }
+    }
+}
+
+bool BetaVTXControl::setTelemetry(VTXTelemetryHistory* history) {
+    for (uint8_t type = VTX_PROTOCOL_SMARTAUDIO; type <= VTX_PROTOCOL_MSP; type++) {
+        VTXProtocol* vtx = engine((VTXProtocolType)type);
+        if (vtx) {
+            vtx->setTelemetry(history);
+        }
+    }
+    return true;
+}
+
+#if BETAVTX_ENABLE_RECORDER
+void BetaVTXControl::setRecorder(VTXFlightRecorder* recorder) {
+#if BETAVTX_ENABLE_SMARTAUDIO
+    _smartAudio.setRecorder(recorder);
+#endif
+#if BETAVTX_ENABLE_TRAMP
+    _tramp.setRecorder(recorder);
+#endif
+#if BETAVTX_ENABLE_MSP
+    _msp.setRecorder(recorder);
+#endif
+}
+#endif
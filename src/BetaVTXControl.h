@@ -2,7 +2,7 @@
  * @file BetaVTXControl.h
  * @brief Main header file for BetaVTXControl library
  * 
- * ESP32 Arduino library for controlling VTX modules via SmartAudio and TRAMP protocols
+ * ESP32 Arduino library for controlling VTX modules via SmartAudio, TRAMP and MSP protocols
  * Based on Betaflight implementation
  * 
  * @author BetaVTXControl Contributors
@@ -15,22 +15,36 @@
 #include "VTXProtocol.h"
 #include "SmartAudio.h"
 #include "TRAMP.h"
+#include "MSPVTX.h"
 
 #define BETAVTXCONTROL_VERSION "1.0.0"
 
 enum VTXProtocolType {
     VTX_PROTOCOL_SMARTAUDIO,
-    VTX_PROTOCOL_TRAMP
+    VTX_PROTOCOL_TRAMP,
+    VTX_PROTOCOL_MSP
+};
+
+/**
+ * @brief Protocol switches and their switch-to-ready time
+ *
+ * Ready is the first reply from the VTX under the new protocol, or the
+ * end of switchProtocol() on TX-only links.
+ */
+struct VTXSwitchStatistics {
+    uint16_t switches;
+    uint32_t lastReadyUs;       // 0 while the last switch is not ready yet
+    uint32_t maxReadyUs;
 };
 
 class BetaVTXControl {
 public:
     /**
-     * @param protocolType Protocol to use (VTX_PROTOCOL_SMARTAUDIO or VTX_PROTOCOL_TRAMP)
+     * @param protocolType Protocol to use (VTX_PROTOCOL_SMARTAUDIO, VTX_PROTOCOL_TRAMP or VTX_PROTOCOL_MSP)
      */
     BetaVTXControl(VTXProtocolType protocolType);
-    ~BetaVTXControl();
     
+#ifdef ARDUINO
     /**
      * @brief Initialize VTX communication (TX-only mode)
      * @param serial Pointer to HardwareSerial port
@@ -38,9 +52,48 @@ public:
      * @param debugSerial Optional debug serial port for raw command output (default: nullptr)
      * @return true if initialization successful
      */
-    bool begin(HardwareSerial* serial, uint8_t txPin, HardwareSerial* debugSerial = nullptr);
+    bool begin(HardwareSerial* serial, uint8_t txPin, Print* debugSerial = nullptr);
+#endif
+    
+    /**
+     * @brief Initialize VTX communication over any transport
+     * @param transport Byte transport (ESP-IDF UART, POSIX tty, ...)
+     * @param debugSerial Optional debug output for raw command dumps (default: nullptr)
+     * @return true if initialization successful
+     */
+    bool begin(VTXTransport* transport, Print* debugSerial = nullptr);
+    
+    /**
+     * @brief Hand the port to another protocol engine
+     *
+     * Every engine is a member of this object, so there is no allocation
+     * and each keeps its cached state, statistics, listeners and telemetry
+     * between switches. The current engine is suspended, the port only
+     * gets new line settings (4800 8N2, 9600 8N1 or 115200 8N1), and the
+     * new engine resumes: it probes the VTX again without forgetting what it
+     * knew. An engine used for the first time starts with begin(), without
+     * safe boot. Before begin() this only picks the protocol begin() uses.
+     *
+     * @return false if the protocol is compiled out or the port could not be reconfigured
+     */
+    bool switchProtocol(VTXProtocolType protocolType);
+    
+    VTXSwitchStatistics getSwitchStatistics() const { return _switchStats; }
+    
+    /**
+     * @brief Put the VTX into pit mode from begin(), see VTXProtocol::setSafeBoot()
+     *
+     * Call before begin().
+     */
+    void setSafeBoot(bool enable) { _safeBoot = enable; }
     
     void update();
+    
+    /**
+     * @brief update() bounded to budgetUs, see VTXProtocol::update(uint32_t)
+     */
+    void update(uint32_t budgetUs);
+    
     bool isReady();
     
     /**
@@ -58,6 +111,73 @@ public:
      */
     bool setPitMode(bool enable);
     
+#if BETAVTX_ENABLE_COROUTINES
+    /**
+     * @brief Awaitable setters, see VTXAwait.h
+     *
+     * Without a protocol engine they finish at once as VTX_RESULT_REJECTED.
+     */
+    VTXCommandAwaitable setFrequencyAsync(uint16_t freq) {
+        return _vtx ? _vtx->setFrequencyAsync(freq) : VTXCommandAwaitable(nullptr, VTX_FIELD_FREQUENCY, false);
+    }
+    VTXCommandAwaitable setPowerAsync(uint16_t power) {
+        return _vtx ? _vtx->setPowerAsync(power) : VTXCommandAwaitable(nullptr, VTX_FIELD_POWER, false);
+    }
+    VTXCommandAwaitable setPitModeAsync(bool enable) {
+        return _vtx ? _vtx->setPitModeAsync(enable) : VTXCommandAwaitable(nullptr, VTX_FIELD_PIT_MODE, false);
+    }
+#endif
+    
+    /**
+     * @return Snapshot of the last state reported by the VTX
+     */
+    VTXState getState();
+    
+    uint16_t getFrequency();
+    uint16_t getPower();
+    bool getPitMode();
+    int16_t getTemperature();
+    
+    /**
+     * @brief Register a callback fired from update() when a state field changes
+     *
+     * Registered with every protocol engine, so it works before begin() and
+     * carries over protocol switches.
+     *
+     * @param callback Function to call
+     * @param context User pointer passed back to the callback
+     * @param fieldMask Combination of VTXStateField bits to listen to
+     * @return false, with nothing registered, if any engine is out of listener slots
+     */
+    bool addStateListener(VTXStateCallback callback, void* context = nullptr,
+                          uint8_t fieldMask = VTX_FIELD_ALL);
+    
+    void removeStateListener(VTXStateCallback callback, void* context = nullptr);
+    
+    /**
+     * @brief Attach a telemetry history to the link, nullptr detaches it
+     *
+     * Attached to every protocol engine like the listeners, so one history
+     * continues across protocol switches.
+     *
+     * @return true
+     */
+    bool setTelemetry(VTXTelemetryHistory* history);
+    
+#if BETAVTX_ENABLE_RECORDER
+    /**
+     * @brief Log the traffic of every protocol engine to one flight recorder
+     *
+     * Works before begin() and carries over protocol switches. nullptr stops logging.
+     */
+    void setRecorder(VTXFlightRecorder* recorder);
+#endif
+    
+    /**
+     * @return Underlying protocol engine, nullptr before begin()
+     */
+    VTXProtocol* getProtocol() { return _vtx; }
+    
     /**
      * @return Protocol type
      */
@@ -68,6 +188,31 @@ public:
 private:
     VTXProtocolType _protocolType;
     VTXProtocol* _vtx = nullptr;
+    bool _safeBoot = false;
+    
+#if BETAVTX_ENABLE_SMARTAUDIO
+    SmartAudioVTX _smartAudio;
+#endif
+#if BETAVTX_ENABLE_TRAMP
+    TrampVTX _tramp;
+#endif
+#if BETAVTX_ENABLE_MSP
+    MSPVTX _msp;
+#endif
+    
+#ifdef ARDUINO
+    HardwareSerialTransport _serialTransport;
+#endif
+    VTXTransport* _transport = nullptr;
+    Print* _debugSerial = nullptr;
+    uint8_t _startedMask = 0;           // Engines begun on _transport, by 1 << VTXProtocolType
+    
+    VTXSwitchStatistics _switchStats = {};
+    uint32_t _switchStartUs = 0;
+    bool _switchPending = false;
+    
+    VTXProtocol* engine(VTXProtocolType protocolType);
+    void checkSwitchReady();
 };
 
 #endif
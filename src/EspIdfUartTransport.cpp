@@ -0,0 +1,187 @@
+/**
+ * @file EspIdfUartTransport.cpp
+ * @brief VTXTransport adapter for the ESP-IDF uart_driver API
+ */
+
+#include "EspIdfUartTransport.h"
+
+#ifdef ESP_PLATFORM
+
+EspIdfUartTransport::EspIdfUartTransport(uart_port_t port, int txPin, int rxPin)
+    : _port(port), _txPin(txPin), _rxPin(rxPin) {
+}
+
+bool EspIdfUartTransport::open() {
+    if (_installed) {
+        return true;
+    }
+
+    if (uart_driver_install(_port, VTX_IDF_UART_RX_BUFFER_SIZE, VTX_IDF_UART_TX_BUFFER_SIZE,
+                            VTX_IDF_UART_EVENT_QUEUE_SIZE, &_eventQueue, 0) != ESP_OK) {
+        return false;
+    }
+
+    _installed = true;
+    return true;
+}
+
+void EspIdfUartTransport::close() {
+    if (_eventTask) {
+        vTaskDelete(_eventTask);
+        _eventTask = nullptr;
+    }
+    if (_installed) {
+        // Also deletes the event queue
+        uart_driver_delete(_port);
+        _eventQueue = nullptr;
+        _installed = false;
+    }
+}
+
+bool EspIdfUartTransport::configure(uint32_t baud, VTXFraming framing) {
+    if (!_installed && !open()) {
+        return false;
+    }
+
+    uart_config_t config = {};
+    config.baud_rate = (int)baud;
+    config.data_bits = UART_DATA_8_BITS;
+    config.parity = UART_PARITY_DISABLE;
+    config.stop_bits = (framing == VTX_FRAMING_8N2) ? UART_STOP_BITS_2 : UART_STOP_BITS_1;
+    config.flow_ctrl = UART_HW_FLOWCTRL_DISABLE;
+
+    if (uart_param_config(_port, &config) != ESP_OK) {
+        return false;
+    }
+
+    return uart_set_pin(_port, _txPin, _rxPin >= 0 ? _rxPin : UART_PIN_NO_CHANGE,
+                        UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE) == ESP_OK;
+}
+
+int EspIdfUartTransport::available() {
+    size_t len = 0;
+    if (!_installed || uart_get_buffered_data_len(_port, &len) != ESP_OK) {
+        return 0;
+    }
+    return (int)len;
+}
+
+size_t EspIdfUartTransport::read(uint8_t* buf, size_t len) {
+    if (!_installed) {
+        return 0;
+    }
+
+    // Zero tick timeout: only return what is already buffered
+    const int n = uart_read_bytes(_port, buf, len, 0);
+    return n > 0 ? (size_t)n : 0;
+}
+
+size_t EspIdfUartTransport::write(const uint8_t* buf, size_t len) {
+    if (!_installed) {
+        return 0;
+    }
+
+    // With a TX ring buffer installed this copies and returns immediately
+    // as long as the data fits, so clamp to the free space
+    size_t free = 0;
+    if (uart_get_tx_buffer_free_size(_port, &free) == ESP_OK && len > free) {
+        len = free;
+    }
+
+    const int n = uart_write_bytes(_port, buf, len);
+    return n > 0 ? (size_t)n : 0;
+}
+
+size_t EspIdfUartTransport::txPending() {
+    if (!_installed) {
+        return 0;
+    }
+
+    size_t free = 0;
+    if (uart_get_tx_buffer_free_size(_port, &free) != ESP_OK) {
+        return 0;
+    }
+
+    const size_t pending = free < VTX_IDF_UART_TX_BUFFER_SIZE ? VTX_IDF_UART_TX_BUFFER_SIZE - free : 0;
+    if (pending > 0) {
+        return pending;
+    }
+
+    // Ring buffer empty; report the FIFO as one pending byte until the
+    // shifter is idle so callers never see "drained" too early
+    return uart_wait_tx_done(_port, 0) == ESP_OK ? 0 : 1;
+}
+
+bool EspIdfUartTransport::setReceiveCallback(VTXReceiveCallback callback, void* context) {
+    if (_rxPin < 0) {
+        return false;
+    }
+
+    // The event task stays alive (blocked on the queue) until close()
+    _rxCallback = nullptr;
+    if (!callback) {
+        return true;
+    }
+    if (!_installed && !open()) {
+        return false;
+    }
+
+    // Context first: the event task only looks at it once the callback is set
+    _rxContext = context;
+    _rxCallback = callback;
+    if (_eventTask) {
+        return true;
+    }
+
+    // One byte threshold so a frame is seen as soon as its last byte lands,
+    // not after the driver's 120 byte / 10 symbol idle defaults
+    uart_set_rx_full_threshold(_port, 1);
+    uart_set_rx_timeout(_port, 1);
+
+    if (xTaskCreate(eventTask, "vtx_uart", VTX_IDF_UART_EVENT_TASK_STACK, this,
+                    VTX_IDF_UART_EVENT_TASK_PRIORITY, &_eventTask) != pdPASS) {
+        _eventTask = nullptr;
+        _rxCallback = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void EspIdfUartTransport::eventTask(void* arg) {
+    EspIdfUartTransport* self = static_cast<EspIdfUartTransport*>(arg);
+    uart_event_t event;
+
+    for (;;) {
+        if (xQueueReceive(self->_eventQueue, &event, portMAX_DELAY) != pdTRUE) {
+            continue;
+        }
+
+        switch (event.type) {
+            case UART_DATA: {
+                const VTXReceiveCallback callback = self->_rxCallback;
+                if (callback) {
+                    callback(self->_rxContext);
+                }
+                break;
+            }
+
+            case UART_FIFO_OVF:
+            case UART_BUFFER_FULL:
+                // Nobody drained the ring buffer; start clean, the parsers resync
+                uart_flush_input(self->_port);
+                xQueueReset(self->_eventQueue);
+                break;
+
+            default:
+                break;
+        }
+    }
+}
+
+void EspIdfUartTransport::flush() {
+    if (_installed) {
+        uart_wait_tx_done(_port, portMAX_DELAY);
+    }
+}
+
+#endif // ESP_PLATFORM
@@ -0,0 +1,64 @@
+/**
+ * @file EspIdfUartTransport.h
+ * @brief VTXTransport adapter for the ESP-IDF uart_driver API
+ *
+ * Usable from plain ESP-IDF projects as well as from Arduino-ESP32 when the
+ * UART is not also claimed by a HardwareSerial instance.
+ */
+
+#ifndef ESPIDFUARTTRANSPORT_H
+#define ESPIDFUARTTRANSPORT_H
+
+#include "VTXTransport.h"
+
+#ifdef ESP_PLATFORM
+
+#include <driver/uart.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/queue.h>
+#include <freertos/task.h>
+
+#define VTX_IDF_UART_RX_BUFFER_SIZE 256     // Driver minimum is UART_FIFO_LEN + 1
+#define VTX_IDF_UART_TX_BUFFER_SIZE 256
+#define VTX_IDF_UART_EVENT_QUEUE_SIZE   8
+#define VTX_IDF_UART_EVENT_TASK_STACK   3072
+#define VTX_IDF_UART_EVENT_TASK_PRIORITY 12
+
+class EspIdfUartTransport : public VTXTransport {
+public:
+    /**
+     * @param port UART port number (e.g. UART_NUM_1)
+     * @param txPin TX GPIO
+     * @param rxPin RX GPIO, -1 for TX-only wiring
+     */
+    EspIdfUartTransport(uart_port_t port, int txPin, int rxPin = -1);
+
+    bool open() override;
+    void close() override;
+    bool configure(uint32_t baud, VTXFraming framing) override;
+    int available() override;
+    size_t read(uint8_t* buf, size_t len) override;
+    size_t write(const uint8_t* buf, size_t len) override;
+    size_t txPending() override;
+    void flush() override;
+    bool hasRx() const override { return _rxPin >= 0; }
+    bool setReceiveCallback(VTXReceiveCallback callback, void* context) override;
+
+    uart_port_t port() const { return _port; }
+
+private:
+    uart_port_t _port;
+    int _txPin;
+    int _rxPin;
+    bool _installed = false;
+    QueueHandle_t _eventQueue = nullptr;
+    TaskHandle_t _eventTask = nullptr;
+    void* volatile _rxContext = nullptr;
+    volatile VTXReceiveCallback _rxCallback = nullptr;
+
+    static void eventTask(void* arg);
+};
+
+#endif // ESP_PLATFORM
+
+#endif // ESPIDFUARTTRANSPORT_H
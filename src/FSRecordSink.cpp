@@ -0,0 +1,53 @@
+/**
+ * @file FSRecordSink.cpp
+ * @brief Flight recorder sink for Arduino file systems (LittleFS, SPIFFS, SD)
+ */
+
+#include "FSRecordSink.h"
+
+#ifdef ARDUINO
+
+FSRecordSink::FSRecordSink(fs::FS& fs, const char* prefix, uint8_t slots)
+    : _fs(fs), _slots(slots) {
+    strncpy(_prefix, prefix ? prefix : "", sizeof(_prefix) - 1);
+    _prefix[sizeof(_prefix) - 1] = '\0';
+}
+
+void FSRecordSink::slotPath(uint8_t slot, char* buf, size_t len) const {
+    snprintf(buf, len, "%s%u.bin", _prefix, (unsigned)slot);
+}
+
+size_t FSRecordSink::readSlot(uint8_t slot, uint8_t* buf, size_t len) {
+    char path[VTX_RECORD_PATH_MAX + 8];
+    slotPath(slot, path, sizeof(path));
+    if (!_fs.exists(path)) {
+        return 0;
+    }
+    fs::File file = _fs.open(path, FILE_READ);
+    if (!file) {
+        return 0;
+    }
+    const size_t n = file.read(buf, len);
+    file.close();
+    return n;
+}
+
+bool FSRecordSink::openSlot(uint8_t slot) {
+    close();
+    char path[VTX_RECORD_PATH_MAX + 8];
+    slotPath(slot, path, sizeof(path));
+    _file = _fs.open(path, FILE_WRITE);
+    return (bool)_file;
+}
+
+bool FSRecordSink::write(const uint8_t* buf, size_t len) {
+    return _file && _file.write(buf, len) == len;
+}
+
+void FSRecordSink::close() {
+    if (_file) {
+        _file.close();
+    }
+}
+
+#endif // ARDUINO
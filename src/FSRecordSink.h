@@ -0,0 +1,50 @@
+/**
+ * @file FSRecordSink.h
+ * @brief Flight recorder sink for Arduino file systems (LittleFS, SPIFFS, SD)
+ *
+ * Slot n is the file "<prefix><n>.bin". Opening a slot truncates it, so
+ * the files are reused in turn and the log never outgrows
+ * slots * maxFileBytes plus one block.
+ */
+
+#ifndef FSRECORDSINK_H
+#define FSRECORDSINK_H
+
+#include "VTXRecorder.h"
+
+#define VTX_RECORD_PATH_MAX     32
+
+#ifdef ARDUINO
+
+#include <FS.h>
+
+class FSRecordSink : public VTXRecordSink {
+public:
+    /**
+     * @param fs Mounted file system, e.g. LittleFS after LittleFS.begin()
+     * @param prefix Path of the files without slot number and extension
+     * @param slots Files to rotate through
+     */
+    FSRecordSink(fs::FS& fs, const char* prefix = "/vtxlog", uint8_t slots = 4);
+
+    uint8_t slots() const override { return _slots; }
+    size_t readSlot(uint8_t slot, uint8_t* buf, size_t len) override;
+    bool openSlot(uint8_t slot) override;
+    bool write(const uint8_t* buf, size_t len) override;
+    void close() override;
+
+    /**
+     * @brief Path of a slot's file, for reading the log back (e.g. over serial)
+     */
+    void slotPath(uint8_t slot, char* buf, size_t len) const;
+
+private:
+    fs::FS& _fs;
+    char _prefix[VTX_RECORD_PATH_MAX];
+    uint8_t _slots;
+    fs::File _file;
+};
+
+#endif // ARDUINO
+
+#endif // FSRECORDSINK_H
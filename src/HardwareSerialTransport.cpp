@@ -0,0 +1,131 @@
+/**
+ * @file HardwareSerialTransport.cpp
+ * @brief VTXTransport adapter for the Arduino-ESP32 HardwareSerial class
+ */
+
+#include "HardwareSerialTransport.h"
+
+#ifdef ARDUINO
+
+HardwareSerialTransport::HardwareSerialTransport(HardwareSerial* serial, int8_t txPin, int8_t rxPin)
+    : _serial(serial), _txPin(txPin), _rxPin(rxPin) {
+}
+
+void HardwareSerialTransport::attach(HardwareSerial* serial, int8_t txPin, int8_t rxPin) {
+    _serial = serial;
+    _txPin = txPin;
+    _rxPin = rxPin;
+    _baud = 0;
+}
+
+bool HardwareSerialTransport::open() {
+    return _serial != nullptr;
+}
+
+void HardwareSerialTransport::close() {
+    if (_serial) {
+        _serial->end();
+    }
+    _baud = 0;
+}
+
+bool HardwareSerialTransport::configure(uint32_t baud, VTXFraming framing) {
+    if (!_serial) {
+        return false;
+    }
+
+    // Already running like this (begin() again): skip the driver restart
+    if (_baud == baud && _framing == framing) {
+        return true;
+    }
+
+    // Running at other line settings (protocol switch): begin() over begin()
+    // keeps the buffers, and arduino-esp32 3.x reconfigures the installed
+    // driver in place. TX buffer size can only be changed while it is stopped.
+    const bool restart = (_baud == 0);
+    if (restart) {
+        _serial->end();
+#if VTX_TX_BUFFER_SIZE > 0
+        _serial->setTxBufferSize(VTX_TX_BUFFER_SIZE);
+#endif
+    }
+    _serial->begin(baud, framing == VTX_FRAMING_8N2 ? SERIAL_8N2 : SERIAL_8N1, _rxPin, _txPin);
+    if (restart) {
+        _txCapacity = _serial->availableForWrite();
+    }
+    _baud = baud;
+    _framing = framing;
+    registerReceiveCallback();
+    return true;
+}
+
+bool HardwareSerialTransport::setReceiveCallback(VTXReceiveCallback callback, void* context) {
+    if (!_serial || _rxPin < 0) {
+        return false;
+    }
+
+    _rxCallback = callback;
+    _rxContext = context;
+    registerReceiveCallback();
+    return true;
+}
+
+void HardwareSerialTransport::registerReceiveCallback() {
+    if (!_serial || _rxPin < 0) {
+        return;
+    }
+
+    if (!_rxCallback) {
+        _serial->onReceive(nullptr);
+        return;
+    }
+
+    // Runs in the core's UART event task. One byte FIFO threshold: the
+    // default fires only after 120 bytes or an idle gap, i.e. one or two
+    // character times after a frame has ended
+    _serial->onReceive([this]() {
+        if (_rxCallback) {
+            _rxCallback(_rxContext);
+        }
+    }, false);
+    _serial->setRxFIFOFull(1);
+}
+
+int HardwareSerialTransport::available() {
+    return _serial ? _serial->available() : 0;
+}
+
+size_t HardwareSerialTransport::read(uint8_t* buf, size_t len) {
+    if (!_serial) {
+        return 0;
+    }
+
+    size_t n = 0;
+    while (n < len && _serial->available() > 0) {
+        buf[n++] = (uint8_t)_serial->read();
+    }
+    return n;
+}
+
+size_t HardwareSerialTransport::write(const uint8_t* buf, size_t len) {
+    return _serial ? _serial->write(buf, len) : 0;
+}
+
+size_t HardwareSerialTransport::txPending() {
+    if (!_serial) {
+        return 0;
+    }
+
+    // Approximation: the driver only reports free ring buffer space,
+    // bytes still in the hardware FIFO are not included
+    const int free = _serial->availableForWrite();
+    return (free >= 0 && free < _txCapacity) ? (size_t)(_txCapacity - free) : 0;
+}
+
+void HardwareSerialTransport::flush() {
+    if (_serial) {
+        _serial->flush();
+    }
+}
+
+#endif // ARDUINO
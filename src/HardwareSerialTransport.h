@@ -0,0 +1,54 @@
+/**
+ * @file HardwareSerialTransport.h
+ * @brief VTXTransport adapter for the Arduino-ESP32 HardwareSerial class
+ */
+
+#ifndef HARDWARESERIALTRANSPORT_H
+#define HARDWARESERIALTRANSPORT_H
+
+#include "VTXTransport.h"
+
+#define VTX_TX_BUFFER_SIZE          BETAVTX_TX_BUFFER_SIZE
+
+#ifdef ARDUINO
+
+class HardwareSerialTransport : public VTXTransport {
+public:
+    /**
+     * @param serial HardwareSerial port (e.g. &Serial2)
+     * @param txPin TX pin number
+     * @param rxPin RX pin number, -1 for TX-only wiring
+     */
+    HardwareSerialTransport(HardwareSerial* serial = nullptr, int8_t txPin = -1, int8_t rxPin = -1);
+
+    void attach(HardwareSerial* serial, int8_t txPin, int8_t rxPin = -1);
+
+    bool open() override;
+    void close() override;
+    bool configure(uint32_t baud, VTXFraming framing) override;
+    int available() override;
+    size_t read(uint8_t* buf, size_t len) override;
+    size_t write(const uint8_t* buf, size_t len) override;
+    size_t txPending() override;
+    void flush() override;
+    bool hasRx() const override { return _rxPin >= 0; }
+    bool setReceiveCallback(VTXReceiveCallback callback, void* context) override;
+
+    HardwareSerial* serial() const { return _serial; }
+
+private:
+    HardwareSerial* _serial;
+    int8_t _txPin;
+    int8_t _rxPin;
+    int _txCapacity = 0;    // Free TX space right after begin()
+    uint32_t _baud = 0;     // Line settings the port is running with, 0 if stopped
+    VTXFraming _framing = VTX_FRAMING_8N1;
+    VTXReceiveCallback _rxCallback = nullptr;
+    void* _rxContext = nullptr;
+
+    void registerReceiveCallback();
+};
+
+#endif // ARDUINO
+
+#endif // HARDWARESERIALTRANSPORT_H
@@ -0,0 +1,90 @@
+/**
+ * @file MSPCodec.cpp
+ * @brief MultiWii Serial Protocol (v1) frame parser and encoder
+ */
+
+#include "MSPCodec.h"
+
+bool MSPParser::feed(uint8_t c) {
+    switch (_state) {
+        case WAIT_DOLLAR:
+            if (c == '$') {
+                _state = WAIT_M;
+            }
+            break;
+
+        case WAIT_M:
+            _state = (c == 'M') ? WAIT_DIRECTION : WAIT_DOLLAR;
+            break;
+
+        case WAIT_DIRECTION:
+            if (c == MSP_DIR_REQUEST || c == MSP_DIR_RESPONSE || c == MSP_DIR_ERROR) {
+                _direction = c;
+                _state = WAIT_SIZE;
+            } else {
+                _state = WAIT_DOLLAR;
+            }
+            break;
+
+        case WAIT_SIZE:
+            if (c > MSP_MAX_PAYLOAD) {
+                _state = WAIT_DOLLAR;
+                break;
+            }
+            _size = c;
+            _checksum = c;
+            _state = WAIT_CMD;
+            break;
+
+        case WAIT_CMD:
+            _cmd = c;
+            _checksum ^= c;
+            _pos = 0;
+            _state = _size > 0 ? WAIT_PAYLOAD : WAIT_CHECKSUM;
+            break;
+
+        case WAIT_PAYLOAD:
+            _payload[_pos++] = c;
+            _checksum ^= c;
+            if (_pos >= _size) {
+                _state = WAIT_CHECKSUM;
+            }
+            break;
+
+        case WAIT_CHECKSUM:
+            _state = WAIT_DOLLAR;
+            if (c != _checksum) {
+                _checksumErrors++;
+                break;
+            }
+            _frame.direction = _direction;
+            _frame.cmd = _cmd;
+            _frame.size = _size;
+            _frame.payload = _payload;
+            return true;
+    }
+
+    return false;
+}
+
+uint8_t mspEncode(uint8_t direction, uint8_t cmd, const uint8_t* payload, uint8_t size,
+                  uint8_t* out, uint8_t maxLen) {
+    if (size > MSP_MAX_PAYLOAD || maxLen < size + MSP_FRAME_OVERHEAD) {
+        return 0;
+    }
+
+    out[0] = '$';
+    out[1] = 'M';
+    out[2] = direction;
+    out[3] = size;
+    out[4] = cmd;
+
+    uint8_t checksum = size ^ cmd;
+    for (uint8_t i = 0; i < size; i++) {
+        out[5 + i] = payload[i];
+        checksum ^= payload[i];
+    }
+    out[5 + size] = checksum;
+
+    return size + MSP_FRAME_OVERHEAD;
+}
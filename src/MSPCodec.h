@@ -0,0 +1,86 @@
+/**
+ * @file MSPCodec.h
+ * @brief MultiWii Serial Protocol (v1) frame parser and encoder
+ *
+ * Frame layout: '$' 'M' direction size cmd payload[size] checksum, where the
+ * checksum is the XOR of size, cmd and payload. Direction is '<' for a
+ * request, '>' for a response and '!' for an error reply.
+ */
+
+#ifndef MSPCODEC_H
+#define MSPCODEC_H
+
+#include "VTXPlatform.h"
+
+#define MSP_MAX_PAYLOAD         64      // Larger frames are dropped
+#define MSP_FRAME_OVERHEAD      6       // '$' 'M' dir size cmd ... checksum
+
+#define MSP_DIR_REQUEST         '<'
+#define MSP_DIR_RESPONSE        '>'
+#define MSP_DIR_ERROR           '!'
+
+#define MSP_VTX_CONFIG          88
+#define MSP_SET_VTX_CONFIG      89
+
+struct MSPFrame {
+    uint8_t direction;      // MSP_DIR_REQUEST, MSP_DIR_RESPONSE or MSP_DIR_ERROR
+    uint8_t cmd;
+    uint8_t size;
+    const uint8_t* payload; // Valid until the next call to MSPParser::feed()
+};
+
+class MSPParser {
+public:
+    /**
+     * @brief Feed one received byte
+     * @return true when a complete frame with a valid checksum is available in frame()
+     */
+    bool feed(uint8_t c);
+
+    const MSPFrame& frame() const { return _frame; }
+
+    void reset() { _state = WAIT_DOLLAR; }
+
+    uint16_t checksumErrors() const { return _checksumErrors; }
+
+private:
+    enum State {
+        WAIT_DOLLAR,
+        WAIT_M,
+        WAIT_DIRECTION,
+        WAIT_SIZE,
+        WAIT_CMD,
+        WAIT_PAYLOAD,
+        WAIT_CHECKSUM
+    };
+
+    State _state = WAIT_DOLLAR;
+    uint8_t _direction = 0;
+    uint8_t _size = 0;
+    uint8_t _cmd = 0;
+    uint8_t _pos = 0;
+    uint8_t _checksum = 0;
+    uint8_t _payload[MSP_MAX_PAYLOAD];
+    MSPFrame _frame = {};
+    uint16_t _checksumErrors = 0;
+};
+
+/**
+ * @brief Encode a complete MSP v1 frame
+ * @param direction MSP_DIR_REQUEST, MSP_DIR_RESPONSE or MSP_DIR_ERROR
+ * @param out Output buffer, at least size + MSP_FRAME_OVERHEAD bytes
+ * @return Number of bytes written, 0 if out is too small
+ */
+uint8_t mspEncode(uint8_t direction, uint8_t cmd, const uint8_t* payload, uint8_t size,
+                  uint8_t* out, uint8_t maxLen);
+
+static inline uint16_t mspReadU16(const uint8_t* p) {
+    return (uint16_t)(p[0] | (p[1] << 8));
+}
+
+static inline void mspWriteU16(uint8_t* p, uint16_t v) {
+    p[0] = v & 0xFF;
+    p[1] = v >> 8;
+}
+
+#endif // MSPCODEC_H
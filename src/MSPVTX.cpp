@@ -0,0 +1,478 @@
+/**
+ * @file MSPVTX.cpp
+ * @brief MSP VTX protocol implementation (MSP_VTX_CONFIG / MSP_SET_VTX_CONFIG)
+ *
+ * Payload layouts as in Betaflight msp.c
+ */
+
+#include "MSPVTX.h"
+
+#if BETAVTX_ENABLE_MSP
+
+#if BETAVTX_ENABLE_STATS
+#define MSP_COUNT(counter)  (_stats.counter++)
+#else
+#define MSP_COUNT(counter)  ((void)0)
+#endif
+
+#define MSP_VTX_MAX_FRAME       (MSP_FRAME_OVERHEAD + 4)    // Largest request: SET_VTX_CONFIG, 4 byte payload
+
+// Nominal mW for the default power levels 1-5
+static const uint16_t mspPowerLevelMw[MSP_VTX_DEFAULT_POWER_LEVELS] = { 25, 200, 400, 600, 800 };
+
+MSPVTX::MSPVTX() {
+}
+
+MSPVTX::~MSPVTX() {
+    if (_transport) {
+#if BETAVTX_ENABLE_RX
+        // Before the parser goes away under a running receive callback
+        setEventDrivenRx(false);
+#endif
+        _transport->close();
+    }
+}
+
+bool MSPVTX::start() {
+    if (!openTransport(MSP_VTX_BAUD, VTX_FRAMING_8N1)) {
+        return false;
+    }
+
+    resetDevice(VTX_DEVICE_MSP);
+    _configValid = false;
+    _sendMask = 0;
+    _batchMask = 0;
+#if BETAVTX_ENABLE_RX
+    _awaiting = 0;
+    _readbackDue = false;
+    _responseTimeoutMs = 2 * MSP_VTX_CMD_TIMEOUT;
+#endif
+
+    // In TX-only mode, we're ready immediately after begin()
+    _isReady = true;
+
+    debugPrintln("[MSP] Debug enabled");
+
+    return true;
+}
+
+void MSPVTX::update() {
+    if (!_transport) {
+        return;
+    }
+
+    // Line kept idle for a scheduled command: replies are still handled, service() sends nothing
+    serviceSchedule();
+
+#if BETAVTX_ENABLE_RX
+    serviceRx();
+    // Out of budget: retries and polling wait for the next call
+    if (budgetSpent()) {
+        return;
+    }
+#endif
+    serviceCommands();
+    if (budgetSpent()) {
+        return;
+    }
+    service();
+
+    resumeCommandWaiters();
+}
+
+bool MSPVTX::isReady() {
+    return _isReady;
+}
+
+bool MSPVTX::setFrequency(uint16_t freq) {
+    // Betaflight reads values up to 63 as band/channel and ignores those above 5999
+    if (freq < MSP_VTX_FREQ_MIN || freq > MSP_VTX_FREQ_MAX) {
+        return false;
+    }
+    _desiredFreq = freq;
+    return sendTracked(VTX_FIELD_FREQUENCY);
+}
+
+bool MSPVTX::setPower(uint16_t power) {
+    return setPowerByIndex(powerMwToIndex(power));
+}
+
+bool MSPVTX::setPowerByIndex(uint8_t index) {
+    if (index == 0) {
+        return false;
+    }
+    _desiredPowerIndex = index;
+    return sendTracked(VTX_FIELD_POWER);
+}
+
+bool MSPVTX::setPitMode(bool enable) {
+    _desiredPitMode = enable;
+    return sendTracked(VTX_FIELD_PIT_MODE);
+}
+
+uint8_t MSPVTX::encodeFrequencyFrame(uint16_t freq, uint8_t* buf, uint8_t maxLen) {
+    const uint8_t dummies = dummyBytes();
+    if (freq < MSP_VTX_FREQ_MIN || freq > MSP_VTX_FREQ_MAX || maxLen < dummies + MSP_FRAME_OVERHEAD + 2) {
+        return 0;
+    }
+
+    // A two byte payload changes the frequency only
+    uint8_t payload[2];
+    mspWriteU16(payload, freq);
+    memset(buf, 0, dummies);
+    return dummies + mspEncode(MSP_DIR_REQUEST, MSP_SET_VTX_CONFIG, payload, sizeof(payload),
+                               buf + dummies, maxLen - dummies);
+}
+
+uint8_t MSPVTX::encodePitModeFrame(bool enable, uint8_t* buf, uint8_t maxLen) {
+    const uint8_t dummies = dummyBytes();
+    if (maxLen < dummies + MSP_FRAME_OVERHEAD + 4) {
+        return 0;
+    }
+
+    // Pit mode goes with a power level: the one known now
+    uint8_t payload[4];
+    mspWriteU16(payload, MSP_VTX_FREQ_KEEP);
+    payload[2] = (_setFields & VTX_FIELD_POWER) ? _desiredPowerIndex : (_configValid ? _curPowerIndex : 1);
+    payload[3] = enable ? 1 : 0;
+    memset(buf, 0, dummies);
+    return dummies + mspEncode(MSP_DIR_REQUEST, MSP_SET_VTX_CONFIG, payload, sizeof(payload),
+                               buf + dummies, maxLen - dummies);
+}
+
+uint8_t MSPVTX::powerMwToIndex(uint16_t powerMw) const {
+    if (_vtxTable) {
+        const uint8_t level = _vtxTable->findPowerLevel(powerMw);
+        if (level) {
+            return level;
+        }
+    }
+
+    if (powerMw <= 50) return 1;      // 25mW
+    if (powerMw <= 300) return 2;     // 200mW
+    if (powerMw <= 500) return 3;     // 400mW
+    if (powerMw <= 700) return 4;     // 600mW
+    return 5;                          // 800mW
+}
+
+// ===== Private Methods =====
+
+uint16_t MSPVTX::powerIndexMw(uint8_t index) const {
+    if (_vtxTable && _vtxTable->powerMw(index)) {
+        return _vtxTable->powerMw(index);
+    }
+    if (index == 0) {
+        return 0;
+    }
+    return mspPowerLevelMw[index <= MSP_VTX_DEFAULT_POWER_LEVELS ? index - 1 : MSP_VTX_DEFAULT_POWER_LEVELS - 1];
+}
+
+bool MSPVTX::sendTracked(VTXStateField field) {
+    _setFields |= field;
+    beginCommand(field);
+    _sendMask |= field;
+
+    // Goes out now unless a reply is outstanding; update() picks it up then
+    service();
+    return true;
+}
+
+void MSPVTX::scheduledCommandSent(VTXStateField field, uint16_t value, uint8_t len) {
+    MSP_COUNT(packetsSent);
+
+    if (field == VTX_FIELD_FREQUENCY) {
+        _desiredFreq = value;
+    } else {
+        _desiredPitMode = value != 0;
+    }
+    _setFields |= field;
+    beginCommand(field);
+    commandSent(field);
+    _sendMask &= ~field;
+    _batchMask |= field;
+
+#if BETAVTX_ENABLE_RX
+    if (_transport->hasRx()) {
+        _awaiting = MSP_SET_VTX_CONFIG;
+        _lastRequest = millis();
+    }
+#endif
+    rttRequestSent(len);
+}
+
+void MSPVTX::requestedFrequency(uint16_t freq) {
+    _desiredFreq = freq;
+    _setFields |= VTX_FIELD_FREQUENCY;
+    _sendMask &= ~VTX_FIELD_FREQUENCY;
+}
+
+void MSPVTX::resendCommand(VTXStateField field) {
+    // Sent together with any other field that is due
+    _sendMask |= field;
+}
+
+void MSPVTX::linkLost() {
+#if BETAVTX_ENABLE_RX
+    // Read back before sending anything, the device may have reset to defaults
+    _configValid = false;
+    _awaiting = 0;
+    _batchMask = 0;
+#endif
+}
+
+void MSPVTX::restoreSettings(uint8_t fields) {
+    // Called while a reply is handled; update() sends them right after
+    static const VTXStateField order[] = { VTX_FIELD_FREQUENCY, VTX_FIELD_POWER, VTX_FIELD_PIT_MODE };
+    for (uint8_t i = 0; i < sizeof(order) / sizeof(order[0]); i++) {
+        if (fields & order[i]) {
+            beginCommand(order[i]);
+            _sendMask |= order[i];
+        }
+    }
+}
+
+void MSPVTX::service() {
+    if (scheduleHold()) {
+        return;
+    }
+
+#if BETAVTX_ENABLE_RX
+    if (_transport->hasRx()) {
+        const unsigned long now = millis();
+
+        if (_awaiting != 0) {
+            if (now - _lastRequest <= cmdTimeoutMs()) {
+                return;
+            }
+            // Reply lost; read back, a lost ack doesn't mean the change was lost
+            _awaiting = 0;
+            _readbackDue = true;
+        }
+
+        // Fields not being set are sent with their read back value
+        if (_sendMask != 0 && _configValid) {
+            sendConfig();
+        } else if (_readbackDue || !_configValid || now - _lastPoll >= _profile->pollIntervalMs) {
+            query();
+        }
+        return;
+    }
+#endif
+
+    if (_sendMask != 0) {
+        sendConfig();
+    }
+}
+
+uint8_t MSPVTX::buildConfig(uint8_t* payload) const {
+    // Frequency first; a value above 5999 MHz leaves it alone
+    uint16_t freq = MSP_VTX_FREQ_KEEP;
+    if (_setFields & VTX_FIELD_FREQUENCY) {
+        freq = _desiredFreq;
+    } else if (_configValid) {
+        freq = _curFreq;
+    }
+    mspWriteU16(payload, freq);
+
+    // Power and pit mode always go together
+    if (!((_sendMask | _batchMask) & (VTX_FIELD_POWER | VTX_FIELD_PIT_MODE))) {
+        return 2;
+    }
+
+    // Unknown power (TX-only link, never set) falls back to the lowest level
+    payload[2] = (_setFields & VTX_FIELD_POWER) ? _desiredPowerIndex : (_configValid ? _curPowerIndex : 1);
+    payload[3] = ((_setFields & VTX_FIELD_PIT_MODE) ? _desiredPitMode : (_configValid && _curPitMode)) ? 1 : 0;
+    return 4;
+}
+
+void MSPVTX::sendConfig() {
+    uint8_t payload[4];
+    const uint8_t size = buildConfig(payload);
+    sendRequest(MSP_SET_VTX_CONFIG, payload, size);
+
+    static const VTXStateField order[] = { VTX_FIELD_FREQUENCY, VTX_FIELD_POWER, VTX_FIELD_PIT_MODE };
+    for (uint8_t i = 0; i < sizeof(order) / sizeof(order[0]); i++) {
+        if (_sendMask & order[i]) {
+            commandSent(order[i]);
+        }
+    }
+    _batchMask |= _sendMask;
+    _sendMask = 0;
+}
+
+void MSPVTX::sendRequest(uint8_t cmd, const uint8_t* payload, uint8_t size) {
+    uint8_t buf[VTX_MAX_DUMMY_BYTES + MSP_VTX_MAX_FRAME];
+    const uint8_t dummies = dummyBytes();
+    memset(buf, 0, dummies);
+    const uint8_t len = mspEncode(MSP_DIR_REQUEST, cmd, payload, size, buf + dummies, MSP_VTX_MAX_FRAME);
+    if (len == 0) {
+        return;
+    }
+
+    debugPrintHex(buf + dummies, len, "MSP");
+    recordTx(buf + dummies, len);
+    _transport->write(buf, dummies + len);
+    finishTx();
+    MSP_COUNT(packetsSent);
+
+#if BETAVTX_ENABLE_RX
+    if (_transport->hasRx()) {
+        _awaiting = cmd;
+        _lastRequest = millis();
+    }
+#endif
+    rttRequestSent(dummies + len);
+}
+
+#if BETAVTX_ENABLE_RX
+
+void MSPVTX::query() {
+    _readbackDue = false;
+    _lastPoll = millis();
+    sendRequest(MSP_VTX_CONFIG, nullptr, 0);
+}
+
+uint32_t MSPVTX::cmdTimeoutMs() const {
+    return _rtt.timeoutUs(_profile->timeoutMinMs * 1000UL, _profile->timeoutMaxMs * 1000UL,
+                          MSP_VTX_CMD_TIMEOUT * 1000UL) / 1000;
+}
+
+void MSPVTX::processResponse(uint8_t direction, uint8_t cmd, const uint8_t* payload, uint8_t size) {
+    // Our own request echoed on a single-wire link
+    if (direction == MSP_DIR_REQUEST) {
+        return;
+    }
+
+    if (cmd == _awaiting) {
+        _awaiting = 0;
+    }
+    MSP_COUNT(packetsReceived);
+    rttResponseReceived();
+    _responseTimeoutMs = 2 * cmdTimeoutMs();
+
+    if (direction == MSP_DIR_ERROR) {
+        MSP_COUNT(errorReplies);
+        if (cmd == MSP_SET_VTX_CONFIG) {
+            // Device doesn't take this config; retrying won't help
+            static const VTXStateField order[] = { VTX_FIELD_FREQUENCY, VTX_FIELD_POWER, VTX_FIELD_PIT_MODE };
+            for (uint8_t i = 0; i < sizeof(order) / sizeof(order[0]); i++) {
+                if (_batchMask & order[i]) {
+                    finishCommand(order[i], VTX_RESULT_REJECTED);
+                }
+            }
+            _batchMask = 0;
+        }
+        return;
+    }
+
+    switch (cmd) {
+        case MSP_SET_VTX_CONFIG:
+            // Accepted, confirm by reading back
+            _batchMask = 0;
+            _readbackDue = true;
+            break;
+
+        case MSP_VTX_CONFIG:
+            handleVtxConfig(payload, size);
+            break;
+
+        default:
+            break;
+    }
+}
+
+void MSPVTX::handleVtxConfig(const uint8_t* payload, uint8_t size) {
+    if (size < MSP_VTX_CONFIG_MIN_SIZE) {
+        return;
+    }
+
+    const uint8_t band = payload[1];
+    const uint8_t channel = payload[2];
+    uint16_t freq = mspReadU16(&payload[5]);
+    if (freq == 0 && band > 0 && channel > 0) {
+        // Band/channel only: resolve through the loaded vtxtable, else the default bands
+        freq = _vtxTable ? _vtxTable->frequency(band, channel) : 0;
+        if (freq == 0 && band <= VTX_MAX_BAND && channel <= VTX_MAX_CHANNEL) {
+            freq = vtxBandChannelToFrequency(band, channel);
+        }
+    }
+
+    _curFreq = freq;
+    _curPowerIndex = payload[3];
+    _curPitMode = payload[4] != 0;
+    _configValid = true;
+
+    // Betaflight appends the vtxtable dimensions, ending with the power level count
+    if (size >= 15) {
+        _device.powerLevels = payload[14];
+    }
+
+    VTXState state = _state;
+    state.frequency = _curFreq;
+    state.powerIndex = _curPowerIndex;
+    state.power = powerIndexMw(_curPowerIndex);
+    state.pitMode = _curPitMode;
+    publishState(state);
+    confirmConfig();
+    recordTelemetry(VTX_METRIC_POWER, state.power);
+
+    linkReady(((_curFreq != _desiredFreq) ? VTX_FIELD_FREQUENCY : 0) |
+              ((_curPowerIndex != _desiredPowerIndex) ? VTX_FIELD_POWER : 0) |
+              ((_curPitMode != _desiredPitMode) ? VTX_FIELD_PIT_MODE : 0));
+}
+
+void MSPVTX::confirmConfig() {
+    if (commandPending(VTX_FIELD_FREQUENCY) && _curFreq == _desiredFreq) {
+        finishCommand(VTX_FIELD_FREQUENCY, VTX_RESULT_CONFIRMED);
+    }
+    if (commandPending(VTX_FIELD_POWER) && _curPowerIndex == _desiredPowerIndex) {
+        finishCommand(VTX_FIELD_POWER, VTX_RESULT_CONFIRMED);
+    }
+    if (commandPending(VTX_FIELD_PIT_MODE) && _curPitMode == _desiredPitMode) {
+        finishCommand(VTX_FIELD_PIT_MODE, VTX_RESULT_CONFIRMED);
+    }
+}
+
+uint8_t MSPVTX::parseRxByte(uint8_t c, VTXRxFrame& frame) {
+    const uint16_t checksumErrors = _parser.checksumErrors();
+    if (!_parser.feed(c)) {
+        return _parser.checksumErrors() != checksumErrors ? MSP_RX_BAD_CHECKSUM : VTX_RX_NONE;
+    }
+
+    const MSPFrame& msp = _parser.frame();
+    if (msp.size > VTX_RX_FRAME_MAX - 2) {
+        return MSP_RX_TOO_LONG;
+    }
+
+    // Direction and command ahead of the payload
+    frame.data[0] = msp.direction;
+    frame.data[1] = msp.cmd;
+    memcpy(&frame.data[2], msp.payload, msp.size);
+    frame.len = 2 + msp.size;
+    return VTX_RX_FRAME;
+}
+
+void MSPVTX::resetRxParser() {
+    _parser.reset();
+}
+
+void MSPVTX::handleRxFrame(const VTXRxFrame& frame) {
+    switch (frame.event) {
+        case VTX_RX_FRAME:
+            processResponse(frame.data[0], frame.data[1], &frame.data[2], frame.len - 2);
+            break;
+
+        case MSP_RX_BAD_CHECKSUM:
+            MSP_COUNT(checksumErrors);
+            recordTelemetry(VTX_METRIC_LINK_ERRORS, VTX_TELEMETRY_ERROR);
+            break;
+
+        default:
+            recordTelemetry(VTX_METRIC_LINK_ERRORS, VTX_TELEMETRY_ERROR);
+            break;
+    }
+}
+
+#endif // BETAVTX_ENABLE_RX
+
+#endif // BETAVTX_ENABLE_MSP
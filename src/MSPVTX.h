@@ -0,0 +1,147 @@
+/**
+ * @file MSPVTX.h
+ * @brief MSP VTX protocol implementation (MSP_VTX_CONFIG / MSP_SET_VTX_CONFIG)
+ *
+ * For VTXs that take MSP VTX commands on their UART at 115200 baud, over
+ * ten times the wire speed of SmartAudio or TRAMP. Frequency, power index
+ * and pit mode go out together in one MSP_SET_VTX_CONFIG request; after
+ * the acknowledgement they are confirmed by reading MSP_VTX_CONFIG back.
+ *
+ * Power is a 1-based level as in Betaflight: the loaded vtxtable's power
+ * levels, else 25/200/400/600/800 mW.
+ */
+
+#ifndef MSPVTX_H
+#define MSPVTX_H
+
+#include "VTXProtocol.h"
+#include "VTXBandTable.h"
+#include "VTXTable.h"
+#include "MSPCodec.h"
+
+#define MSP_VTX_BAUD                115200
+
+#define MSP_VTX_CMD_TIMEOUT         50      // Initial response timeout until RTT samples exist
+#define MSP_VTX_CMD_TIMEOUT_MIN     10      // Clamps for the RTT derived timeout (default profile)
+#define MSP_VTX_CMD_TIMEOUT_MAX     100
+#define MSP_VTX_POLLING_INTERVAL    200     // Config readback period (default profile)
+
+#define MSP_VTX_CONFIG_MIN_SIZE     7       // Device type, band, channel, power, pit, frequency
+#define MSP_VTX_FREQ_KEEP           0xFFFF  // SET_VTX_CONFIG frequency above 5999 MHz leaves it unchanged
+#define MSP_VTX_BANDCHAN_MAX        63      // SET_VTX_CONFIG values up to this are band/channel
+#define MSP_VTX_FREQ_MIN            5000    // Frequencies setFrequency() accepts, in MHz
+#define MSP_VTX_FREQ_MAX            5999
+#define MSP_VTX_DEFAULT_POWER_LEVELS 5
+
+// Parser errors, after VTX_RX_FRAME
+#define MSP_RX_BAD_CHECKSUM         2
+#define MSP_RX_TOO_LONG             3
+
+#if BETAVTX_ENABLE_MSP
+
+class MSPVTX : public VTXProtocol {
+public:
+    MSPVTX();
+    ~MSPVTX();
+
+    using VTXProtocol::update;
+    void update() override;
+    bool isReady() override;
+    bool setFrequency(uint16_t freq) override;
+    bool setPower(uint16_t power) override;
+    bool setPitMode(bool enable) override;
+    uint8_t encodeFrequencyFrame(uint16_t freq, uint8_t* buf, uint8_t maxLen) override;
+    uint8_t encodePitModeFrame(bool enable, uint8_t* buf, uint8_t maxLen) override;
+
+    /**
+     * @brief Set power by level
+     * @param index Power level, 1-based as in the vtxtable
+     * @return false if the level is 0
+     */
+    bool setPowerByIndex(uint8_t index);
+
+    /**
+     * @brief Convert milliwatts to the power level used by setPower()
+     * @return Power level, 1-based
+     */
+    uint8_t powerMwToIndex(uint16_t powerMw) const;
+
+    /**
+     * @brief Use a Betaflight vtxtable for power levels and band/channel readback
+     *
+     * The table must outlive this object. Without one (or with nullptr)
+     * the default A/B/E/F/R bands and 25-800 mW power levels are used.
+     */
+    void setVtxTable(const VTXTable* table) { _vtxTable = (table && table->isValid()) ? table : nullptr; }
+    const VTXTable* getVtxTable() const { return _vtxTable; }
+
+    struct Statistics {
+        uint16_t packetsSent;
+        uint16_t packetsReceived;
+        uint16_t checksumErrors;
+        uint16_t errorReplies;      // '!' replies, e.g. command not supported
+    };
+
+#if BETAVTX_ENABLE_STATS
+    Statistics getStatistics() { return _stats; }
+#endif
+
+protected:
+    bool start() override;
+    void scheduledCommandSent(VTXStateField field, uint16_t value, uint8_t len) override;
+    void requestedFrequency(uint16_t freq) override;
+    void resendCommand(VTXStateField field) override;
+    void linkLost() override;
+    void restoreSettings(uint8_t fields) override;
+#if BETAVTX_ENABLE_RX
+    uint8_t parseRxByte(uint8_t c, VTXRxFrame& frame) override;
+    void resetRxParser() override;
+    void handleRxFrame(const VTXRxFrame& frame) override;
+#endif
+
+private:
+    const VTXTable* _vtxTable = nullptr;
+
+    uint16_t _desiredFreq = 0;
+    uint8_t _desiredPowerIndex = 0;
+    bool _desiredPitMode = false;
+    uint8_t _setFields = 0;         // Fields with a desired value
+
+    uint16_t _curFreq = 0;
+    uint8_t _curPowerIndex = 0;
+    bool _curPitMode = false;
+    bool _configValid = false;      // Read back since start() or the last link-down
+
+    uint8_t _sendMask = 0;          // VTXStateField bits waiting to be sent
+    uint8_t _batchMask = 0;         // Fields in the SET_VTX_CONFIG waiting for its ack
+
+#if BETAVTX_ENABLE_RX
+    MSPParser _parser;
+    uint8_t _awaiting = 0;          // MSP command whose reply is outstanding, 0 if none
+    bool _readbackDue = false;
+    unsigned long _lastRequest = 0;
+    unsigned long _lastPoll = 0;
+#endif
+
+#if BETAVTX_ENABLE_STATS
+    Statistics _stats = {0, 0, 0, 0};
+#endif
+
+    bool sendTracked(VTXStateField field);
+    void service();
+    void sendConfig();
+    uint8_t buildConfig(uint8_t* payload) const;
+    void sendRequest(uint8_t cmd, const uint8_t* payload, uint8_t size);
+    uint16_t powerIndexMw(uint8_t index) const;
+#if BETAVTX_ENABLE_RX
+    void query();
+    void processResponse(uint8_t direction, uint8_t cmd, const uint8_t* payload, uint8_t size);
+    void handleVtxConfig(const uint8_t* payload, uint8_t size);
+    void confirmConfig();
+    uint32_t cmdTimeoutMs() const;
+#endif
+};
+
+#endif // BETAVTX_ENABLE_MSP
+
+#endif
@@ -0,0 +1,233 @@
+/**
+ * @file PosixSerialTransport.cpp
+ * @brief VTXTransport backend for POSIX ttys (USB-UART adapters, ptys)
+ */
+
+#include "PosixSerialTransport.h"
+
+#ifdef VTX_POSIX_SERIAL_TRANSPORT
+
+#include <errno.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/ioctl.h>
+#include <termios.h>
+#include <unistd.h>
+
+static speed_t baudToSpeed(uint32_t baud) {
+    switch (baud) {
+        case 1200:   return B1200;
+        case 2400:   return B2400;
+        case 4800:   return B4800;
+        case 9600:   return B9600;
+        case 19200:  return B19200;
+        case 38400:  return B38400;
+        case 57600:  return B57600;
+        case 115200: return B115200;
+        case 230400: return B230400;
+        default:     return 0;
+    }
+}
+
+PosixSerialTransport::PosixSerialTransport(const char* path) {
+    _path[0] = '\0';
+    setPath(path);
+}
+
+PosixSerialTransport::~PosixSerialTransport() {
+    close();
+}
+
+void PosixSerialTransport::setPath(const char* path) {
+    if (!path) {
+        return;
+    }
+    strncpy(_path, path, VTX_POSIX_PATH_MAX - 1);
+    _path[VTX_POSIX_PATH_MAX - 1] = '\0';
+}
+
+bool PosixSerialTransport::open() {
+    if (_fd >= 0) {
+        return true;
+    }
+    if (_path[0] == '\0') {
+        return false;
+    }
+
+    _fd = ::open(_path, O_RDWR | O_NOCTTY | O_NONBLOCK);
+    if (_fd < 0) {
+        return false;
+    }
+
+    if (!makeRaw(_fd)) {
+        close();
+        return false;
+    }
+    return true;
+}
+
+void PosixSerialTransport::close() {
+    if (_fd >= 0) {
+        ::close(_fd);
+        _fd = -1;
+    }
+}
+
+bool PosixSerialTransport::configure(uint32_t baud, VTXFraming framing) {
+    if (_fd < 0 && !open()) {
+        return false;
+    }
+
+    struct termios tio;
+    if (tcgetattr(_fd, &tio) != 0) {
+        return false;
+    }
+
+    const speed_t speed = baudToSpeed(baud);
+    if (speed == 0) {
+        return false;
+    }
+    cfsetispeed(&tio, speed);
+    cfsetospeed(&tio, speed);
+
+    tio.c_cflag &= ~(CSIZE | PARENB | CSTOPB);
+    tio.c_cflag |= CS8 | CLOCAL | CREAD;
+    if (framing == VTX_FRAMING_8N2) {
+        tio.c_cflag |= CSTOPB;
+    }
+
+    if (tcsetattr(_fd, TCSANOW, &tio) != 0) {
+        return false;
+    }
+
+    tcflush(_fd, TCIOFLUSH);
+    _baud = baud;
+    return true;
+}
+
+int PosixSerialTransport::available() {
+    if (_fd < 0) {
+        return 0;
+    }
+
+    int n = 0;
+    if (ioctl(_fd, FIONREAD, &n) != 0) {
+        return 0;
+    }
+    return n;
+}
+
+size_t PosixSerialTransport::read(uint8_t* buf, size_t len) {
+    if (_fd < 0 || len == 0) {
+        return 0;
+    }
+
+    const ssize_t n = ::read(_fd, buf, len);
+    return n > 0 ? (size_t)n : 0;
+}
+
+size_t PosixSerialTransport::write(const uint8_t* buf, size_t len) {
+    if (_fd < 0) {
+        return 0;
+    }
+
+    const ssize_t n = ::write(_fd, buf, len);
+    if (n < 0) {
+        // EAGAIN: kernel buffer full, caller retries later
+        return 0;
+    }
+    return (size_t)n;
+}
+
+size_t PosixSerialTransport::txPending() {
+    if (_fd < 0) {
+        return 0;
+    }
+
+    int n = 0;
+    if (ioctl(_fd, TIOCOUTQ, &n) != 0 || n < 0) {
+        return 0;
+    }
+    return (size_t)n;
+}
+
+void PosixSerialTransport::flush() {
+    if (_fd < 0) {
+        return;
+    }
+
+    // Sleep in poll() for the remaining wire time instead of spinning.
+    // A byte is at most 11 bits (8N2), bounded by a slack so a stuck
+    // adapter can't hang the caller forever.
+    const uint32_t baud = _baud ? _baud : 9600;
+    size_t pending = txPending();
+    int budgetMs = (int)((pending * 11 * 1000) / baud) + VTX_POSIX_FLUSH_SLACK_MS;
+
+    while (pending > 0 && budgetMs > 0) {
+        const int waitMs = (int)((pending * 11 * 1000) / baud) + 1;
+        poll(nullptr, 0, waitMs);
+        budgetMs -= waitMs;
+        pending = txPending();
+    }
+}
+
+bool PosixSerialTransport::waitReadable(int timeoutMs) {
+    if (_fd < 0) {
+        return false;
+    }
+
+    struct pollfd pfd = { _fd, POLLIN, 0 };
+    int rc;
+    do {
+        rc = poll(&pfd, 1, timeoutMs);
+    } while (rc < 0 && errno == EINTR);
+
+    return rc > 0 && (pfd.revents & POLLIN);
+}
+
+bool PosixSerialTransport::makeRaw(int fd) {
+    struct termios tio;
+    if (tcgetattr(fd, &tio) != 0) {
+        return false;
+    }
+
+    cfmakeraw(&tio);
+    tio.c_cc[VMIN] = 0;
+    tio.c_cc[VTIME] = 0;
+    return tcsetattr(fd, TCSANOW, &tio) == 0;
+}
+
+bool PosixSerialTransport::openPtyPair(PosixSerialTransport& host, PosixSerialTransport& device) {
+    const int master = posix_openpt(O_RDWR | O_NOCTTY);
+    if (master < 0) {
+        return false;
+    }
+
+    if (grantpt(master) != 0 || unlockpt(master) != 0) {
+        ::close(master);
+        return false;
+    }
+
+    const char* slaveName = ptsname(master);
+    const int slave = slaveName ? ::open(slaveName, O_RDWR | O_NOCTTY | O_NONBLOCK) : -1;
+    if (slave < 0) {
+        ::close(master);
+        return false;
+    }
+
+    fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+    if (!makeRaw(master) || !makeRaw(slave)) {
+        ::close(master);
+        ::close(slave);
+        return false;
+    }
+
+    host.close();
+    device.close();
+    host._fd = master;
+    device._fd = slave;
+    device.setPath(slaveName);
+    return true;
+}
+
+#endif // VTX_POSIX_SERIAL_TRANSPORT
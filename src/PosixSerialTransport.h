@@ -0,0 +1,76 @@
+/**
+ * @file PosixSerialTransport.h
+ * @brief VTXTransport backend for POSIX ttys (USB-UART adapters, ptys)
+ *
+ * Host-only. All I/O is non-blocking; waits are done with poll() so an
+ * event loop can drive many ports from a single thread.
+ */
+
+#ifndef POSIXSERIALTRANSPORT_H
+#define POSIXSERIALTRANSPORT_H
+
+#include "VTXTransport.h"
+
+#if !defined(ARDUINO) && !defined(ESP_PLATFORM) && (defined(__unix__) || defined(__APPLE__))
+
+#define VTX_POSIX_SERIAL_TRANSPORT 1
+
+#define VTX_POSIX_PATH_MAX      64
+#define VTX_POSIX_FLUSH_SLACK_MS 50     // Added to the computed wire time in flush()
+
+class PosixSerialTransport : public VTXTransport {
+public:
+    /**
+     * @param path Device path (e.g. "/dev/ttyUSB0"), may be nullptr for ptys
+     */
+    explicit PosixSerialTransport(const char* path = nullptr);
+    ~PosixSerialTransport();
+
+    void setPath(const char* path);
+
+    bool open() override;
+    void close() override;
+    bool configure(uint32_t baud, VTXFraming framing) override;
+    int available() override;
+    size_t read(uint8_t* buf, size_t len) override;
+    size_t write(const uint8_t* buf, size_t len) override;
+    size_t txPending() override;
+    void flush() override;
+
+    /**
+     * @brief Wait until data is readable
+     * @param timeoutMs Maximum wait, -1 for infinite
+     * @return true if data is available
+     */
+    bool waitReadable(int timeoutMs);
+
+    /**
+     * @return File descriptor for use in an external poll() set, -1 if closed
+     */
+    int fd() const { return _fd; }
+
+    const char* path() const { return _path; }
+
+    /**
+     * @brief Create a connected pseudo-terminal pair
+     *
+     * Bytes written to one end can be read from the other, which lets a
+     * protocol engine and an emulated VTX talk without hardware.
+     *
+     * @param host Receives the master side
+     * @param device Receives the slave side
+     * @return true on success
+     */
+    static bool openPtyPair(PosixSerialTransport& host, PosixSerialTransport& device);
+
+private:
+    int _fd = -1;
+    uint32_t _baud = 0;
+    char _path[VTX_POSIX_PATH_MAX];
+
+    static bool makeRaw(int fd);
+};
+
+#endif
+
+#endif // POSIXSERIALTRANSPORT_H
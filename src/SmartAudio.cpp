@@ -8,68 +8,81 @@
 
 #include "SmartAudio.h"
 
-#define CRC8_POLY           0xD5
-#define SA_FREQ_GETPIT      0x4000
+#if BETAVTX_ENABLE_SMARTAUDIO
+
+#if BETAVTX_ENABLE_STATS
+#define SA_COUNT(counter)   (_stats.counter++)
+#else
+#define SA_COUNT(counter)   ((void)0)
+#endif
+
 #define SA_POWER_MASK       0x7F
 #define SA_POWER_IN_RANGE   0x80
 #define SA_DATA_HEADER_SIZE 4
 
+// Nominal mW for each power index, inverse of powerMwToIndex()
+static const uint16_t saPowerIndexMw[] = { 25, 200, 400, 600, 800 };
+#define SA_POWER_INDEX_COUNT (sizeof(saPowerIndexMw) / sizeof(saPowerIndexMw[0]))
+
 SmartAudioVTX::SmartAudioVTX() {
-    memset(&_stats, 0, sizeof(_stats));
 }
 
 SmartAudioVTX::~SmartAudioVTX() {
-    if (_serial) {
-        _serial->end();
+    if (_transport) {
+#if BETAVTX_ENABLE_RX
+        // Before the parser goes away under a running receive callback
+        setEventDrivenRx(false);
+#endif
+        _transport->close();
     }
 }
 
-bool SmartAudioVTX::begin(HardwareSerial* serial, uint8_t txPin, HardwareSerial* debugSerial) {
-    if (!serial) {
-        return false;
-    }
-    
-    _serial = serial;
-    _txPin = txPin;
-    _debugSerial = debugSerial;
-    
-    // TX-only mode: configure serial with TX pin only
+bool SmartAudioVTX::start() {
     // Fixed baud rate 4800 as per Betaflight/esp-fc
     _currentBaud = VTX_SMARTAUDIO_BAUD_4800;
-    if (_serial) {
-        _serial->end();
+    if (!openTransport(_currentBaud, VTX_FRAMING_8N2)) {
+        return false;
     }
-    _serial->setTxBufferSize(VTX_TX_BUFFER_SIZE);
-    _serial->begin(_currentBaud, SERIAL_8N2, -1, txPin);  // RX=-1 (not used)
     
-    _initPhase = INIT_START;
+    resetDevice(VTX_DEVICE_SMARTAUDIO);
+    setInitPhase(INIT_START);
+    _responseTimeoutMs = SA_CMD_TIMEOUT;
+#if BETAVTX_ENABLE_RX
+    _sendMask = 0;
+#endif
     
     // In TX-only mode, we're ready immediately after begin()
     _isReady = true;
     
-    if (_debugSerial) {
-        _debugSerial->println("[SmartAudio] Debug enabled");
-    }
+    debugPrintln("[SmartAudio] Debug enabled");
     
     return true;
 }
 
 void SmartAudioVTX::update() {
-    if (!_serial) {
+    if (!_transport) {
         return;
     }
     
-    while (_serial->available() > 0) {
-        uint8_t c = _serial->read();
-        receiveChar(c);
+    // Line kept idle for a scheduled command: replies are still handled, nothing new is sent
+    const bool holding = serviceSchedule();
+    
+#if BETAVTX_ENABLE_RX
+    serviceRx();
+    // Out of budget: handshake, retries and polling wait for the next call
+    if (budgetSpent()) {
+        return;
     }
     
     // No auto-baud in TX-only mode (fixed 4800 baud)
     
     switch (_initPhase) {
         case INIT_START:
-            getSettings();
-            _initPhase = INIT_WAIT_SETTINGS;
+            // A safe boot pit-on from begin() has already queued the readback
+            if (_queueHead == _queueTail) {
+                getSettings();
+            }
+            setInitPhase(INIT_WAIT_SETTINGS);
             break;
             
         case INIT_WAIT_SETTINGS:
@@ -82,20 +95,22 @@ void SmartAudioVTX::update() {
                         (uint8_t)(getPitFreq >> 8), (uint8_t)(getPitFreq & 0xFF),
                         0
                     };
-                    buf[6] = calculateCRC8(buf, 6);
+                    buf[6] = SmartAudioParser::crc8(buf, 6);
                     queueCommand(buf, 7);
-                    _initPhase = INIT_WAIT_PITFREQ;
+                    setInitPhase(INIT_WAIT_PITFREQ);
                 } else {
-                    _initPhase = INIT_DONE;
+                    setInitPhase(INIT_DONE);
                     _isReady = true;
+                    linkReady(mismatchedSettings());
                 }
             }
             break;
             
         case INIT_WAIT_PITFREQ:
             if (_saPitFreq > 0) {
-                _initPhase = INIT_DONE;
+                setInitPhase(INIT_DONE);
                 _isReady = true;
+                linkReady(mismatchedSettings());
             }
             break;
             
@@ -104,17 +119,44 @@ void SmartAudioVTX::update() {
             break;
     }
     
+    serviceCommands();
+    if (budgetSpent()) {
+        return;
+    }
+    
     unsigned long now = millis();
     
-    if (_outstandingCmd != SA_CMD_NONE && (now - _lastTransmission > SA_CMD_TIMEOUT)) {
-        sendQueue();
+    if (_outstandingCmd != SA_CMD_NONE && (now - _lastTransmission > cmdTimeoutMs())) {
+        // Reply lost. Keep querying, or a silent device (e.g. one that
+        // needs more dummy bytes than its profile sends) would stall the link
+        _outstandingCmd = SA_CMD_NONE;
+        if (_queueHead == _queueTail && _sendMask == 0) {
+            if (_initPhase == INIT_WAIT_PITFREQ) {
+                setInitPhase(INIT_WAIT_SETTINGS);
+            }
+            getSettings();
+        }
+    }
+    
+    // Half duplex: anything sent before the reply (or its timeout) would collide with it
+    if (holding || (_outstandingCmd != SA_CMD_NONE && _transport->hasRx())) {
+        // Waiting
+    } else if (_sendMask != 0) {
+        sendPendingConfig();
     } else if (_queueHead != _queueTail) {
         sendQueue();
     } else if (_initPhase == INIT_DONE && 
-               (now - _lastCommand >= SA_POLLING_INTERVAL)) {
+               (now - _lastCommand >= _profile->pollIntervalMs)) {
         getSettings();
         sendQueue();
     }
+#else
+    // TX-only build: set commands go out directly, nothing to poll or confirm
+    (void)holding;
+    serviceCommands();
+#endif
+    
+    resumeCommandWaiters();
 }
 
 bool SmartAudioVTX::isReady() {
@@ -123,19 +165,27 @@ bool SmartAudioVTX::isReady() {
 }
 
 bool SmartAudioVTX::setFrequency(uint16_t freq) {
-    uint8_t buf[7] = {
-        SA_PREAMBLE_1, SA_PREAMBLE_2,
-        (uint8_t)(SA_CMD_SET_FREQ << 1 | 1), 2,
-        (uint8_t)(freq >> 8), (uint8_t)(freq & 0xFF),
-        0
-    };
-    buf[6] = calculateCRC8(buf, 6);
+    uint8_t buf[7];
+    const uint8_t len = buildSetFrequency(freq, buf);
+    
+    _desiredFreq = freq;
+    _desiredChannel = SA_CHANNEL_NONE;
     
     // In TX-only mode, send immediately
-    sendFrame(buf, 7);
+    sendTracked(VTX_FIELD_FREQUENCY, buf, len);
     return true;
 }
 
+uint8_t SmartAudioVTX::encodeFrequencyFrame(uint16_t freq, uint8_t* buf, uint8_t maxLen) {
+    const uint8_t dummies = dummyBytes();
+    if (maxLen < dummies + 7) {
+        return 0;
+    }
+    
+    memset(buf, 0, dummies);
+    return dummies + buildSetFrequency(freq, buf + dummies);
+}
+
 bool SmartAudioVTX::setPower(uint16_t power) {
     // Convert milliwatts to power index
     // SmartAudio uses power index (0-4), not direct mW
@@ -152,10 +202,12 @@ bool SmartAudioVTX::setPowerByIndex(uint8_t index) {
         index,
         0
     };
-    buf[5] = calculateCRC8(buf, 5);
+    buf[5] = SmartAudioParser::crc8(buf, 5);
+    
+    _desiredPowerIndex = index;
     
     // In TX-only mode, send immediately
-    sendFrame(buf, 6);
+    sendTracked(VTX_FIELD_POWER, buf, 6);
     return true;
 }
 
@@ -163,25 +215,43 @@ bool SmartAudioVTX::setPitMode(bool enable) {
     // Note: Pit mode requires SmartAudio v2+, but in TX-only mode we can't check version
     // User should know their VTX supports this feature
     
-    uint8_t mode = enable ? SA_MODE_SET_IN_RANGE : SA_MODE_CLR_PITMODE;
+    uint8_t buf[6];
+    const uint8_t len = buildSetMode(enable ? SA_MODE_SET_IN_RANGE : SA_MODE_CLR_PITMODE, buf);
     
-    uint8_t buf[6] = {
-        SA_PREAMBLE_1, SA_PREAMBLE_2,
-        (uint8_t)(SA_CMD_SET_MODE << 1 | 1), 1,
-        mode,
-        0
-    };
-    buf[5] = calculateCRC8(buf, 5);
+    _desiredPitMode = enable;
     
     // In TX-only mode, send immediately
-    sendFrame(buf, 6);
+    sendTracked(VTX_FIELD_PIT_MODE, buf, len);
     return true;
 }
 
+uint8_t SmartAudioVTX::encodePitModeFrame(bool enable, uint8_t* buf, uint8_t maxLen) {
+    const uint8_t dummies = dummyBytes();
+    if (maxLen < dummies + 6) {
+        return 0;
+    }
+    
+    memset(buf, 0, dummies);
+    return dummies + buildSetMode(enable ? SA_MODE_SET_IN_RANGE : SA_MODE_CLR_PITMODE, buf + dummies);
+}
+
 bool SmartAudioVTX::setBandAndChannel(uint8_t band, uint8_t channel) {
-    if (band < VTX_MIN_BAND || band > VTX_MAX_BAND || 
-        channel < VTX_MIN_CHANNEL || channel > VTX_MAX_CHANNEL) {
-        return false;
+    uint16_t freq;
+    if (_vtxTable) {
+        freq = _vtxTable->frequency(band, channel);
+        if (freq == 0) {
+            return false;
+        }
+        // Custom bands and bands beyond the built-in table go by frequency
+        if (!_vtxTable->isFactoryBand(band) || band > VTX_MAX_BAND || channel > VTX_MAX_CHANNEL) {
+            return setFrequency(freq);
+        }
+    } else {
+        if (band < VTX_MIN_BAND || band > VTX_MAX_BAND || 
+            channel < VTX_MIN_CHANNEL || channel > VTX_MAX_CHANNEL) {
+            return false;
+        }
+        freq = vtxBandChannelToFrequency(band, channel);
     }
     
     // Convert to device channel value (0-39)
@@ -193,16 +263,26 @@ bool SmartAudioVTX::setBandAndChannel(uint8_t band, uint8_t channel) {
         chval,
         0
     };
-    buf[5] = calculateCRC8(buf, 5);
+    buf[5] = SmartAudioParser::crc8(buf, 5);
+    
+    _desiredChannel = chval;
+    _desiredFreq = freq;
     
     // In TX-only mode, send immediately
-    sendFrame(buf, 6);
+    sendTracked(VTX_FIELD_FREQUENCY, buf, 6);
     return true;
 }
 
 // ===== Private Methods =====
 
 uint8_t SmartAudioVTX::powerMwToIndex(uint16_t powerMw) {
+    if (_vtxTable) {
+        const uint8_t level = _vtxTable->findPowerLevel(powerMw);
+        if (level) {
+            return (uint8_t)_vtxTable->powerValue(level);
+        }
+    }
+    
     // Convert milliwatts to SmartAudio power index
     // Common power levels: 25mW=0, 200mW=1, 400mW=2, 600mW=3, 800mW=4
     // This is a best-effort mapping for TX-only mode
@@ -214,42 +294,209 @@ uint8_t SmartAudioVTX::powerMwToIndex(uint16_t powerMw) {
     return 4;                          // 800mW or 1W+
 }
 
-uint8_t SmartAudioVTX::calculateCRC8(const uint8_t* data, uint8_t len) {
-    uint8_t crc = 0;
-    
-    for (uint8_t i = 0; i < len; i++) {
-        crc ^= data[i];
-        for (uint8_t j = 0; j < 8; j++) {
-            if (crc & 0x80) {
-                crc = (crc << 1) ^ CRC8_POLY;
-            } else {
-                crc <<= 1;
-            }
-        }
-    }
-    
-    return crc;
+uint8_t SmartAudioVTX::buildSetFrequency(uint16_t freq, uint8_t* buf) {
+    buf[0] = SA_PREAMBLE_1;
+    buf[1] = SA_PREAMBLE_2;
+    buf[2] = (uint8_t)(SA_CMD_SET_FREQ << 1 | 1);
+    buf[3] = 2;
+    buf[4] = (uint8_t)(freq >> 8);
+    buf[5] = (uint8_t)(freq & 0xFF);
+    buf[6] = SmartAudioParser::crc8(buf, 6);
+    return 7;
 }
 
-void SmartAudioVTX::sendFrame(uint8_t* buf, uint8_t len) {
-    if (!_serial) {
+uint8_t SmartAudioVTX::buildSetMode(uint8_t mode, uint8_t* buf) {
+    buf[0] = SA_PREAMBLE_1;
+    buf[1] = SA_PREAMBLE_2;
+    buf[2] = (uint8_t)(SA_CMD_SET_MODE << 1 | 1);
+    buf[3] = 1;
+    buf[4] = mode;
+    buf[5] = SmartAudioParser::crc8(buf, 5);
+    return 6;
+}
+
+void SmartAudioVTX::sendFrame(const uint8_t* buf, uint8_t len) {
+    if (!_transport) {
         return;
     }
     
     // Debug output
     debugPrintHex(buf, len, "SmartAudio");
+    recordTx(buf, len);
     
-    // Send dummy byte for UART stabilization (as per esp-fc implementation)
-    static const uint8_t dummyByte = 0x00;
-    _serial->write(&dummyByte, 1);
-    _serial->write(&dummyByte, 1);
+    // Send dummy bytes for UART stabilization (as per esp-fc implementation),
+    // as many as the device profile asks for
+    static const uint8_t zeros[VTX_MAX_DUMMY_BYTES] = {};
+    const uint8_t dummies = dummyBytes();
+    _transport->write(zeros, dummies);
     
     // Send frame
-    _serial->write(buf, len);
-    _serial->flush();
+    _transport->write(buf, len);
+    finishTx();
     
-    _stats.packetsSent++;
+    SA_COUNT(packetsSent);
     _lastTransmission = millis();
+    rttRequestSent(dummies + len);
+}
+
+#if BETAVTX_ENABLE_RX
+SmartAudioVTX::Command& SmartAudioVTX::pendingCommand(VTXStateField field) {
+    switch (field) {
+        case VTX_FIELD_FREQUENCY:   return _pendingCmds[0];
+        case VTX_FIELD_POWER:       return _pendingCmds[1];
+        default:                    return _pendingCmds[2];
+    }
+}
+
+void SmartAudioVTX::sendPendingConfig() {
+    // One request on the line at a time; TX-only links never answer
+    if (_sendMask == 0 || scheduleHold() || (_outstandingCmd != SA_CMD_NONE && _transport->hasRx())) {
+        return;
+    }
+    
+    static const VTXStateField order[] = { VTX_FIELD_FREQUENCY, VTX_FIELD_POWER, VTX_FIELD_PIT_MODE };
+    for (uint8_t i = 0; i < sizeof(order) / sizeof(order[0]); i++) {
+        const VTXStateField field = order[i];
+        if (!(_sendMask & field)) {
+            continue;
+        }
+        _sendMask &= ~field;
+        
+        Command& pending = pendingCommand(field);
+        sendFrame(pending.buffer, pending.length);
+        commandSent(field);
+        _outstandingCmd = pending.buffer[2] >> 1;
+        _lastCommand = millis();
+        
+        // Read the settings back right after the reply so confirmation doesn't wait for the next poll
+        if (_queueHead == _queueTail) {
+            getSettings();
+        }
+        return;
+    }
+}
+#endif
+
+void SmartAudioVTX::sendTracked(VTXStateField field, const uint8_t* buf, uint8_t len) {
+#if BETAVTX_ENABLE_RX
+    Command& pending = pendingCommand(field);
+    memcpy(pending.buffer, buf, len);
+    pending.length = len;
+    
+    beginCommand(field);
+    
+    // Goes out now unless a reply is outstanding; update() picks it up then
+    _sendMask |= field;
+    sendPendingConfig();
+#else
+    // Finishes as unconfirmed, so there is nothing to keep for retries
+    beginCommand(field);
+    sendFrame(buf, len);
+#endif
+}
+
+void SmartAudioVTX::scheduledCommandSent(VTXStateField field, uint16_t value, uint8_t len) {
+    SA_COUNT(packetsSent);
+    _lastTransmission = millis();
+    rttRequestSent(len);
+    
+    if (field == VTX_FIELD_FREQUENCY) {
+        _desiredFreq = value;
+        _desiredChannel = SA_CHANNEL_NONE;
+    } else {
+        _desiredPitMode = value != 0;
+    }
+    beginCommand(field);
+    
+#if BETAVTX_ENABLE_RX
+    // Kept for retries, without the dummy bytes
+    Command& pending = pendingCommand(field);
+    pending.length = (field == VTX_FIELD_FREQUENCY)
+        ? buildSetFrequency(value, pending.buffer)
+        : buildSetMode(value ? SA_MODE_SET_IN_RANGE : SA_MODE_CLR_PITMODE, pending.buffer);
+    commandSent(field);
+    _sendMask &= ~field;
+    _outstandingCmd = pending.buffer[2] >> 1;
+    _lastCommand = millis();
+    
+    if (_queueHead == _queueTail) {
+        getSettings();
+    }
+#endif
+}
+
+void SmartAudioVTX::requestedFrequency(uint16_t freq) {
+    _desiredFreq = freq;
+    _desiredChannel = SA_CHANNEL_NONE;
+    
+#if BETAVTX_ENABLE_RX
+    // What restoreSettings() sends after a link-down
+    Command& pending = pendingCommand(VTX_FIELD_FREQUENCY);
+    pending.length = buildSetFrequency(freq, pending.buffer);
+#endif
+}
+
+void SmartAudioVTX::resendCommand(VTXStateField field) {
+#if BETAVTX_ENABLE_RX
+    _sendMask |= field;
+    sendPendingConfig();
+#else
+    (void)field;
+#endif
+}
+
+void SmartAudioVTX::linkLost() {
+#if BETAVTX_ENABLE_RX
+    // Probe from scratch; the timeout path in update() re-sends until it answers
+    setInitPhase(INIT_START);
+    _saVersion = 0;
+    _saPitFreq = 0;
+    _queueHead = _queueTail = 0;
+    _outstandingCmd = SA_CMD_NONE;
+#endif
+}
+
+void SmartAudioVTX::restoreSettings(uint8_t fields) {
+#if BETAVTX_ENABLE_RX
+    static const VTXStateField order[] = { VTX_FIELD_FREQUENCY, VTX_FIELD_POWER, VTX_FIELD_PIT_MODE };
+    for (uint8_t i = 0; i < sizeof(order) / sizeof(order[0]); i++) {
+        if (fields & order[i]) {
+            // sendTracked() copies into the pending slot, don't hand it its own buffer
+            const Command cmd = pendingCommand(order[i]);
+            sendTracked(order[i], cmd.buffer, cmd.length);
+        }
+    }
+#else
+    (void)fields;
+#endif
+}
+
+#if BETAVTX_ENABLE_RX
+
+uint8_t SmartAudioVTX::mismatchedSettings() const {
+    uint8_t fields = 0;
+    if (_state.frequency != _desiredFreq) {
+        fields |= VTX_FIELD_FREQUENCY;
+    }
+    if (_state.powerIndex != _desiredPowerIndex) {
+        fields |= VTX_FIELD_POWER;
+    }
+    if (_state.pitMode != _desiredPitMode) {
+        fields |= VTX_FIELD_PIT_MODE;
+    }
+    return fields;
+}
+
+void SmartAudioVTX::confirmSettings() {
+    if (commandPending(VTX_FIELD_FREQUENCY) && _state.frequency == _desiredFreq) {
+        finishCommand(VTX_FIELD_FREQUENCY, VTX_RESULT_CONFIRMED);
+    }
+    if (commandPending(VTX_FIELD_POWER) && _state.powerIndex == _desiredPowerIndex) {
+        finishCommand(VTX_FIELD_POWER, VTX_RESULT_CONFIRMED);
+    }
+    if (commandPending(VTX_FIELD_PIT_MODE) && _state.pitMode == _desiredPitMode) {
+        finishCommand(VTX_FIELD_PIT_MODE, VTX_RESULT_CONFIRMED);
+    }
 }
 
 void SmartAudioVTX::queueCommand(uint8_t* buf, uint8_t len) {
@@ -282,31 +529,34 @@ void SmartAudioVTX::getSettings() {
         (uint8_t)(SA_CMD_GET_SETTINGS << 1 | 1), 0,
         0
     };
-    buf[4] = calculateCRC8(buf, 4);
+    buf[4] = SmartAudioParser::crc8(buf, 4);
     
     queueCommand(buf, 5);
 }
 
 void SmartAudioVTX::setMode(uint8_t mode) {
-    uint8_t buf[6] = {
-        SA_PREAMBLE_1, SA_PREAMBLE_2,
-        (uint8_t)(SA_CMD_SET_MODE << 1 | 1), 1,
-        mode,
-        0
-    };
-    buf[5] = calculateCRC8(buf, 5);
-    
-    queueCommand(buf, 6);
+    uint8_t buf[6];
+    queueCommand(buf, buildSetMode(mode, buf));
 }
 
-void SmartAudioVTX::processResponse(uint8_t* buf, uint8_t len) {
+void SmartAudioVTX::processResponse(const uint8_t* buf, uint8_t len) {
     if (len < (SA_DATA_HEADER_SIZE + 1)) {
         return;
     }
     
+    // Our own request echoed on a single-wire link (a SET_FREQ echo looks like a
+    // v2 settings reply by its command byte); it must not release the next command
+    const uint8_t header[4] = { SA_PREAMBLE_1, SA_PREAMBLE_2, buf[0], buf[1] };
+    if (SmartAudioParser::isRequest(header)) {
+        return;
+    }
+    
     const uint8_t cmd = buf[0];
     _outstandingCmd = SA_CMD_NONE;
     
+    // Follow the measured round trip for subsequent attempts
+    _responseTimeoutMs = cmdTimeoutMs();
+    
     switch (cmd) {
         case SA_CMD_GET_SETTINGS:
         case SA_CMD_GET_SETTINGS_V2:
@@ -319,83 +569,139 @@ void SmartAudioVTX::processResponse(uint8_t* buf, uint8_t len) {
             _saPower = buf[3] & SA_POWER_MASK;
             _saMode = buf[4];
             _saFreq = (buf[5] << 8) | buf[6];
+            readDeviceInfo(buf);
+            
+            SA_COUNT(packetsReceived);
+            rttResponseReceived();
+            publishSettings();
+            confirmSettings();
+            recordTelemetry(VTX_METRIC_POWER, _state.power);
+            break;
+            
+        case SA_CMD_SET_POWER:
+            rttResponseReceived();
+            if (buf[2] == _desiredPowerIndex && commandPending(VTX_FIELD_POWER)) {
+                finishCommand(VTX_FIELD_POWER, VTX_RESULT_CONFIRMED);
+            }
+            break;
             
-            _stats.packetsReceived++;
+        case SA_CMD_SET_CHAN:
+            rttResponseReceived();
+            if (buf[2] == _desiredChannel && commandPending(VTX_FIELD_FREQUENCY)) {
+                finishCommand(VTX_FIELD_FREQUENCY, VTX_RESULT_CONFIRMED);
+            }
             break;
             
         case SA_CMD_SET_FREQ:
             if (len < 5) break;
+            rttResponseReceived();
             {
                 const uint16_t freq = (buf[2] << 8) | buf[3];
                 if (freq & SA_FREQ_GETPIT) {
                     _saPitFreq = freq & 0x3FFF;
+                } else if (freq == _desiredFreq && commandPending(VTX_FIELD_FREQUENCY)) {
+                    finishCommand(VTX_FIELD_FREQUENCY, VTX_RESULT_CONFIRMED);
                 }
             }
             break;
             
+        case SA_CMD_SET_MODE:
+            // Confirmed by the settings readback
+            rttResponseReceived();
+            break;
+            
         default:
             break;
     }
 }
 
-void SmartAudioVTX::receiveChar(uint8_t c) {
-    switch (_rxState) {
-        case WAIT_PREAMBLE_1:
-            if (c == SA_PREAMBLE_1) {
-                _rxBuffer[0] = c;
-                _rxPos = 1;
-                _rxState = WAIT_PREAMBLE_2;
-            }
-            break;
-            
-        case WAIT_PREAMBLE_2:
-            if (c == SA_PREAMBLE_2) {
-                _rxBuffer[_rxPos++] = c;
-                _rxState = WAIT_COMMAND;
-            } else {
-                _stats.badPreamble++;
-                _rxState = WAIT_PREAMBLE_1;
-            }
-            break;
-            
-        case WAIT_COMMAND:
-            _rxBuffer[_rxPos++] = c;
-            _rxCommand = c;
-            _rxState = WAIT_LENGTH;
+void SmartAudioVTX::readDeviceInfo(const uint8_t* buf) {
+    _device.saVersion = _saVersion;
+    
+    // v2.1 appends the current dBm, the highest power index and one dBm value per index
+    const uint8_t payloadLen = buf[1];
+    if (_saVersion < 3 || payloadLen < 8) {
+        return;
+    }
+    uint8_t levels = buf[8] + 1;
+    if (levels > VTX_DEVICE_MAX_POWER_LEVELS) {
+        levels = VTX_DEVICE_MAX_POWER_LEVELS;
+    }
+    if (payloadLen < 7 + levels) {
+        levels = payloadLen - 7;
+    }
+    for (uint8_t i = 0; i < levels; i++) {
+        _device.powerDbm[i] = buf[9 + i];
+    }
+    _device.powerLevels = levels;
+}
+
+uint32_t SmartAudioVTX::cmdTimeoutMs() const {
+    return _rtt.timeoutUs(_profile->timeoutMinMs * 1000UL, _profile->timeoutMaxMs * 1000UL,
+                          SA_CMD_TIMEOUT * 1000UL) / 1000;
+}
+
+void SmartAudioVTX::publishSettings() {
+    VTXState state = _state;
+    
+    if (_saMode & SA_MODE_GET_FREQ_MODE) {
+        state.frequency = _saFreq;
+    } else if (_saChannel < VTX_MAX_BAND * VTX_MAX_CHANNEL) {
+        // Channel mode: resolve through the loaded vtxtable, else the default bands (A, B, E, F, R)
+        const uint8_t band = _saChannel / VTX_MAX_CHANNEL;
+        const uint8_t channel = _saChannel % VTX_MAX_CHANNEL;
+        const uint16_t freq = _vtxTable ? _vtxTable->frequency(band + 1, channel + 1) : 0;
+        state.frequency = freq ? freq : vtxDefaultFrequencyTable[band][channel];
+    }
+    
+    state.powerIndex = _saPower;
+    const uint8_t level = _vtxTable ? _vtxTable->findPowerValue(_saPower) : 0;
+    if (level && _vtxTable->powerMw(level)) {
+        state.power = _vtxTable->powerMw(level);
+    } else {
+        state.power = saPowerIndexMw[_saPower < SA_POWER_INDEX_COUNT ? _saPower : SA_POWER_INDEX_COUNT - 1];
+    }
+    state.pitMode = (_saMode & SA_MODE_GET_PITMODE) != 0;
+    
+    publishState(state);
+}
+
+uint8_t SmartAudioVTX::parseRxByte(uint8_t c, VTXRxFrame& frame) {
+    const uint8_t event = _parser.feed(c);
+    if (event == VTX_RX_FRAME) {
+        // Command onwards, as processResponse() expects it
+        frame.len = _parser.frameLength() - 2;
+        memcpy(frame.data, _parser.frame() + 2, frame.len);
+    }
+    return event;
+}
+
+void SmartAudioVTX::resetRxParser() {
+    _parser.reset();
+}
+
+void SmartAudioVTX::handleRxFrame(const VTXRxFrame& frame) {
+    switch (frame.event) {
+        case VTX_RX_FRAME:
+            processResponse(frame.data, frame.len);
             break;
             
-        case WAIT_LENGTH:
-            _rxBuffer[_rxPos++] = c;
-            _rxLength = c;
-            if (_rxLength == 0) {
-                _rxState = WAIT_CRC;
-            } else if (_rxLength > SA_MAX_PACKET_LEN - SA_DATA_HEADER_SIZE - 1) {
-                _stats.badLength++;
-                _rxState = WAIT_PREAMBLE_1;
-            } else {
-                _rxState = WAIT_DATA;
-            }
+        case SA_RX_BAD_PREAMBLE:
+            SA_COUNT(badPreamble);
             break;
             
-        case WAIT_DATA:
-            _rxBuffer[_rxPos++] = c;
-            if (_rxPos >= SA_DATA_HEADER_SIZE + _rxLength) {
-                _rxState = WAIT_CRC;
-            }
+        case SA_RX_BAD_LENGTH:
+            SA_COUNT(badLength);
+            recordTelemetry(VTX_METRIC_LINK_ERRORS, VTX_TELEMETRY_ERROR);
             break;
             
-        case WAIT_CRC:
-            _rxBuffer[_rxPos++] = c;
-            
-            const uint8_t crc = calculateCRC8(_rxBuffer, _rxPos - 1);
-            if (crc == c) {
-                processResponse(_rxBuffer + 2, _rxPos - 2);
-            } else {
-                _stats.crcErrors++;
-            }
-            
-            _rxState = WAIT_PREAMBLE_1;
-            _rxPos = 0;
+        case SA_RX_BAD_CRC:
+            SA_COUNT(crcErrors);
+            recordTelemetry(VTX_METRIC_LINK_ERRORS, VTX_TELEMETRY_ERROR);
             break;
     }
 }
+
+#endif // BETAVTX_ENABLE_RX
+
+#endif // BETAVTX_ENABLE_SMARTAUDIO
@@ -10,18 +10,14 @@
 #define SMARTAUDIO_H
 
 #include "VTXProtocol.h"
+#include "VTXBandTable.h"
+#include "VTXTable.h"
+#include "VTXFrameParser.h"
 
 // Fixed baud rate as per Betaflight/esp-fc (no auto-baud in TX-only mode)
 #define VTX_SMARTAUDIO_BAUD_4800    4800
-#define VTX_TX_BUFFER_SIZE          255
 
-// Band and channel constants for setBandAndChannel()
-#define VTX_MIN_BAND        1
-#define VTX_MAX_BAND        5
-#define VTX_MIN_CHANNEL     1
-#define VTX_MAX_CHANNEL     8
-
-#define SA_MAX_PACKET_LEN   21
+#define SA_DUMMY_BYTES      2       // Zero bytes sent ahead of every frame (conservative profile)
 
 #define SA_CMD_NONE         0x00
 #define SA_CMD_GET_SETTINGS 0x01
@@ -32,9 +28,6 @@
 #define SA_CMD_GET_SETTINGS_V2  0x09
 #define SA_CMD_GET_SETTINGS_V21 0x11
 
-#define SA_PREAMBLE_1       0xAA
-#define SA_PREAMBLE_2       0x55
-
 #define SA_MODE_GET_PITMODE     0x02
 #define SA_MODE_GET_IN_RANGE    0x04
 #define SA_MODE_GET_OUT_RANGE   0x08
@@ -46,29 +39,38 @@
 #define SA_MODE_CLR_PITMODE     0x04
 #define SA_MODE_SET_UNLOCK      0x08
 
-#define SA_CMD_TIMEOUT          120
-#define SA_POLLING_INTERVAL     150
+#define SA_FREQ_GETPIT          0x4000  // SET_FREQ flag: query the pit frequency instead
+
+#define SA_CMD_TIMEOUT          120     // Initial response timeout until RTT samples exist
+#define SA_CMD_TIMEOUT_MIN      40      // Clamps for the RTT derived timeout (conservative profile)
+#define SA_CMD_TIMEOUT_MAX      300
+#define SA_POLLING_INTERVAL     150     // Settings poll period (conservative profile)
 #define SA_POLLING_WINDOW       1000
 
-#define SA_QUEUE_SIZE           4
-#define SA_MAX_CMD_BUF_SIZE     32
+#define SA_QUEUE_SIZE           BETAVTX_SA_QUEUE_SIZE
+#define SA_CHANNEL_NONE         0xFF    // Desired frequency set directly, not by channel
+#define SA_MAX_CMD_BUF_SIZE     8       // Largest frame we build is SET_FREQ, 7 bytes
+
+#if BETAVTX_ENABLE_SMARTAUDIO
 
 class SmartAudioVTX : public VTXProtocol {
 public:
     SmartAudioVTX();
     ~SmartAudioVTX();
     
-    bool begin(HardwareSerial* serial, uint8_t txPin, HardwareSerial* debugSerial = nullptr) override;
+    using VTXProtocol::update;
     void update() override;
     bool isReady() override;
     bool setFrequency(uint16_t freq) override;
     bool setPower(uint16_t power) override;
     bool setPitMode(bool enable) override;
+    uint8_t encodeFrequencyFrame(uint16_t freq, uint8_t* buf, uint8_t maxLen) override;
+    uint8_t encodePitModeFrame(bool enable, uint8_t* buf, uint8_t maxLen) override;
     
     /**
      * @brief Set band and channel
-     * @param band Band number (1-5)
-     * @param channel Channel number (1-8)
+     * @param band Band number (1-5, or as defined by the vtxtable)
+     * @param channel Channel number (1-8, or as defined by the vtxtable)
      * @return true if command sent successfully
      */
     bool setBandAndChannel(uint8_t band, uint8_t channel);
@@ -89,18 +91,42 @@ public:
         uint16_t badPreamble;
     };
     
+#if BETAVTX_ENABLE_STATS
     Statistics getStatistics() { return _stats; }
+#endif
+    
+    /**
+     * @brief Convert milliwatts to the device power index used by setPower()
+     * @param powerMw Power in mW
+     * @return Power index (0-4)
+     */
+    uint8_t powerMwToIndex(uint16_t powerMw);
+    
+    /**
+     * @brief Use a Betaflight vtxtable for band/channel and power lookups
+     *
+     * The table must outlive this object. Without one (or with nullptr)
+     * the default A/B/E/F/R bands and 25-800 mW power steps are used.
+     *
+     * @param table Parsed table, ignored unless valid
+     */
+    void setVtxTable(const VTXTable* table) { _vtxTable = (table && table->isValid()) ? table : nullptr; }
+    const VTXTable* getVtxTable() const { return _vtxTable; }
+
+protected:
+    bool start() override;
+    void scheduledCommandSent(VTXStateField field, uint16_t value, uint8_t len) override;
+    void requestedFrequency(uint16_t freq) override;
+    void resendCommand(VTXStateField field) override;
+    void linkLost() override;
+    void restoreSettings(uint8_t fields) override;
+#if BETAVTX_ENABLE_RX
+    uint8_t parseRxByte(uint8_t c, VTXRxFrame& frame) override;
+    void resetRxParser() override;
+    void handleRxFrame(const VTXRxFrame& frame) override;
+#endif
 
 private:
-    enum ReceiveState {
-        WAIT_PREAMBLE_1,
-        WAIT_PREAMBLE_2,
-        WAIT_COMMAND,
-        WAIT_LENGTH,
-        WAIT_DATA,
-        WAIT_CRC
-    };
-    
     enum InitPhase {
         INIT_START,
         INIT_WAIT_SETTINGS,
@@ -117,12 +143,10 @@ private:
     uint16_t _saPitFreq = 0;   // Pit mode frequency
     uint16_t _currentBaud = VTX_SMARTAUDIO_BAUD_4800;
     
-    ReceiveState _rxState = WAIT_PREAMBLE_1;
     InitPhase _initPhase = INIT_START;
-    uint8_t _rxBuffer[SA_MAX_PACKET_LEN];
-    uint8_t _rxPos = 0;
-    uint8_t _rxLength = 0;
-    uint8_t _rxCommand = 0;
+    
+#if BETAVTX_ENABLE_RX
+    SmartAudioParser _parser;
     
     struct Command {
         uint8_t buffer[SA_MAX_CMD_BUF_SIZE];
@@ -132,21 +156,51 @@ private:
     uint8_t _queueHead = 0;
     uint8_t _queueTail = 0;
     
+    // Last set command per tracked field (frequency, power, pit), kept for retries
+    Command _pendingCmds[VTX_COMMAND_SLOTS];
+    uint8_t _sendMask = 0;      // VTXStateField bits waiting for the outstanding reply
+#endif
+    const VTXTable* _vtxTable = nullptr;
+    uint16_t _desiredFreq = 0;
+    uint8_t _desiredChannel = SA_CHANNEL_NONE;
+    uint8_t _desiredPowerIndex = 0;
+    bool _desiredPitMode = false;
+    
     unsigned long _lastTransmission = 0;
     unsigned long _lastCommand = 0;
     uint8_t _outstandingCmd = SA_CMD_NONE;
     
+#if BETAVTX_ENABLE_STATS
     Statistics _stats = {0, 0, 0, 0, 0};
+#endif
     
-    uint8_t powerMwToIndex(uint16_t powerMw);
-    uint8_t calculateCRC8(const uint8_t* data, uint8_t len);
-    void sendFrame(uint8_t* buf, uint8_t len);
+    void setInitPhase(InitPhase phase) {
+        if (phase != _initPhase) {
+            recordEvent(VTX_REC_PHASE, phase, _initPhase);
+            _initPhase = phase;
+        }
+    }
+    
+    uint8_t buildSetFrequency(uint16_t freq, uint8_t* buf);
+    uint8_t buildSetMode(uint8_t mode, uint8_t* buf);
+    void sendFrame(const uint8_t* buf, uint8_t len);
+    void sendTracked(VTXStateField field, const uint8_t* buf, uint8_t len);
+#if BETAVTX_ENABLE_RX
+    Command& pendingCommand(VTXStateField field);
+    void sendPendingConfig();
+    void confirmSettings();
     void queueCommand(uint8_t* buf, uint8_t len);
     void sendQueue();
-    void processResponse(uint8_t* buf, uint8_t len);
-    void receiveChar(uint8_t c);
+    void processResponse(const uint8_t* buf, uint8_t len);
     void getSettings();
     void setMode(uint8_t mode);
+    void publishSettings();
+    void readDeviceInfo(const uint8_t* buf);
+    uint8_t mismatchedSettings() const;
+    uint32_t cmdTimeoutMs() const;
+#endif
 };
 
+#endif // BETAVTX_ENABLE_SMARTAUDIO
+
 #endif // SMARTAUDIO_H
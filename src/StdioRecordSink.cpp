@@ -0,0 +1,55 @@
+/**
+ * @file StdioRecordSink.cpp
+ * @brief Flight recorder sink writing plain files with stdio
+ */
+
+#include "StdioRecordSink.h"
+
+#ifndef ARDUINO
+
+StdioRecordSink::StdioRecordSink(const char* prefix, uint8_t slots)
+    : _slots(slots) {
+    strncpy(_prefix, prefix ? prefix : "", sizeof(_prefix) - 1);
+    _prefix[sizeof(_prefix) - 1] = '\0';
+}
+
+StdioRecordSink::~StdioRecordSink() {
+    close();
+}
+
+void StdioRecordSink::slotPath(uint8_t slot, char* buf, size_t len) const {
+    snprintf(buf, len, "%s%u.bin", _prefix, (unsigned)slot);
+}
+
+size_t StdioRecordSink::readSlot(uint8_t slot, uint8_t* buf, size_t len) {
+    char path[VTX_STDIO_RECORD_PATH_MAX + 8];
+    slotPath(slot, path, sizeof(path));
+    FILE* file = fopen(path, "rb");
+    if (!file) {
+        return 0;
+    }
+    const size_t n = fread(buf, 1, len, file);
+    fclose(file);
+    return n;
+}
+
+bool StdioRecordSink::openSlot(uint8_t slot) {
+    close();
+    char path[VTX_STDIO_RECORD_PATH_MAX + 8];
+    slotPath(slot, path, sizeof(path));
+    _file = fopen(path, "wb");
+    return _file != nullptr;
+}
+
+bool StdioRecordSink::write(const uint8_t* buf, size_t len) {
+    return _file && fwrite(buf, 1, len, _file) == len;
+}
+
+void StdioRecordSink::close() {
+    if (_file) {
+        fclose(_file);
+        _file = nullptr;
+    }
+}
+
+#endif // !ARDUINO
@@ -0,0 +1,44 @@
+/**
+ * @file StdioRecordSink.h
+ * @brief Flight recorder sink writing plain files with stdio
+ *
+ * For hosts, and for ESP-IDF builds without Arduino, where LittleFS and
+ * SPIFFS are mounted into the VFS (e.g. prefix "/littlefs/vtxlog"). Slot
+ * n is the file "<prefix><n>.bin"; opening a slot truncates it.
+ */
+
+#ifndef STDIORECORDSINK_H
+#define STDIORECORDSINK_H
+
+#include "VTXRecorder.h"
+
+#define VTX_STDIO_RECORD_PATH_MAX   128
+
+#ifndef ARDUINO
+
+class StdioRecordSink : public VTXRecordSink {
+public:
+    /**
+     * @param prefix Path of the files without slot number and extension
+     * @param slots Files to rotate through
+     */
+    explicit StdioRecordSink(const char* prefix, uint8_t slots = 4);
+    ~StdioRecordSink();
+
+    uint8_t slots() const override { return _slots; }
+    size_t readSlot(uint8_t slot, uint8_t* buf, size_t len) override;
+    bool openSlot(uint8_t slot) override;
+    bool write(const uint8_t* buf, size_t len) override;
+    void close() override;
+
+    void slotPath(uint8_t slot, char* buf, size_t len) const;
+
+private:
+    char _prefix[VTX_STDIO_RECORD_PATH_MAX];
+    uint8_t _slots;
+    FILE* _file = nullptr;
+};
+
+#endif // !ARDUINO
+
+#endif // STDIORECORDSINK_H
@@ -8,132 +8,142 @@
 
 #include "TRAMP.h"
 
+#if BETAVTX_ENABLE_TRAMP
+
 TrampVTX::TrampVTX() {
     memset(_txBuffer, 0, TRAMP_PACKET_SIZE);
-    memset(_rxBuffer, 0, TRAMP_PACKET_SIZE);
 }
 
 TrampVTX::~TrampVTX() {
-    if (_serial) {
-        _serial->end();
+    if (_transport) {
+#if BETAVTX_ENABLE_RX
+        // Before the parser goes away under a running receive callback
+        setEventDrivenRx(false);
+#endif
+        _transport->close();
     }
 }
 
-bool TrampVTX::begin(HardwareSerial* serial, uint8_t txPin, HardwareSerial* debugSerial) {
-    if (!serial) {
-        return false;
-    }
-    
-    _serial = serial;
-    _txPin = txPin;
-    _debugSerial = debugSerial;
-    
-    // TX-only mode: configure serial with TX pin only
+bool TrampVTX::start() {
     // Fixed baud rate 9600 as per TRAMP protocol
-    if (_serial) {
-        _serial->end();
+    if (!openTransport(TRAMP_BAUD, VTX_FRAMING_8N1)) {
+        return false;
     }
-    _serial->setTxBufferSize(VTX_TX_BUFFER_SIZE);
-    _serial->begin(TRAMP_BAUD, SERIAL_8N1, -1, txPin);  // RX=-1 (not used)
     
-    _status = STATUS_OFFLINE;
-    _retryCount = TRAMP_MAX_RETRIES;
+    resetDevice(VTX_DEVICE_TRAMP);
+    setStatus(STATUS_OFFLINE);
+    _sendMask = 0;
+    _batchMask = 0;
+    // Set commands are confirmed by the status query one request gap later
+    _responseTimeoutMs = requestGapUs() / 1000 + replyTimeoutMs();
     
     // In TX-only mode, we're ready immediately after begin()
     _isReady = true;
     
-    if (_debugSerial) {
-        _debugSerial->println("[TRAMP] Debug enabled");
-    }
+    debugPrintln("[TRAMP] Debug enabled");
     
     return true;
 }
 
 void TrampVTX::update() {
-    if (!_serial) {
+    if (!_transport) {
         return;
     }
     
-    const unsigned long now = micros();
+    // Line kept idle for a scheduled command: replies are still handled, nothing new is sent
+    const bool holding = serviceSchedule();
     
+#if BETAVTX_ENABLE_RX
     const char replyCode = receive();
+    // Out of budget: retries and polling wait for the next call
+    if (budgetSpent()) {
+        return;
+    }
+    
+    serviceCommands();
+    sendPendingConfig(false);
+    if (budgetSpent()) {
+        return;
+    }
+    
+    // The state machine answers with queries; the reply code is kept for after the hold
+    if (holding) {
+        resumeCommandWaiters();
+        return;
+    }
+    
+    // Not before the sends above, they move _lastRequest forward
+    const unsigned long now = micros();
     
     switch (_status) {
         case STATUS_OFFLINE:
             if (replyCode == 'r') {
-                _status = STATUS_INIT;
-            } else if (now - _lastRequest >= TRAMP_MIN_REQUEST_PERIOD) {
-                query(TRAMP_CMD_RESET);
+                setStatus(STATUS_INIT);
+            } else if (now - _lastRequest >= requestGapUs()) {
+                // A status reply alone confirms a pending change (e.g. safe boot pit mode),
+                // the handshake can follow
+                query(commandPending(VTX_FIELD_FREQUENCY) || commandPending(VTX_FIELD_POWER) ||
+                      commandPending(VTX_FIELD_PIT_MODE) ? TRAMP_CMD_STATUS : TRAMP_CMD_RESET);
                 _lastRequest = now;
             }
             break;
             
         case STATUS_INIT:
             if (replyCode == 'v') {
-                _status = STATUS_ONLINE_MONITOR_FREQPWRPIT;
+                setStatus(STATUS_ONLINE_MONITOR_FREQPWRPIT);
                 _isReady = true;
-            } else if (now - _lastRequest >= TRAMP_MIN_REQUEST_PERIOD) {
+                linkReady(((_curFreq != _confFreq) ? VTX_FIELD_FREQUENCY : 0) |
+                          ((_curPower != _confPower) ? VTX_FIELD_POWER : 0) |
+                          ((_curPitMode != _confPitMode) ? VTX_FIELD_PIT_MODE : 0));
+            } else if (now - _lastRequest >= requestGapUs()) {
                 query(TRAMP_CMD_STATUS);
                 _lastRequest = now;
             }
             break;
             
         case STATUS_ONLINE_MONITOR_FREQPWRPIT:
-            {
-                bool configNeeded = false;
-                
-                if (_retryCount > 0 && now - _lastRequest >= TRAMP_MIN_REQUEST_PERIOD) {
-                    if (!isRaceLocked() && _confFreq != _curFreq) {
-                        sendCommand(TRAMP_CMD_SET_FREQ, _confFreq);
-                        configNeeded = true;
-                    } else if (!isRaceLocked() && _confPower != _curPower) {
-                        sendCommand(TRAMP_CMD_SET_POWER, _confPower);
-                        configNeeded = true;
-                    } else if (_confPitMode != _curPitMode) {
-                        sendCommand(TRAMP_CMD_SET_ACTIVE, _confPitMode ? 0 : 1);
-                        configNeeded = true;
-                    }
-                    
-                    if (configNeeded) {
-                        _retryCount--;
-                        _lastRequest = now;
-                        _status = STATUS_ONLINE_CONFIG;
-                    } else {
-                        _retryCount = TRAMP_MAX_RETRIES;
-                    }
-                }
-                
-                if (!configNeeded) {
-                    // Regular monitoring
-                    if (now - _lastRequest >= TRAMP_STATUS_REQUEST_PERIOD) {
-                        query(TRAMP_CMD_STATUS);
-                        _lastRequest = now;
-                    } else if (replyCode == 'v') {
-                        // Got status, query temperature
-                        query(TRAMP_CMD_TEMP);
-                        _status = STATUS_ONLINE_MONITOR_TEMP;
-                        _lastRequest = now;
-                    }
-                }
+            // Unconfirmed set commands are re-sent by sendPendingConfig()
+            if (now - _lastRequest >= _profile->pollIntervalMs * 1000UL) {
+                query(TRAMP_CMD_STATUS);
+                _lastRequest = now;
+                _tempDue = true;
+            } else if (replyCode == 'v' && _tempDue) {
+                // Got the poll's status, query temperature (not after a config verify)
+                _tempDue = false;
+                query(TRAMP_CMD_TEMP);
+                setStatus(STATUS_ONLINE_MONITOR_TEMP);
+                _lastRequest = now;
             }
             break;
             
         case STATUS_ONLINE_MONITOR_TEMP:
             if (replyCode == 's') {
-                _status = STATUS_ONLINE_MONITOR_FREQPWRPIT;
-            } else if (now - _lastRequest >= TRAMP_MIN_REQUEST_PERIOD) {
-                _status = STATUS_ONLINE_MONITOR_FREQPWRPIT;
+                setStatus(STATUS_ONLINE_MONITOR_FREQPWRPIT);
+            } else if (now - _lastRequest >= requestGapUs()) {
+                setStatus(STATUS_ONLINE_MONITOR_FREQPWRPIT);
             }
             break;
             
         case STATUS_ONLINE_CONFIG:
-            if (now - _lastRequest >= TRAMP_MIN_REQUEST_PERIOD) {
+            if (now - _lastRequest >= requestGapUs()) {
                 query(TRAMP_CMD_STATUS);
-                _status = STATUS_ONLINE_MONITOR_FREQPWRPIT;
+                setStatus(STATUS_ONLINE_MONITOR_FREQPWRPIT);
                 _lastRequest = now;
+                
+                // The whole batch is confirmed by this reply
+                commandAwaitingReply(_batchMask, replyTimeoutMs());
             }
             break;
     }
+    _replyCode = 0;
+#else
+    // TX-only build: no status polling, only paced config in conservative mode
+    (void)holding;
+    serviceCommands();
+    sendPendingConfig(false);
+#endif
+    
+    resumeCommandWaiters();
 }
 
 bool TrampVTX::isReady() {
@@ -143,68 +153,245 @@ bool TrampVTX::isReady() {
 
 bool TrampVTX::setFrequency(uint16_t freq) {
     _confFreq = freq;
-    _retryCount = TRAMP_MAX_RETRIES;
     
     // In TX-only mode, send immediately
-    sendCommand(TRAMP_CMD_SET_FREQ, freq);
-    return true;
+    return sendTracked(VTX_FIELD_FREQUENCY);
 }
 
 bool TrampVTX::setPower(uint16_t power) {
     _confPower = power;
-    _retryCount = TRAMP_MAX_RETRIES;
     
     // In TX-only mode, send immediately
-    sendCommand(TRAMP_CMD_SET_POWER, power);
-    return true;
+    return sendTracked(VTX_FIELD_POWER);
 }
 
 bool TrampVTX::setPitMode(bool enable) {
     _confPitMode = enable;
-    _retryCount = TRAMP_MAX_RETRIES;
     
     // In TX-only mode, send immediately
-    // TRAMP: active=1 means normal power (pit OFF), active=0 means pit mode (pit ON)
-    sendCommand(TRAMP_CMD_SET_ACTIVE, enable ? 0 : 1);
-    return true;
+    return sendTracked(VTX_FIELD_PIT_MODE);
 }
 
-// ===== Private Methods =====
+uint8_t TrampVTX::encodeFrequencyFrame(uint16_t freq, uint8_t* buf, uint8_t maxLen) {
+    const uint8_t dummies = dummyBytes();
+    if (maxLen < dummies + TRAMP_PACKET_SIZE) {
+        return 0;
+    }
+    
+    memset(buf, 0, dummies);
+    buildPacket(TRAMP_CMD_SET_FREQ, freq, buf + dummies);
+    return dummies + TRAMP_PACKET_SIZE;
+}
 
-uint8_t TrampVTX::calculateChecksum(const uint8_t* buf) {
-    uint8_t cksum = 0;
-    const uint8_t checksumLength = 14;
-    for (int i = 1; i < checksumLength; i++) {
-        cksum += buf[i];
+uint8_t TrampVTX::encodePitModeFrame(bool enable, uint8_t* buf, uint8_t maxLen) {
+    const uint8_t dummies = dummyBytes();
+    if (maxLen < dummies + TRAMP_PACKET_SIZE) {
+        return 0;
     }
-    return cksum;
+    
+    memset(buf, 0, dummies);
+    buildPacket(TRAMP_CMD_SET_ACTIVE, enable ? 0 : 1, buf + dummies);
+    return dummies + TRAMP_PACKET_SIZE;
+}
+
+// ===== Private Methods =====
+
+void TrampVTX::buildPacket(uint8_t cmd, uint16_t param, uint8_t* buf) {
+    memset(buf, 0, TRAMP_PACKET_SIZE);
+    buf[0] = TRAMP_HEADER;
+    buf[1] = cmd;
+    buf[2] = param & 0xFF;
+    buf[3] = (param >> 8) & 0xFF;
+    buf[14] = TrampParser::checksum(buf);
+    buf[15] = 0;
 }
 
 void TrampVTX::sendPacket(uint8_t cmd, uint16_t param) {
-    if (!_serial) {
+    if (!_transport) {
         return;
     }
     
-    memset(_txBuffer, 0, TRAMP_PACKET_SIZE);
-    _txBuffer[0] = TRAMP_HEADER;
-    _txBuffer[1] = cmd;
-    _txBuffer[2] = param & 0xFF;
-    _txBuffer[3] = (param >> 8) & 0xFF;
-    _txBuffer[14] = calculateChecksum(_txBuffer);
-    _txBuffer[15] = 0;
+    buildPacket(cmd, param, _txBuffer);
     
     // Debug output
     debugPrintHex(_txBuffer, TRAMP_PACKET_SIZE, "TRAMP");
+    recordTx(_txBuffer, TRAMP_PACKET_SIZE);
     
-    // Send dummy byte for UART stabilization (as per esp-fc implementation)
-    static const uint8_t dummyByte = 0x00;
-    _serial->write(&dummyByte, 1);
+    // Send dummy bytes for UART stabilization (as per esp-fc implementation),
+    // as many as the device profile asks for
+    static const uint8_t zeros[VTX_MAX_DUMMY_BYTES] = {};
+    _transport->write(zeros, dummyBytes());
     
     // Send packet
-    _serial->write(_txBuffer, TRAMP_PACKET_SIZE);
-    _serial->flush();
+    _transport->write(_txBuffer, TRAMP_PACKET_SIZE);
+    finishTx();
+}
+
+bool TrampVTX::sendTracked(VTXStateField field) {
+    beginCommand(field);
+    
+    if (field != VTX_FIELD_PIT_MODE && isRaceLocked()) {
+        finishCommand(field, VTX_RESULT_REJECTED);
+        return false;
+    }
+    
+    _sendMask |= field;
+    
+    // Pipelined: send right away, back to back with any other pending change.
+    // Conservative: one parameter per request gap from update().
+    sendPendingConfig(_pipelined);
+    return true;
+}
+
+void TrampVTX::sendPendingConfig(bool immediate) {
+    if (_sendMask == 0 || scheduleHold()) {
+        return;
+    }
+    
+    const unsigned long now = micros();
+    if (!immediate && now - _lastRequest < requestGapUs()) {
+        return;
+    }
+    
+    static const VTXStateField order[] = { VTX_FIELD_FREQUENCY, VTX_FIELD_POWER, VTX_FIELD_PIT_MODE };
+    for (uint8_t i = 0; i < sizeof(order) / sizeof(order[0]) && _sendMask != 0; i++) {
+        const VTXStateField field = order[i];
+        if (!(_sendMask & field)) {
+            continue;
+        }
+        _sendMask &= ~field;
+        
+        if (field != VTX_FIELD_PIT_MODE && isRaceLocked()) {
+            finishCommand(field, VTX_RESULT_REJECTED);
+            continue;
+        }
+        
+        sendConfig(field);
+        _batchMask |= field;
+        
+        if (!_pipelined) {
+            break;
+        }
+    }
 }
 
+void TrampVTX::sendConfig(VTXStateField field) {
+    switch (field) {
+        case VTX_FIELD_FREQUENCY:
+            sendCommand(TRAMP_CMD_SET_FREQ, _confFreq);
+            break;
+        case VTX_FIELD_POWER:
+            sendCommand(TRAMP_CMD_SET_POWER, _confPower);
+            break;
+        case VTX_FIELD_PIT_MODE:
+            // TRAMP: active=1 means normal power (pit OFF), active=0 means pit mode (pit ON)
+            sendCommand(TRAMP_CMD_SET_ACTIVE, _confPitMode ? 0 : 1);
+            break;
+        default:
+            return;
+    }
+    
+    configSent(field);
+}
+
+void TrampVTX::configSent(VTXStateField field) {
+    commandSent(field);
+    // Earlier packets of a pipelined batch wait for the same verify query
+    commandAwaitingReply(_batchMask, _responseTimeoutMs);
+    
+    // Once online, follow up with a single status query one request gap
+    // after the last packet to verify everything sent so far
+    _lastRequest = micros();
+    if (_status == STATUS_ONLINE_MONITOR_FREQPWRPIT || _status == STATUS_ONLINE_MONITOR_TEMP) {
+        setStatus(STATUS_ONLINE_CONFIG);
+    }
+}
+
+void TrampVTX::scheduledCommandSent(VTXStateField field, uint16_t value, uint8_t len) {
+    (void)len;
+    
+    if (field == VTX_FIELD_FREQUENCY) {
+        _confFreq = value;
+    } else {
+        _confPitMode = value != 0;
+    }
+    beginCommand(field);
+    
+    // The device ignores it, as it would have from the setter
+    if (field != VTX_FIELD_PIT_MODE && isRaceLocked()) {
+        finishCommand(field, VTX_RESULT_REJECTED);
+        return;
+    }
+    
+    _sendMask &= ~field;
+    _batchMask |= field;
+    configSent(field);
+}
+
+void TrampVTX::requestedFrequency(uint16_t freq) {
+    _confFreq = freq;
+    _sendMask &= ~VTX_FIELD_FREQUENCY;
+}
+
+void TrampVTX::resendCommand(VTXStateField field) {
+    // Picked up by sendPendingConfig() once the request gap has elapsed,
+    // together with any other field that is due in pipelined mode
+    _sendMask |= field;
+}
+
+void TrampVTX::linkLost() {
+    // Back to reset queries every request gap until the device answers
+    setStatus(STATUS_OFFLINE);
+    _batchMask = 0;
+}
+
+void TrampVTX::restoreSettings(uint8_t fields) {
+    static const VTXStateField order[] = { VTX_FIELD_FREQUENCY, VTX_FIELD_POWER, VTX_FIELD_PIT_MODE };
+    for (uint8_t i = 0; i < sizeof(order) / sizeof(order[0]); i++) {
+        if (fields & order[i]) {
+            sendTracked(order[i]);
+        }
+    }
+}
+
+#if BETAVTX_ENABLE_RX
+void TrampVTX::confirmStatus() {
+    if (commandPending(VTX_FIELD_FREQUENCY) && _curFreq == _confFreq) {
+        finishCommand(VTX_FIELD_FREQUENCY, VTX_RESULT_CONFIRMED);
+    }
+    if (commandPending(VTX_FIELD_POWER) && _curPower == _confPower) {
+        finishCommand(VTX_FIELD_POWER, VTX_RESULT_CONFIRMED);
+    }
+    if (commandPending(VTX_FIELD_PIT_MODE) && _curPitMode == _confPitMode) {
+        finishCommand(VTX_FIELD_PIT_MODE, VTX_RESULT_CONFIRMED);
+    }
+    
+    checkPipelineHealth();
+}
+
+void TrampVTX::checkPipelineHealth() {
+    const uint8_t batch = _batchMask;
+    _batchMask = 0;
+    
+    // Only multi-packet batches tell us whether the device keeps up
+    if (!_pipelined || (batch & (batch - 1)) == 0) {
+        return;
+    }
+    
+    const bool dropped = ((batch & VTX_FIELD_FREQUENCY) && _curFreq != _confFreq) ||
+                         ((batch & VTX_FIELD_POWER) && _curPower != _confPower) ||
+                         ((batch & VTX_FIELD_PIT_MODE) && _curPitMode != _confPitMode);
+    
+    if (!dropped) {
+        _pipelineStrikes = 0;
+    } else if (++_pipelineStrikes >= TRAMP_PIPELINE_MAX_STRIKES) {
+        // Device loses back-to-back packets: one parameter per request gap from now on
+        _pipelined = false;
+        debugPrintln("[TRAMP] Falling back to one parameter per request");
+    }
+}
+#endif
+
 void TrampVTX::sendCommand(uint8_t cmd, uint16_t param) {
     if (cmd != TRAMP_CMD_SET_ACTIVE && isRaceLocked()) {
         return;
@@ -213,78 +400,83 @@ void TrampVTX::sendCommand(uint8_t cmd, uint16_t param) {
     sendPacket(cmd, param);
 }
 
+uint32_t TrampVTX::requestGapUs() const {
+    return _rtt.timeoutUs(_profile->timeoutMinMs * 1000UL, _profile->timeoutMaxMs * 1000UL,
+                          TRAMP_MIN_REQUEST_PERIOD);
+}
+
+uint32_t TrampVTX::replyTimeoutMs() const {
+    // The query on the wire (unless the write already waited for it), then the round trip
+    const uint32_t wireUs = _blockingTx ? 0 : wireTimeUs(dummyBytes() + TRAMP_PACKET_SIZE);
+    return (wireUs + requestGapUs()) / 1000 + 1;
+}
+
+#if BETAVTX_ENABLE_RX
 void TrampVTX::query(uint8_t cmd) {
-    resetReceiver();
+    // In event-driven mode the parser belongs to the receive context, which resyncs on line gaps
+    if (!isEventDrivenRx()) {
+        resetRxParser();
+    }
     sendPacket(cmd, 0);
+    rttRequestSent(dummyBytes() + TRAMP_PACKET_SIZE);
 }
 
 char TrampVTX::receive() {
-    if (!_serial) {
-        return 0;
+    // A reply held over by an update() that ran out of budget comes first
+    if (_replyCode == 0) {
+        serviceRx(1);
     }
-    
-    while (_serial->available()) {
-        uint8_t c = _serial->read();
-        _rxBuffer[_rxPos++] = c;
-        
-        switch (_rxState) {
-            case RX_WAIT_LEN:
-                if (c == 0x0F || c == 0x10) {
-                    _rxState = RX_WAIT_CODE;
-                } else {
-                    resetReceiver();
-                }
-                break;
-                
-            case RX_WAIT_CODE:
-                if (c == 'r' || c == 'v' || c == 's') {
-                    _rxState = RX_DATA;
-                } else {
-                    resetReceiver();
-                }
-                break;
-                
-            case RX_DATA:
-                if (_rxPos == TRAMP_PACKET_SIZE) {
-                    const uint8_t cksum = calculateChecksum(_rxBuffer);
-                    const uint8_t checksumPos = 14;
-                    const uint8_t termPos = 15;
-                    resetReceiver();
-                    
-                    if (_rxBuffer[checksumPos] == cksum && _rxBuffer[termPos] == 0) {
-                        return handleResponse();
-                    }
-                }
-                break;
-        }
+    return _replyCode;
+}
+
+uint8_t TrampVTX::parseRxByte(uint8_t c, VTXRxFrame& frame) {
+    const uint8_t event = _parser.feed(c);
+    if (event == VTX_RX_FRAME) {
+        frame.len = TRAMP_PACKET_SIZE;
+        memcpy(frame.data, _parser.frame(), TRAMP_PACKET_SIZE);
+    }
+    return event;
+}
+
+void TrampVTX::handleRxFrame(const VTXRxFrame& frame) {
+    if (frame.event != VTX_RX_FRAME) {
+        recordTelemetry(VTX_METRIC_LINK_ERRORS, VTX_TELEMETRY_ERROR);
+        return;
     }
     
-    return 0;
+    _replyCode = handleResponse(frame.data);
+    if (_replyCode) {
+        rttResponseReceived();
+        _responseTimeoutMs = requestGapUs() / 1000 + replyTimeoutMs();
+    }
 }
 
-char TrampVTX::handleResponse() {
-    const char respCode = _rxBuffer[1];
+char TrampVTX::handleResponse(const uint8_t* buf) {
+    const char respCode = buf[1];
     
     switch (respCode) {
         case 'r': {
-            const uint16_t minFreq = _rxBuffer[2] | (_rxBuffer[3] << 8);
+            const uint16_t minFreq = buf[2] | (buf[3] << 8);
             if (minFreq != 0) {
                 _minFreq = minFreq;
-                _maxFreq = _rxBuffer[4] | (_rxBuffer[5] << 8);
-                _maxPower = _rxBuffer[6] | (_rxBuffer[7] << 8);
+                _maxFreq = buf[4] | (buf[5] << 8);
+                _maxPower = buf[6] | (buf[7] << 8);
+                _device.minFreq = _minFreq;
+                _device.maxFreq = _maxFreq;
+                _device.maxPower = _maxPower;
                 return 'r';
             }
             break;
         }
         
         case 'v': {
-            const uint16_t freq = _rxBuffer[2] | (_rxBuffer[3] << 8);
+            const uint16_t freq = buf[2] | (buf[3] << 8);
             if (freq != 0) {
                 _curFreq = freq;
-                _curPower = _rxBuffer[4] | (_rxBuffer[5] << 8);
-                _controlMode = _rxBuffer[6];
-                _curPitMode = _rxBuffer[7];
-                _actualPower = _rxBuffer[8] | (_rxBuffer[9] << 8);
+                _curPower = buf[4] | (buf[5] << 8);
+                _controlMode = buf[6];
+                _curPitMode = buf[7];
+                _actualPower = buf[8] | (buf[9] << 8);
                 
                 if (_confFreq == 0) {
                     _confFreq = _curFreq;
@@ -293,15 +485,31 @@ char TrampVTX::handleResponse() {
                     _confPower = _curPower;
                 }
                 
+                VTXState state = _state;
+                state.frequency = _curFreq;
+                state.power = _curPower;
+                state.actualPower = _actualPower;
+                state.pitMode = _curPitMode;
+                publishState(state);
+                confirmStatus();
+                
+                // Measured output where the VTX reports it, else the configured level
+                recordTelemetry(VTX_METRIC_POWER, _actualPower ? _actualPower : _curPower);
+                
                 return 'v';
             }
             break;
         }
         
         case 's': {
-            const int16_t temp = _rxBuffer[6] | (_rxBuffer[7] << 8);
+            const int16_t temp = buf[6] | (buf[7] << 8);
             if (temp != 0) {
                 _temperature = temp;
+                
+                VTXState state = _state;
+                state.temperature = temp;
+                publishState(state);
+                recordTelemetry(VTX_METRIC_TEMPERATURE, temp);
                 return 's';
             }
             break;
@@ -311,7 +519,9 @@ char TrampVTX::handleResponse() {
     return 0;
 }
 
-void TrampVTX::resetReceiver() {
-    _rxState = RX_WAIT_LEN;
-    _rxPos = 0;
+void TrampVTX::resetRxParser() {
+    _parser.reset();
 }
+#endif // BETAVTX_ENABLE_RX
+
+#endif // BETAVTX_ENABLE_TRAMP
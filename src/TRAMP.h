@@ -9,13 +9,12 @@
 #define TRAMP_H
 
 #include "VTXProtocol.h"
+#include "VTXFrameParser.h"
 
 // Fixed baud rate as per TRAMP protocol
 #define TRAMP_BAUD              9600
-#define VTX_TX_BUFFER_SIZE      255
 
-#define TRAMP_PACKET_SIZE       16
-#define TRAMP_HEADER            0x0F
+#define TRAMP_DUMMY_BYTES       1       // Zero bytes sent ahead of every packet (conservative profile)
 
 #define TRAMP_CMD_RESET         'r'
 #define TRAMP_CMD_STATUS        'v'
@@ -26,22 +25,55 @@
 
 #define TRAMP_CONTROL_RACE_LOCK 0x01
 
-#define TRAMP_MIN_REQUEST_PERIOD    200000
+#define TRAMP_MIN_REQUEST_PERIOD    200000  // us, request gap until RTT samples exist (and upper clamp)
+#define TRAMP_MIN_REQUEST_GAP       50000   // us, lower clamp for the RTT derived gap
+
+#define TRAMP_PIPELINE_MAX_STRIKES  2       // Failed multi-packet batches before falling back
 #define TRAMP_STATUS_REQUEST_PERIOD 1000000
 
-#define TRAMP_MAX_RETRIES       20
+#if BETAVTX_ENABLE_TRAMP
 
 class TrampVTX : public VTXProtocol {
 public:
     TrampVTX();
     ~TrampVTX();
     
-    bool begin(HardwareSerial* serial, uint8_t txPin, HardwareSerial* debugSerial = nullptr) override;
+    using VTXProtocol::update;
     void update() override;
     bool isReady() override;
     bool setFrequency(uint16_t freq) override;
     bool setPower(uint16_t power) override;
     bool setPitMode(bool enable) override;
+    
+    /**
+     * @brief Choose how configuration changes are sent
+     *
+     * Pipelined (default): all differing parameters go out back to back and
+     * are verified with a single status query. Conservative: one parameter
+     * per request gap, as in Betaflight. Pipelining is switched off
+     * automatically for devices that drop back-to-back packets.
+     */
+    void setPipelinedConfig(bool enable) {
+        _pipelined = enable;
+        _pipelineStrikes = 0;
+    }
+    bool isPipelinedConfig() const { return _pipelined; }
+    
+    uint8_t encodeFrequencyFrame(uint16_t freq, uint8_t* buf, uint8_t maxLen) override;
+    uint8_t encodePitModeFrame(bool enable, uint8_t* buf, uint8_t maxLen) override;
+
+protected:
+    bool start() override;
+    void scheduledCommandSent(VTXStateField field, uint16_t value, uint8_t len) override;
+    void requestedFrequency(uint16_t freq) override;
+    void resendCommand(VTXStateField field) override;
+    void linkLost() override;
+    void restoreSettings(uint8_t fields) override;
+#if BETAVTX_ENABLE_RX
+    uint8_t parseRxByte(uint8_t c, VTXRxFrame& frame) override;
+    void resetRxParser() override;
+    void handleRxFrame(const VTXRxFrame& frame) override;
+#endif
 
 private:
     enum Status {
@@ -52,12 +84,6 @@ private:
         STATUS_ONLINE_CONFIG
     };
     
-    enum ReceiveState {
-        RX_WAIT_LEN,
-        RX_WAIT_CODE,
-        RX_DATA
-    };
-    
     uint16_t _confFreq = 0;
     uint16_t _confPower = 0;
     bool _confPitMode = false;
@@ -70,26 +96,50 @@ private:
     uint16_t _maxPower = 0;
     uint8_t _controlMode = 0;
     uint16_t _actualPower = 0;
-    uint16_t _temperature = 0;
+    int16_t _temperature = 0;
     
     Status _status = STATUS_OFFLINE;
-    ReceiveState _rxState = RX_WAIT_LEN;
     
     uint8_t _txBuffer[TRAMP_PACKET_SIZE];
-    uint8_t _rxBuffer[TRAMP_PACKET_SIZE];
-    uint8_t _rxPos = 0;
+#if BETAVTX_ENABLE_RX
+    TrampParser _parser;
+    char _replyCode = 0;        // Set by handleRxFrame(), consumed by update()
+    bool _tempDue = false;      // Poll status reply is followed by a temperature query
+#endif
     
     unsigned long _lastRequest = 0;
-    uint8_t _retryCount = TRAMP_MAX_RETRIES;
     
-    uint8_t calculateChecksum(const uint8_t* buf);
+    bool _pipelined = true;
+    uint8_t _pipelineStrikes = 0;
+    uint8_t _sendMask = 0;      // VTXStateField bits waiting to be sent
+    uint8_t _batchMask = 0;     // Fields sent since the last status reply
+    
+    void setStatus(Status status) {
+        if (status != _status) {
+            recordEvent(VTX_REC_PHASE, status, _status);
+            _status = status;
+        }
+    }
+    
+    void buildPacket(uint8_t cmd, uint16_t param, uint8_t* buf);
     void sendPacket(uint8_t cmd, uint16_t param);
+    bool sendTracked(VTXStateField field);
+    void sendPendingConfig(bool immediate);
+    void sendConfig(VTXStateField field);
+    void configSent(VTXStateField field);
+    uint32_t requestGapUs() const;
+    uint32_t replyTimeoutMs() const;
     void sendCommand(uint8_t cmd, uint16_t param);
+#if BETAVTX_ENABLE_RX
+    void confirmStatus();
+    void checkPipelineHealth();
     void query(uint8_t cmd);
     char receive();
-    char handleResponse();
-    void resetReceiver();
+    char handleResponse(const uint8_t* buf);
+#endif
     bool isRaceLocked() const { return (_controlMode & TRAMP_CONTROL_RACE_LOCK) != 0; }
 };
 
+#endif // BETAVTX_ENABLE_TRAMP
+
 #endif
@@ -0,0 +1,98 @@
+/**
+ * @file VTXAwait.h
+ * @brief C++20 awaitables for confirmed set commands
+ *
+ *   VTXCommandResult r = co_await vtx.setFrequencyAsync(5732);
+ *   if (r == VTX_RESULT_CONFIRMED) { ... }
+ *
+ * The command is sent when the awaitable is created. The coroutine is
+ * resumed from the update() call that sees the final result (confirmed,
+ * rejected, retries or deadline exhausted); on a TX-only link it does not
+ * suspend and gets VTX_RESULT_UNCONFIRMED. Waiting uses no threads and no
+ * heap: the awaitable lives in the awaiting coroutine's frame and links
+ * itself into the protocol's waiter list. Keep calling update() (from the
+ * same task/event loop) while coroutines wait.
+ *
+ * Included by VTXProtocol.h when BETAVTX_ENABLE_COROUTINES is set
+ * (default with -std=c++20 or later).
+ */
+
+#ifndef VTXAWAIT_H
+#define VTXAWAIT_H
+
+#include "VTXProtocol.h"
+
+#if BETAVTX_ENABLE_COROUTINES
+
+#include <coroutine>
+
+class VTXCommandAwaitable : private VTXCommandWaiter {
+public:
+    /**
+     * @param vtx Protocol the command was sent on, nullptr if none
+     * @param field Field of the command
+     * @param sent Setter return value; false finishes as VTX_RESULT_REJECTED
+     */
+    VTXCommandAwaitable(VTXProtocol* vtx, VTXStateField field, bool sent) : _vtx(vtx) {
+        this->field = field;
+        this->next = nullptr;
+        this->resume = resumeWaiter;
+        if (!vtx) {
+            this->result = VTX_RESULT_REJECTED;
+        } else if (!sent && vtx->getCommandResult(field) == VTX_RESULT_PENDING) {
+            // Older command still running, this one never went out
+            this->result = VTX_RESULT_REJECTED;
+        } else {
+            this->result = vtx->getCommandResult(field);
+        }
+    }
+
+    VTXCommandAwaitable(const VTXCommandAwaitable&) = delete;
+    VTXCommandAwaitable& operator=(const VTXCommandAwaitable&) = delete;
+
+    ~VTXCommandAwaitable() {
+        if (_suspended && _vtx) {
+            _vtx->removeCommandWaiter(this);
+        }
+    }
+
+    bool await_ready() const noexcept { return this->result != VTX_RESULT_PENDING; }
+
+    void await_suspend(std::coroutine_handle<> handle) noexcept {
+        _handle = handle;
+        _suspended = true;
+        _vtx->addCommandWaiter(this);
+    }
+
+    VTXCommandResult await_resume() const noexcept { return this->result; }
+
+private:
+    VTXProtocol* _vtx;
+    std::coroutine_handle<> _handle;
+    bool _suspended = false;
+
+    static void resumeWaiter(VTXCommandWaiter* waiter) {
+        VTXCommandAwaitable* self = static_cast<VTXCommandAwaitable*>(waiter);
+        self->_suspended = false;
+        self->_handle.resume();
+    }
+};
+
+inline VTXCommandAwaitable VTXProtocol::setFrequencyAsync(uint16_t freq) {
+    const bool sent = setFrequency(freq);
+    return VTXCommandAwaitable(this, VTX_FIELD_FREQUENCY, sent);
+}
+
+inline VTXCommandAwaitable VTXProtocol::setPowerAsync(uint16_t power) {
+    const bool sent = setPower(power);
+    return VTXCommandAwaitable(this, VTX_FIELD_POWER, sent);
+}
+
+inline VTXCommandAwaitable VTXProtocol::setPitModeAsync(bool enable) {
+    const bool sent = setPitMode(enable);
+    return VTXCommandAwaitable(this, VTX_FIELD_PIT_MODE, sent);
+}
+
+#endif // BETAVTX_ENABLE_COROUTINES
+
+#endif // VTXAWAIT_H
@@ -0,0 +1,35 @@
+/**
+ * @file VTXBandTable.cpp
+ * @brief Default 5.8 GHz band/channel table shared by protocols and bridges
+ */
+
+#include "VTXBandTable.h"
+
+const uint16_t vtxDefaultFrequencyTable[VTX_MAX_BAND][VTX_MAX_CHANNEL] = {
+    { 5865, 5845, 5825, 5805, 5785, 5765, 5745, 5725 },    // Boscam A
+    { 5733, 5752, 5771, 5790, 5809, 5828, 5847, 5866 },    // Boscam B
+    { 5705, 5685, 5665, 5645, 5885, 5905, 5925, 5945 },    // Boscam E
+    { 5740, 5760, 5780, 5800, 5820, 5840, 5860, 5880 },    // FatShark
+    { 5658, 5695, 5732, 5769, 5806, 5843, 5880, 5917 }     // RaceBand
+};
+
+uint16_t vtxBandChannelToFrequency(uint8_t band, uint8_t channel) {
+    if (band < VTX_MIN_BAND || band > VTX_MAX_BAND ||
+        channel < VTX_MIN_CHANNEL || channel > VTX_MAX_CHANNEL) {
+        return 0;
+    }
+    return vtxDefaultFrequencyTable[band - VTX_MIN_BAND][channel - VTX_MIN_CHANNEL];
+}
+
+bool vtxFrequencyToBandChannel(uint16_t freq, uint8_t* band, uint8_t* channel) {
+    for (uint8_t b = 0; b < VTX_MAX_BAND; b++) {
+        for (uint8_t c = 0; c < VTX_MAX_CHANNEL; c++) {
+            if (vtxDefaultFrequencyTable[b][c] == freq) {
+                *band = b + VTX_MIN_BAND;
+                *channel = c + VTX_MIN_CHANNEL;
+                return true;
+            }
+        }
+    }
+    return false;
+}
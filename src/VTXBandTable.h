@@ -0,0 +1,33 @@
+/**
+ * @file VTXBandTable.h
+ * @brief Default 5.8 GHz band/channel table shared by protocols and bridges
+ */
+
+#ifndef VTXBANDTABLE_H
+#define VTXBANDTABLE_H
+
+#include "VTXPlatform.h"
+
+// Band and channel numbers are 1-based, as in Betaflight
+#define VTX_MIN_BAND        1
+#define VTX_MAX_BAND        5
+#define VTX_MIN_CHANNEL     1
+#define VTX_MAX_CHANNEL     8
+
+/**
+ * @brief Boscam A, Boscam B, Boscam E, FatShark, RaceBand (MHz)
+ */
+extern const uint16_t vtxDefaultFrequencyTable[VTX_MAX_BAND][VTX_MAX_CHANNEL];
+
+/**
+ * @return Frequency in MHz, 0 if band or channel is out of range
+ */
+uint16_t vtxBandChannelToFrequency(uint8_t band, uint8_t channel);
+
+/**
+ * @brief Find the first band/channel that maps to a frequency
+ * @return false if the frequency is not in the table
+ */
+bool vtxFrequencyToBandChannel(uint16_t freq, uint8_t* band, uint8_t* channel);
+
+#endif // VTXBANDTABLE_H
@@ -0,0 +1,126 @@
+/**
+ * @file VTXConfig.h
+ * @brief Compile-time feature switches and footprint profiles
+ *
+ * Every switch can be overridden from build flags, e.g.
+ *   -DBETAVTX_ENABLE_TRAMP=0
+ * or a whole profile selected with
+ *   -DBETAVTX_PROFILE_MINIMAL_TX
+ *
+ * Measure the cost of each configuration with examples/footprint.
+ */
+
+#ifndef VTXCONFIG_H
+#define VTXCONFIG_H
+
+// Minimal TX-only profile: no RX parsing (which also drops the SmartAudio
+// command queue), no debug output, no counters, no flight recorder hooks
+// and the UART driver's default TX buffer.
+// Commands still go out; they finish as VTX_RESULT_UNCONFIRMED.
+#ifdef BETAVTX_PROFILE_MINIMAL_TX
+#ifndef BETAVTX_ENABLE_RX
+#define BETAVTX_ENABLE_RX           0
+#endif
+#ifndef BETAVTX_ENABLE_DEBUG
+#define BETAVTX_ENABLE_DEBUG        0
+#endif
+#ifndef BETAVTX_ENABLE_STATS
+#define BETAVTX_ENABLE_STATS        0
+#endif
+#ifndef BETAVTX_ENABLE_RECORDER
+#define BETAVTX_ENABLE_RECORDER     0
+#endif
+#ifndef BETAVTX_TX_BUFFER_SIZE
+#define BETAVTX_TX_BUFFER_SIZE      0
+#endif
+#endif // BETAVTX_PROFILE_MINIMAL_TX
+
+// Protocol engines built into the library
+#ifndef BETAVTX_ENABLE_SMARTAUDIO
+#define BETAVTX_ENABLE_SMARTAUDIO   1
+#endif
+#ifndef BETAVTX_ENABLE_TRAMP
+#define BETAVTX_ENABLE_TRAMP        1
+#endif
+#ifndef BETAVTX_ENABLE_MSP
+#define BETAVTX_ENABLE_MSP          1
+#endif
+
+// Response parsing, state readback and command confirmation
+#ifndef BETAVTX_ENABLE_RX
+#define BETAVTX_ENABLE_RX           1
+#endif
+
+// Frames buffered between the UART event callback and update() in
+// event-driven RX mode (setEventDrivenRx()), a power of two
+#ifndef BETAVTX_RX_FRAME_QUEUE_SIZE
+#define BETAVTX_RX_FRAME_QUEUE_SIZE 4
+#endif
+
+// Frames buffered between the UART event callback and VTXSniffer::update(),
+// a power of two
+#ifndef BETAVTX_SNIFFER_QUEUE_SIZE
+#define BETAVTX_SNIFFER_QUEUE_SIZE  32
+#endif
+
+// Print based debug output (hex dumps, status messages)
+#ifndef BETAVTX_ENABLE_DEBUG
+#define BETAVTX_ENABLE_DEBUG        1
+#endif
+
+// Packet and error counters (SmartAudioVTX / MSPVTX / VTXMSPBridge getStatistics())
+#ifndef BETAVTX_ENABLE_STATS
+#define BETAVTX_ENABLE_STATS        1
+#endif
+
+// Flight recorder hooks in the engines (VTXProtocol::setRecorder())
+#ifndef BETAVTX_ENABLE_RECORDER
+#define BETAVTX_ENABLE_RECORDER     1
+#endif
+
+// Records per flight recorder block; two blocks of 32 bytes per record are allocated
+#ifndef BETAVTX_RECORDER_BLOCK_RECORDS
+#define BETAVTX_RECORDER_BLOCK_RECORDS 32
+#endif
+
+// SmartAudio command queue depth (one slot always stays free)
+#ifndef BETAVTX_SA_QUEUE_SIZE
+#define BETAVTX_SA_QUEUE_SIZE       4
+#endif
+
+// Busy-wait window of update() ahead of a scheduled command (scheduleFrequency() ...)
+#ifndef BETAVTX_SCHEDULE_SPIN_US
+#define BETAVTX_SCHEDULE_SPIN_US    1000
+#endif
+
+// UART TX ring buffer requested on Arduino, 0 keeps the driver default
+#ifndef BETAVTX_TX_BUFFER_SIZE
+#define BETAVTX_TX_BUFFER_SIZE      255
+#endif
+
+// C++20 awaitables (setFrequencyAsync() ...), on wherever the compiler has coroutines
+#ifndef BETAVTX_ENABLE_COROUTINES
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+#define BETAVTX_ENABLE_COROUTINES   1
+#else
+#define BETAVTX_ENABLE_COROUTINES   0
+#endif
+#endif
+
+#if !BETAVTX_ENABLE_SMARTAUDIO && !BETAVTX_ENABLE_TRAMP && !BETAVTX_ENABLE_MSP
+#error "BetaVTXControl: enable at least one of BETAVTX_ENABLE_SMARTAUDIO, BETAVTX_ENABLE_TRAMP, BETAVTX_ENABLE_MSP"
+#endif
+
+#if BETAVTX_SA_QUEUE_SIZE < 2
+#error "BetaVTXControl: BETAVTX_SA_QUEUE_SIZE must be at least 2"
+#endif
+
+#if (BETAVTX_RX_FRAME_QUEUE_SIZE & (BETAVTX_RX_FRAME_QUEUE_SIZE - 1)) != 0 || BETAVTX_RX_FRAME_QUEUE_SIZE < 2
+#error "BetaVTXControl: BETAVTX_RX_FRAME_QUEUE_SIZE must be a power of two, at least 2"
+#endif
+
+#if BETAVTX_RECORDER_BLOCK_RECORDS < 1 || BETAVTX_RECORDER_BLOCK_RECORDS > 255
+#error "BetaVTXControl: BETAVTX_RECORDER_BLOCK_RECORDS must be 1 to 255"
+#endif
+
+#endif // VTXCONFIG_H
@@ -0,0 +1,78 @@
+/**
+ * @file VTXDeviceProfile.cpp
+ * @brief Device fingerprints and per-model timing profiles
+ */
+
+#include "VTXDeviceProfile.h"
+#include "SmartAudio.h"
+#include "TRAMP.h"
+#include "MSPVTX.h"
+
+// Fast entries only apply once the device has proven it answers quickly;
+// a link that then misses replies drops back to its family's last entry.
+const VTXDeviceProfile vtxDefaultProfiles[] = {
+    //  name            family                 ver lvl dBm minF maxF maxP  maxResponse  dummy tmin tmax poll
+    { "sa21-fast",    VTX_DEVICE_SMARTAUDIO,  3,  0,  0,  0,   0,   0,    50000,       1,    20,  200, 100  },
+    { "sa20-fast",    VTX_DEVICE_SMARTAUDIO,  2,  0,  0,  0,   0,   0,    50000,       1,    30,  250, 120  },
+    { "smartaudio",   VTX_DEVICE_SMARTAUDIO,  0,  0,  0,  0,   0,   0,    0,
+      SA_DUMMY_BYTES, SA_CMD_TIMEOUT_MIN, SA_CMD_TIMEOUT_MAX, SA_POLLING_INTERVAL },
+    { "tramp-fast",   VTX_DEVICE_TRAMP,       0,  0,  0,  0,   0,   0,    40000,       1,    25,  200, 1000 },
+    { "tramp",        VTX_DEVICE_TRAMP,       0,  0,  0,  0,   0,   0,    0,
+      TRAMP_DUMMY_BYTES, TRAMP_MIN_REQUEST_GAP / 1000, TRAMP_MIN_REQUEST_PERIOD / 1000,
+      TRAMP_STATUS_REQUEST_PERIOD / 1000 },
+    { "msp",          VTX_DEVICE_MSP,         0,  0,  0,  0,   0,   0,    0,
+      0, MSP_VTX_CMD_TIMEOUT_MIN, MSP_VTX_CMD_TIMEOUT_MAX, MSP_VTX_POLLING_INTERVAL },
+    { "conservative", VTX_DEVICE_ANY,         0,  0,  0,  0,   0,   0,    0,           2,    50,  300, 150  }
+};
+
+const uint8_t vtxDefaultProfileCount = sizeof(vtxDefaultProfiles) / sizeof(vtxDefaultProfiles[0]);
+
+bool vtxProfileMatches(const VTXDeviceProfile& profile, const VTXDeviceInfo& device, bool measured) {
+    if (profile.family != VTX_DEVICE_ANY && profile.family != device.family) {
+        return false;
+    }
+    if (profile.saVersion && profile.saVersion != device.saVersion) {
+        return false;
+    }
+    if (profile.powerLevels && profile.powerLevels != device.powerLevels) {
+        return false;
+    }
+    if (profile.maxPowerDbm) {
+        uint8_t maxDbm = 0;
+        for (uint8_t i = 0; i < device.powerLevels && i < VTX_DEVICE_MAX_POWER_LEVELS; i++) {
+            if (device.powerDbm[i] > maxDbm) {
+                maxDbm = device.powerDbm[i];
+            }
+        }
+        if (maxDbm != profile.maxPowerDbm) {
+            return false;
+        }
+    }
+    if ((profile.minFreq && profile.minFreq != device.minFreq) ||
+        (profile.maxFreq && profile.maxFreq != device.maxFreq) ||
+        (profile.maxPower && profile.maxPower != device.maxPower)) {
+        return false;
+    }
+    if (profile.maxResponseUs) {
+        return measured && device.responseUs != 0 && device.responseUs <= profile.maxResponseUs;
+    }
+    return true;
+}
+
+const VTXDeviceProfile* vtxFindProfile(const VTXDeviceProfile* profiles, uint8_t count,
+                                       const VTXDeviceInfo& device, bool measured) {
+    if (profiles) {
+        for (uint8_t i = 0; i < count; i++) {
+            if (vtxProfileMatches(profiles[i], device, measured)) {
+                return &profiles[i];
+            }
+        }
+    }
+
+    for (uint8_t i = 0; i < vtxDefaultProfileCount; i++) {
+        if (vtxProfileMatches(vtxDefaultProfiles[i], device, measured)) {
+            return &vtxDefaultProfiles[i];
+        }
+    }
+    return &vtxDefaultProfiles[vtxDefaultProfileCount - 1];
+}
@@ -0,0 +1,85 @@
+/**
+ * @file VTXDeviceProfile.h
+ * @brief Device fingerprints and per-model timing profiles
+ *
+ * The engines collect what the VTX reports about itself (SmartAudio
+ * version and v2.1 power list, TRAMP frequency/power limits) plus its
+ * measured response time, and pick the first matching entry of a profile
+ * table. The profile sets the dummy bytes ahead of each frame, the clamps
+ * of the RTT derived timeout/request gap and the status polling period.
+ *
+ * Entries are ordered fastest first; the last entry per protocol must
+ * match any device and keeps the conservative Betaflight timing.
+ */
+
+#ifndef VTXDEVICEPROFILE_H
+#define VTXDEVICEPROFILE_H
+
+#include "VTXPlatform.h"
+
+#define VTX_DEVICE_MAX_POWER_LEVELS 8
+#define VTX_MAX_DUMMY_BYTES         4
+#define VTX_PROFILE_MIN_SAMPLES     4   // Round trips measured before a timing bound counts
+#define VTX_PROFILE_MAX_STRIKES     2   // Missed replies in a row before falling back for good
+
+enum VTXDeviceFamily : uint8_t {
+    VTX_DEVICE_ANY,
+    VTX_DEVICE_SMARTAUDIO,
+    VTX_DEVICE_TRAMP,
+    VTX_DEVICE_MSP
+};
+
+/**
+ * @brief What a VTX has told us about itself
+ */
+struct VTXDeviceInfo {
+    VTXDeviceFamily family;
+    uint8_t saVersion;              // SmartAudio 1, 2 or 3 (v2.1), 0 until known
+    uint8_t powerLevels;            // SmartAudio v2.1 power list length, MSP vtxtable power levels
+    uint8_t powerDbm[VTX_DEVICE_MAX_POWER_LEVELS];
+    uint16_t minFreq;               // TRAMP reported limits, 0 until known
+    uint16_t maxFreq;
+    uint16_t maxPower;              // mW
+    uint32_t responseUs;            // SRTT + 4 * RTTVAR, 0 until enough samples
+};
+
+/**
+ * @brief Fingerprint and timing for one class of device
+ *
+ * Zero fingerprint fields match anything. maxResponseUs only matches a
+ * device whose measured response time is at or below it.
+ */
+struct VTXDeviceProfile {
+    const char* name;
+
+    VTXDeviceFamily family;
+    uint8_t saVersion;
+    uint8_t powerLevels;
+    uint8_t maxPowerDbm;            // Highest entry of the v2.1 power list
+    uint16_t minFreq;
+    uint16_t maxFreq;
+    uint16_t maxPower;
+    uint32_t maxResponseUs;
+
+    uint8_t dummyBytes;             // Zero bytes ahead of each frame (0 to VTX_MAX_DUMMY_BYTES)
+    uint16_t timeoutMinMs;          // Clamps for the RTT derived response timeout
+    uint16_t timeoutMaxMs;          // (SmartAudio) or request gap (TRAMP)
+    uint16_t pollIntervalMs;        // Status polling period
+};
+
+extern const VTXDeviceProfile vtxDefaultProfiles[];
+extern const uint8_t vtxDefaultProfileCount;
+
+/**
+ * @param measured false ignores entries bounded by response time
+ */
+bool vtxProfileMatches(const VTXDeviceProfile& profile, const VTXDeviceInfo& device, bool measured);
+
+/**
+ * @brief First matching profile, falling back to the built-in table
+ * @param profiles Table to search first, nullptr for the built-in one only
+ */
+const VTXDeviceProfile* vtxFindProfile(const VTXDeviceProfile* profiles, uint8_t count,
+                                       const VTXDeviceInfo& device, bool measured);
+
+#endif // VTXDEVICEPROFILE_H
@@ -0,0 +1,154 @@
+/**
+ * @file VTXFrameParser.cpp
+ * @brief SmartAudio and TRAMP frame parsers
+ */
+
+#include "VTXFrameParser.h"
+#include "SmartAudio.h"
+#include "TRAMP.h"
+
+#define SA_CRC8_POLY        0xD5
+#define SA_HEADER_SIZE      4       // Preamble, command, length
+#define TRAMP_CHECKSUM_POS  14
+#define TRAMP_TERM_POS      15
+
+uint8_t SmartAudioParser::feed(uint8_t c) {
+    switch (_state) {
+        case WAIT_PREAMBLE_1:
+            if (c == SA_PREAMBLE_1) {
+                _buffer[0] = c;
+                _pos = 1;
+                _state = WAIT_PREAMBLE_2;
+            }
+            break;
+
+        case WAIT_PREAMBLE_2:
+            if (c == SA_PREAMBLE_2) {
+                _buffer[_pos++] = c;
+                _state = WAIT_COMMAND;
+            } else {
+                _state = WAIT_PREAMBLE_1;
+                return SA_RX_BAD_PREAMBLE;
+            }
+            break;
+
+        case WAIT_COMMAND:
+            _buffer[_pos++] = c;
+            _state = WAIT_LENGTH;
+            break;
+
+        case WAIT_LENGTH:
+            _buffer[_pos++] = c;
+            _length = c;
+            if (_length == 0) {
+                _state = WAIT_CRC;
+            } else if (_length > SA_MAX_PACKET_LEN - SA_HEADER_SIZE - 1) {
+                _state = WAIT_PREAMBLE_1;
+                return SA_RX_BAD_LENGTH;
+            } else {
+                _state = WAIT_DATA;
+            }
+            break;
+
+        case WAIT_DATA:
+            _buffer[_pos++] = c;
+            if (_pos >= SA_HEADER_SIZE + _length) {
+                _state = WAIT_CRC;
+            }
+            break;
+
+        case WAIT_CRC:
+            _buffer[_pos++] = c;
+            _state = WAIT_PREAMBLE_1;
+
+            if (crc8(_buffer, _pos - 1) != c) {
+                return SA_RX_BAD_CRC;
+            }
+            return VTX_RX_FRAME;
+    }
+
+    return VTX_RX_NONE;
+}
+
+uint8_t SmartAudioParser::crc8(const uint8_t* data, uint8_t len) {
+    uint8_t crc = 0;
+
+    for (uint8_t i = 0; i < len; i++) {
+        crc ^= data[i];
+        for (uint8_t j = 0; j < 8; j++) {
+            if (crc & 0x80) {
+                crc = (crc << 1) ^ SA_CRC8_POLY;
+            } else {
+                crc <<= 1;
+            }
+        }
+    }
+
+    return crc;
+}
+
+bool SmartAudioParser::isRequest(const uint8_t* frame) {
+    const uint8_t cmd = frame[2];
+    const uint8_t len = frame[3];
+    if (!(cmd & 0x01)) {
+        return false;
+    }
+    return len < 2 || (len == 2 && cmd == ((SA_CMD_SET_FREQ << 1) | 1));
+}
+
+uint8_t TrampParser::feed(uint8_t c) {
+    _buffer[_pos++] = c;
+
+    switch (_state) {
+        case WAIT_LEN:
+            if (c == TRAMP_HEADER || c == 0x10) {
+                _state = WAIT_CODE;
+            } else {
+                reset();
+            }
+            break;
+
+        case WAIT_CODE:
+            if (c == TRAMP_CMD_RESET || c == TRAMP_CMD_STATUS || c == TRAMP_CMD_TEMP ||
+                (_acceptRequests && (c == TRAMP_CMD_SET_FREQ || c == TRAMP_CMD_SET_POWER ||
+                                     c == TRAMP_CMD_SET_ACTIVE))) {
+                _state = WAIT_DATA;
+            } else {
+                reset();
+            }
+            break;
+
+        case WAIT_DATA:
+            if (_pos == TRAMP_PACKET_SIZE) {
+                reset();
+                if (_buffer[TRAMP_CHECKSUM_POS] != checksum(_buffer) || _buffer[TRAMP_TERM_POS] != 0) {
+                    return TRAMP_RX_BAD_CHECKSUM;
+                }
+                return VTX_RX_FRAME;
+            }
+            break;
+    }
+
+    return VTX_RX_NONE;
+}
+
+uint8_t TrampParser::checksum(const uint8_t* packet) {
+    uint8_t cksum = 0;
+    for (uint8_t i = 1; i < TRAMP_CHECKSUM_POS; i++) {
+        cksum += packet[i];
+    }
+    return cksum;
+}
+
+bool TrampParser::isRequest(const uint8_t* packet) {
+    const uint8_t code = packet[1];
+    if (code == TRAMP_CMD_SET_FREQ || code == TRAMP_CMD_SET_POWER || code == TRAMP_CMD_SET_ACTIVE) {
+        return true;
+    }
+    for (uint8_t i = 2; i < TRAMP_CHECKSUM_POS; i++) {
+        if (packet[i] != 0) {
+            return false;
+        }
+    }
+    return true;
+}
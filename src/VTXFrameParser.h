@@ -0,0 +1,130 @@
+/**
+ * @file VTXFrameParser.h
+ * @brief SmartAudio and TRAMP frame parsers
+ *
+ * Byte-at-a-time parsers shared by the protocol engines (replies, and the
+ * echo of their own requests on a single-wire link) and VTXSniffer, which
+ * decodes both directions of a bus it only listens to. feed() returns the
+ * same event codes as VTXProtocol::parseRxByte().
+ */
+
+#ifndef VTXFRAMEPARSER_H
+#define VTXFRAMEPARSER_H
+
+#include "VTXProtocol.h"
+
+#define SA_MAX_PACKET_LEN   21
+#define SA_PREAMBLE_1       0xAA
+#define SA_PREAMBLE_2       0x55
+
+#define TRAMP_PACKET_SIZE   16
+#define TRAMP_HEADER        0x0F
+
+// Parser errors, after VTX_RX_FRAME
+#define SA_RX_BAD_PREAMBLE      2
+#define SA_RX_BAD_LENGTH        3
+#define SA_RX_BAD_CRC           4
+#define TRAMP_RX_BAD_CHECKSUM   2
+
+class SmartAudioParser {
+public:
+    /**
+     * @brief Feed one received byte
+     * @return VTX_RX_FRAME when a frame with a valid CRC is in frame(), an
+     *         SA_RX_* error, or VTX_RX_NONE while incomplete
+     */
+    uint8_t feed(uint8_t c);
+
+    /**
+     * @return Last complete frame, from the preamble to the CRC
+     */
+    const uint8_t* frame() const { return _buffer; }
+    uint8_t frameLength() const { return _pos; }
+
+    void reset() {
+        _state = WAIT_PREAMBLE_1;
+        _pos = 0;
+    }
+
+    static uint8_t crc8(const uint8_t* data, uint8_t len);
+
+    /**
+     * @brief Tell a host request from a VTX response
+     *
+     * Requests carry (command << 1) | 1 and at most two data bytes. The odd
+     * response codes (settings 0x01/0x09/0x11, SET_CHAN 0x03, SET_MODE 0x05)
+     * carry at least two, and only SET_FREQ sends two as a request.
+     *
+     * @param frame Complete frame as returned by frame()
+     */
+    static bool isRequest(const uint8_t* frame);
+
+private:
+    enum State {
+        WAIT_PREAMBLE_1,
+        WAIT_PREAMBLE_2,
+        WAIT_COMMAND,
+        WAIT_LENGTH,
+        WAIT_DATA,
+        WAIT_CRC
+    };
+
+    State _state = WAIT_PREAMBLE_1;
+    uint8_t _buffer[SA_MAX_PACKET_LEN];
+    uint8_t _pos = 0;
+    uint8_t _length = 0;
+};
+
+class TrampParser {
+public:
+    /**
+     * @brief Feed one received byte
+     * @return VTX_RX_FRAME when a packet with a valid checksum is in frame(),
+     *         TRAMP_RX_BAD_CHECKSUM, or VTX_RX_NONE while incomplete
+     */
+    uint8_t feed(uint8_t c);
+
+    /**
+     * @return Last complete packet, TRAMP_PACKET_SIZE bytes
+     */
+    const uint8_t* frame() const { return _buffer; }
+
+    void reset() {
+        _state = WAIT_LEN;
+        _pos = 0;
+    }
+
+    /**
+     * @brief Also accept the set requests (F, P, I)
+     *
+     * Off by default: the engines only expect replies, which share their
+     * codes (r, v, s) with the queries.
+     */
+    void setAcceptRequests(bool enable) { _acceptRequests = enable; }
+
+    static uint8_t checksum(const uint8_t* packet);
+
+    /**
+     * @brief Tell a host request from a VTX response
+     *
+     * Set requests are never answered. Queries share their code with the
+     * reply but carry no parameters.
+     *
+     * @param packet Complete packet as returned by frame()
+     */
+    static bool isRequest(const uint8_t* packet);
+
+private:
+    enum State {
+        WAIT_LEN,
+        WAIT_CODE,
+        WAIT_DATA
+    };
+
+    State _state = WAIT_LEN;
+    uint8_t _buffer[TRAMP_PACKET_SIZE];
+    uint8_t _pos = 0;
+    bool _acceptRequests = false;
+};
+
+#endif // VTXFRAMEPARSER_H
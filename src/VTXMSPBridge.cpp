@@ -0,0 +1,225 @@
+/**
+ * @file VTXMSPBridge.cpp
+ * @brief MSP responder serving cached VTX state to flight controllers and OSDs
+ */
+
+#include "VTXMSPBridge.h"
+
+#define MSP_VTX_CONFIG_SIZE     15
+
+static const uint16_t smartAudioPowerLevels[] = { 25, 200, 400, 600, 800 };
+static const uint16_t trampPowerLevels[] = { 25, 100, 200, 400, 600 };
+
+VTXMSPBridge::VTXMSPBridge(BetaVTXControl* vtx) : _vtx(vtx) {
+    if (vtx && vtx->getProtocolType() == VTX_PROTOCOL_TRAMP) {
+        setPowerLevels(trampPowerLevels, sizeof(trampPowerLevels) / sizeof(trampPowerLevels[0]));
+    } else {
+        setPowerLevels(smartAudioPowerLevels, sizeof(smartAudioPowerLevels) / sizeof(smartAudioPowerLevels[0]));
+    }
+}
+
+bool VTXMSPBridge::begin(VTXTransport* port, uint32_t baud) {
+    if (!port || !_vtx) {
+        return false;
+    }
+
+    if (!port->open() || !port->configure(baud, VTX_FRAMING_8N1)) {
+        return false;
+    }
+
+    _port = port;
+    _parser.reset();
+    return true;
+}
+
+#ifdef ARDUINO
+bool VTXMSPBridge::begin(HardwareSerial* serial, int8_t rxPin, int8_t txPin, uint32_t baud) {
+    if (!serial) {
+        return false;
+    }
+
+    _serialTransport.attach(serial, txPin, rxPin);
+    return begin(&_serialTransport, baud);
+}
+#endif
+
+void VTXMSPBridge::setPowerLevels(const uint16_t* levelsMw, uint8_t count) {
+    if (count > MSP_BRIDGE_MAX_POWER_LEVELS) {
+        count = MSP_BRIDGE_MAX_POWER_LEVELS;
+    }
+    memcpy(_powerLevels, levelsMw, count * sizeof(uint16_t));
+    _powerLevelCount = count;
+}
+
+void VTXMSPBridge::update() {
+    if (!_port) {
+        return;
+    }
+
+    uint8_t rx[32];
+    size_t n;
+    while ((n = _port->read(rx, sizeof(rx))) > 0) {
+        for (size_t i = 0; i < n; i++) {
+            if (_parser.feed(rx[i]) && _parser.frame().direction == MSP_DIR_REQUEST) {
+#if BETAVTX_ENABLE_STATS
+                const unsigned long start = micros();
+                handleRequest(_parser.frame());
+                const uint32_t elapsed = micros() - start;
+                if (elapsed > _stats.maxServiceUs) {
+                    _stats.maxServiceUs = elapsed;
+                }
+#else
+                handleRequest(_parser.frame());
+#endif
+            }
+        }
+    }
+}
+
+void VTXMSPBridge::handleRequest(const MSPFrame& frame) {
+    switch (frame.cmd) {
+        case MSP_VTX_CONFIG:
+            sendVtxConfig();
+#if BETAVTX_ENABLE_STATS
+            _stats.reads++;
+#endif
+            break;
+
+        case MSP_SET_VTX_CONFIG:
+            applyVtxConfig(frame.payload, frame.size);
+            reply(MSP_DIR_RESPONSE, MSP_SET_VTX_CONFIG, nullptr, 0);
+#if BETAVTX_ENABLE_STATS
+            _stats.writes++;
+#endif
+            break;
+
+        default:
+            reply(MSP_DIR_ERROR, frame.cmd, nullptr, 0);
+#if BETAVTX_ENABLE_STATS
+            _stats.unsupported++;
+#endif
+            break;
+    }
+}
+
+void VTXMSPBridge::sendVtxConfig() {
+    // Seqlock snapshot, never blocks on the VTX link
+    const VTXState state = _vtx->getState();
+
+    uint8_t band = 0;
+    uint8_t channel = 0;
+    if (state.valid) {
+        vtxFrequencyToBandChannel(state.frequency, &band, &channel);
+    }
+
+    uint8_t payload[MSP_VTX_CONFIG_SIZE];
+    switch (_vtx->getProtocolType()) {
+        case VTX_PROTOCOL_TRAMP:    payload[0] = MSP_VTXDEV_TRAMP; break;
+        case VTX_PROTOCOL_MSP:      payload[0] = MSP_VTXDEV_MSP; break;
+        default:                    payload[0] = MSP_VTXDEV_SMARTAUDIO; break;
+    }
+    payload[1] = band;
+    payload[2] = channel;
+    payload[3] = powerIndex(state);
+    payload[4] = state.pitMode ? 1 : 0;
+    mspWriteU16(&payload[5], state.frequency);
+    payload[7] = (state.valid && _vtx->isReady()) ? 1 : 0;
+    payload[8] = 0;                         // Low power disarm: not managed here
+    mspWriteU16(&payload[9], 0);            // Pit mode frequency: unknown
+    payload[11] = 0;                        // No vtxtable served over MSP
+    payload[12] = VTX_MAX_BAND;
+    payload[13] = VTX_MAX_CHANNEL;
+    payload[14] = _powerLevelCount;
+
+    reply(MSP_DIR_RESPONSE, MSP_VTX_CONFIG, payload, sizeof(payload));
+}
+
+void VTXMSPBridge::applyVtxConfig(const uint8_t* payload, uint8_t size) {
+    if (size < 2) {
+        return;
+    }
+
+    const VTXState state = _vtx->getState();
+
+    // Betaflight layout: freq-or-bandchan, power, pit, lowPowerDisarm,
+    // pitModeFreq, band, channel, freq, ...
+    uint16_t freq = mspReadU16(payload);
+    if (freq <= MSP_VTX_BANDCHAN_MAX) {
+        freq = vtxBandChannelToFrequency(freq / VTX_MAX_CHANNEL + VTX_MIN_BAND,
+                                         freq % VTX_MAX_CHANNEL + VTX_MIN_CHANNEL);
+    }
+    if (size >= 11) {
+        const uint8_t band = payload[7];
+        const uint16_t newFreq = mspReadU16(&payload[9]);
+        if (band > 0) {
+            freq = vtxBandChannelToFrequency(band, payload[8]);
+        } else if (newFreq > 0) {
+            freq = newFreq;
+        }
+    }
+
+    // OSDs re-send their whole config; only forward actual changes so the
+    // slow VTX link isn't flooded with redundant set commands
+    if (freq != 0 && isChange(VTX_FIELD_FREQUENCY, freq, state.frequency, state.valid)) {
+        _vtx->setFrequency(freq);
+    }
+
+    if (size >= 4) {
+        const uint8_t index = payload[2];
+        if (index >= 1 && index <= _powerLevelCount &&
+            isChange(VTX_FIELD_POWER, index, powerIndex(state), state.valid)) {
+            _vtx->setPower(_powerLevels[index - 1]);
+        }
+
+        const bool pitMode = payload[3] != 0;
+        if (isChange(VTX_FIELD_PIT_MODE, pitMode, state.pitMode, state.valid)) {
+            _vtx->setPitMode(pitMode);
+        }
+    }
+}
+
+bool VTXMSPBridge::isChange(VTXStateField field, uint16_t wanted, uint16_t current, bool valid) {
+    const int8_t slot = field == VTX_FIELD_FREQUENCY ? 0 : (field == VTX_FIELD_POWER ? 1 : 2);
+    VTXProtocol* protocol = _vtx->getProtocol();
+
+    // Same value already on its way to the VTX, or sent on a TX-only link
+    if (protocol && _forwarded[slot] == wanted) {
+        const VTXCommandResult result = protocol->getCommandResult(field);
+        if (result == VTX_RESULT_PENDING || result == VTX_RESULT_UNCONFIRMED) {
+            return false;
+        }
+    }
+    if (valid && current == wanted) {
+        return false;
+    }
+
+    _forwarded[slot] = wanted;
+    return true;
+}
+
+uint8_t VTXMSPBridge::powerIndex(const VTXState& state) const {
+    if (!state.valid || _powerLevelCount == 0) {
+        return 0;
+    }
+
+    // Closest configured level, 1-based
+    uint8_t best = 0;
+    uint16_t bestDiff = UINT16_MAX;
+    for (uint8_t i = 0; i < _powerLevelCount; i++) {
+        const uint16_t diff = state.power > _powerLevels[i] ? state.power - _powerLevels[i]
+                                                            : _powerLevels[i] - state.power;
+        if (diff < bestDiff) {
+            bestDiff = diff;
+            best = i;
+        }
+    }
+    return best + 1;
+}
+
+void VTXMSPBridge::reply(uint8_t direction, uint8_t cmd, const uint8_t* payload, uint8_t size) {
+    uint8_t frame[MSP_VTX_CONFIG_SIZE + MSP_FRAME_OVERHEAD];
+    const uint8_t len = mspEncode(direction, cmd, payload, size, frame, sizeof(frame));
+    if (len > 0) {
+        _port->write(frame, len);
+    }
+}
@@ -0,0 +1,112 @@
+/**
+ * @file VTXMSPBridge.h
+ * @brief MSP responder serving cached VTX state to flight controllers and OSDs
+ *
+ * Runs on a second UART next to the VTX link. MSP_VTX_CONFIG is answered
+ * straight from the last state reported by the VTX (no round trip on the
+ * 4800/9600 baud link), MSP_SET_VTX_CONFIG is forwarded to the
+ * BetaVTXControl setters and acknowledged immediately; the change is
+ * confirmed on the VTX link in the background.
+ *
+ * Call update() from the same task as BetaVTXControl::update(), since
+ * writes go through the (single-task) setters.
+ */
+
+#ifndef VTXMSPBRIDGE_H
+#define VTXMSPBRIDGE_H
+
+#include "BetaVTXControl.h"
+#include "MSPCodec.h"
+
+#define MSP_BRIDGE_DEFAULT_BAUD     115200
+#define MSP_BRIDGE_MAX_POWER_LEVELS 8
+
+// Betaflight vtxDevType_e values reported in MSP_VTX_CONFIG
+#define MSP_VTXDEV_SMARTAUDIO       3
+#define MSP_VTXDEV_TRAMP            4
+#define MSP_VTXDEV_MSP              5
+#define MSP_VTXDEV_UNKNOWN          0xFF
+
+
+class VTXMSPBridge {
+public:
+    struct Statistics {
+        uint32_t reads;             // MSP_VTX_CONFIG answered
+        uint32_t writes;            // MSP_SET_VTX_CONFIG forwarded
+        uint32_t unsupported;       // Requests answered with an error frame
+        uint32_t maxServiceUs;      // Longest time from complete request to queued reply
+    };
+
+    /**
+     * @param vtx Controller whose state is served and whose setters receive writes
+     */
+    explicit VTXMSPBridge(BetaVTXControl* vtx);
+
+    /**
+     * @brief Start serving MSP on a transport
+     * @param port Transport connected to the FC/OSD
+     * @param baud MSP baud rate
+     * @return true if the port could be opened
+     */
+    bool begin(VTXTransport* port, uint32_t baud = MSP_BRIDGE_DEFAULT_BAUD);
+
+#ifdef ARDUINO
+    /**
+     * @brief Start serving MSP on a HardwareSerial port
+     * @param serial Port connected to the FC/OSD (e.g. &Serial1)
+     * @param rxPin RX pin number
+     * @param txPin TX pin number
+     * @param baud MSP baud rate
+     * @return true if the port could be opened
+     */
+    bool begin(HardwareSerial* serial, int8_t rxPin, int8_t txPin,
+               uint32_t baud = MSP_BRIDGE_DEFAULT_BAUD);
+#endif
+
+    /**
+     * @brief Parse pending MSP bytes and answer complete requests
+     *
+     * Never waits on the VTX link; replies are queued on the MSP port.
+     */
+    void update();
+
+    /**
+     * @brief Map MSP power indexes (1-based) to mW
+     *
+     * Defaults follow the protocol: SmartAudio 25/200/400/600/800 mW,
+     * TRAMP 25/100/200/400/600 mW.
+     *
+     * @param levelsMw Power in mW for index 1, 2, ...
+     * @param count Number of levels (max MSP_BRIDGE_MAX_POWER_LEVELS)
+     */
+    void setPowerLevels(const uint16_t* levelsMw, uint8_t count);
+
+#if BETAVTX_ENABLE_STATS
+    Statistics getStatistics() const { return _stats; }
+#endif
+
+private:
+    BetaVTXControl* _vtx;
+    VTXTransport* _port = nullptr;
+#ifdef ARDUINO
+    HardwareSerialTransport _serialTransport;
+#endif
+
+    MSPParser _parser;
+    uint16_t _powerLevels[MSP_BRIDGE_MAX_POWER_LEVELS];
+    uint8_t _powerLevelCount = 0;
+    uint16_t _forwarded[VTX_COMMAND_SLOTS] = {};  // Last frequency, power index, pit sent
+
+#if BETAVTX_ENABLE_STATS
+    Statistics _stats = {0, 0, 0, 0};
+#endif
+
+    void handleRequest(const MSPFrame& frame);
+    void sendVtxConfig();
+    void applyVtxConfig(const uint8_t* payload, uint8_t size);
+    bool isChange(VTXStateField field, uint16_t wanted, uint16_t current, bool valid);
+    void reply(uint8_t direction, uint8_t cmd, const uint8_t* payload, uint8_t size);
+    uint8_t powerIndex(const VTXState& state) const;
+};
+
+#endif // VTXMSPBRIDGE_H
@@ -0,0 +1,135 @@
+/**
+ * @file VTXPlatform.h
+ * @brief Platform glue for building the protocol engines on Arduino or a host
+ *
+ * On Arduino this simply pulls in <Arduino.h>. On a POSIX host (Linux ground
+ * stations, emulators) it provides the small subset of the Arduino core the
+ * library relies on: millis()/micros()/delay() and a minimal Print class.
+ */
+
+#ifndef VTXPLATFORM_H
+#define VTXPLATFORM_H
+
+#include "VTXConfig.h"
+
+#ifdef ARDUINO
+
+#include <Arduino.h>
+#include <HardwareSerial.h>
+
+#else // Host build
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#ifndef DEC
+#define DEC 10
+#endif
+#ifndef HEX
+#define HEX 16
+#endif
+
+#ifdef BETAVTX_HOST_VIRTUAL_CLOCK
+// Simulations (benchmarks, emulated links) define and advance this clock
+// themselves, so runs are deterministic and faster than real time
+extern uint64_t vtxHostVirtualUs;
+
+inline uint64_t vtxHostMonotonicUs() { return vtxHostVirtualUs; }
+#else
+inline uint64_t vtxHostMonotonicUs() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)(ts.tv_nsec / 1000);
+}
+#endif
+
+inline unsigned long micros() { return (unsigned long)vtxHostMonotonicUs(); }
+inline unsigned long millis() { return (unsigned long)(vtxHostMonotonicUs() / 1000ULL); }
+
+#ifdef BETAVTX_HOST_VIRTUAL_CLOCK
+inline void delayMicroseconds(unsigned int us) { vtxHostVirtualUs += us; }
+inline void delay(unsigned long ms) { vtxHostVirtualUs += (uint64_t)ms * 1000ULL; }
+#else
+inline void delayMicroseconds(unsigned int us) {
+    struct timespec ts;
+    ts.tv_sec = us / 1000000U;
+    ts.tv_nsec = (long)(us % 1000000U) * 1000L;
+    nanosleep(&ts, nullptr);
+}
+
+inline void delay(unsigned long ms) {
+    struct timespec ts;
+    ts.tv_sec = ms / 1000UL;
+    ts.tv_nsec = (long)(ms % 1000UL) * 1000000L;
+    nanosleep(&ts, nullptr);
+}
+#endif
+
+/**
+ * @brief Minimal stand-in for the Arduino Print class
+ *
+ * Only what the library itself uses for debug output is implemented.
+ */
+class Print {
+public:
+    virtual ~Print() {}
+
+    virtual size_t write(uint8_t c) = 0;
+    virtual size_t write(const uint8_t* buf, size_t len) {
+        size_t n = 0;
+        while (len--) {
+            n += write(*buf++);
+        }
+        return n;
+    }
+
+    size_t print(const char* s) { return s ? write((const uint8_t*)s, strlen(s)) : 0; }
+    size_t print(char c) { return write((uint8_t)c); }
+    size_t print(unsigned char n, int base = DEC) { return print((unsigned long)n, base); }
+    size_t print(int n, int base = DEC) { return print((long)n, base); }
+    size_t print(unsigned int n, int base = DEC) { return print((unsigned long)n, base); }
+    size_t print(long n, int base = DEC) {
+        if (n < 0 && base == DEC) {
+            return print('-') + print((unsigned long)-n, base);
+        }
+        return print((unsigned long)n, base);
+    }
+    size_t print(unsigned long n, int base = DEC) {
+        char buf[24];
+        snprintf(buf, sizeof(buf), base == HEX ? "%lX" : "%lu", n);
+        return print(buf);
+    }
+    size_t print(double n, int digits = 2) {
+        char buf[32];
+        snprintf(buf, sizeof(buf), "%.*f", digits, n);
+        return print(buf);
+    }
+
+    size_t println() { return print("\n"); }
+    template <typename T>
+    size_t println(T v) { return print(v) + println(); }
+    template <typename T>
+    size_t println(T v, int fmt) { return print(v, fmt) + println(); }
+};
+
+/**
+ * @brief Print adapter writing to a stdio stream (stdout/stderr/file)
+ */
+class StdioPrint : public Print {
+public:
+    explicit StdioPrint(FILE* stream = stdout) : _stream(stream) {}
+
+    size_t write(uint8_t c) override { return fputc(c, _stream) == EOF ? 0 : 1; }
+    size_t write(const uint8_t* buf, size_t len) override { return fwrite(buf, 1, len, _stream); }
+
+private:
+    FILE* _stream;
+};
+
+#endif // ARDUINO
+
+#endif // VTXPLATFORM_H
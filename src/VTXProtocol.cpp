@@ -0,0 +1,657 @@
+/**
+ * @file VTXProtocol.cpp
+ * @brief Shared state caching and change notification for VTX protocols
+ */
+
+#include "VTXProtocol.h"
+
+bool VTXProtocol::addStateListener(VTXStateCallback callback, void* context, uint8_t fieldMask) {
+    if (!callback) {
+        return false;
+    }
+    
+    for (uint8_t i = 0; i < VTX_MAX_STATE_LISTENERS; i++) {
+        if (!_listeners[i].callback) {
+            _listeners[i].callback = callback;
+            _listeners[i].context = context;
+            _listeners[i].fieldMask = fieldMask;
+            return true;
+        }
+    }
+    return false;
+}
+
+bool VTXProtocol::hasFreeListenerSlot() const {
+    for (uint8_t i = 0; i < VTX_MAX_STATE_LISTENERS; i++) {
+        if (!_listeners[i].callback) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void VTXProtocol::removeStateListener(VTXStateCallback callback, void* context) {
+    for (uint8_t i = 0; i < VTX_MAX_STATE_LISTENERS; i++) {
+        if (_listeners[i].callback == callback && _listeners[i].context == context) {
+            _listeners[i].callback = nullptr;
+        }
+    }
+}
+
+void VTXProtocol::startSafeBoot() {
+    _safeBootPending = true;
+    _safeBootSending = true;
+    setPitMode(true);
+    _safeBootSending = false;
+    
+    if (!_safeBootStats.firstFrameUs) {
+        _safeBootStats.firstFrameUs = micros() - _beginUs;
+    }
+}
+
+void VTXProtocol::linkReady(uint8_t mismatched) {
+    if (_linkState != VTX_LINK_RESTORING) {
+        return;
+    }
+    
+    _restoreFields = mismatched & _requestedFields;
+    if (_restoreFields == 0) {
+        linkUp();
+        return;
+    }
+    
+    debugPrintln("[VTX] Device is back, restoring settings");
+    restoreSettings(_restoreFields);
+}
+
+void VTXProtocol::linkDown() {
+    _linkStats.linkDowns++;
+    _restoreFields = 0;
+    setLinkState(VTX_LINK_DOWN);
+    debugPrintln("[VTX] Link down, probing");
+    linkLost();
+}
+
+void VTXProtocol::linkUp() {
+    const uint32_t recoveryMs = millis() - _restoreStartMs;
+    _linkStats.lastRecoveryMs = recoveryMs;
+    if (recoveryMs > _linkStats.maxRecoveryMs) {
+        _linkStats.maxRecoveryMs = recoveryMs;
+    }
+    
+    // The device was gone, the misses that ruled out fast profiles proved nothing
+    _profileLocked = false;
+    _profileStrikes = 0;
+    updateProfile();
+    
+    setLinkState(VTX_LINK_UP);
+}
+
+void VTXProtocol::setLinkState(VTXLinkState state) {
+    if (state == _linkState) {
+        return;
+    }
+    recordEvent(VTX_REC_LINK, state, _linkState);
+    _linkState = state;
+    if (_linkCallback) {
+        _linkCallback(state, _linkContext);
+    }
+}
+
+void VTXProtocol::suspend() {
+    if (_suspended || !_transport) {
+        return;
+    }
+    _suspended = true;
+    
+    // Their deadlines are on this line's timeline, which another engine now owns
+    for (uint8_t i = 0; i < VTX_SCHEDULE_SLOTS; i++) {
+        _scheduled[i].pending = false;
+    }
+    _scheduleHold = false;
+    
+#if BETAVTX_ENABLE_RX
+    // _rxEventDriven stays set so resume() registers again
+    if (_rxEventDriven) {
+        _transport->setReceiveCallback(nullptr, nullptr);
+    }
+#endif
+    
+    // The reply to the last request will never be seen, don't count it as missed
+    _rttArmed = false;
+    _rttAmbiguous = false;
+    _linkMisses = 0;
+    _linkDownPending = false;
+    _restoreFields = 0;
+}
+
+bool VTXProtocol::resume() {
+    if (!_suspended) {
+        return true;
+    }
+    if (!openTransport(_baud, _framing)) {
+        return false;
+    }
+    _suspended = false;
+    
+#if BETAVTX_ENABLE_RX
+    // Whatever arrived meanwhile was meant for the other protocol
+    VTXRxFrame frame;
+    while (_rxQueue.pop(frame)) {
+    }
+    uint8_t buf[VTX_RX_FRAME_MAX];
+    while (_transport->read(buf, sizeof(buf)) > 0) {
+    }
+    resetRxParser();
+    if (_rxEventDriven && !_transport->setReceiveCallback(receiveCallback, this)) {
+        _rxEventDriven = false;
+    }
+#endif
+    
+    // The VTX on the line may have been swapped: probe it as after begin()
+    setLinkState(VTX_LINK_UNKNOWN);
+    linkLost();
+    return true;
+}
+
+void VTXProtocol::updateProfile() {
+    const VTXRttEstimator::Statistics rtt = _rtt.getStatistics();
+    _device.responseUs = (rtt.samples >= VTX_PROFILE_MIN_SAMPLES) ? rtt.srttUs + 4 * rtt.rttvarUs : 0;
+    
+    const VTXDeviceProfile* profile = vtxFindProfile(_profiles, _profileCount, _device, !_profileLocked);
+    if (profile == _profile) {
+        return;
+    }
+    _profile = profile;
+    
+#if BETAVTX_ENABLE_DEBUG
+    if (_debugSerial) {
+        _debugSerial->print("[VTX] Timing profile: ");
+        _debugSerial->println(profile->name);
+    }
+#endif
+}
+
+void VTXProtocol::publishState(const VTXState& state) {
+    const VTXState old = _state;
+    _state = state;
+    _state.valid = true;
+    _published.write(_state);
+    
+    // First valid state is reported as a change from zero
+    if (old.frequency != _state.frequency) {
+        notify(VTX_FIELD_FREQUENCY, old.frequency, _state.frequency);
+    }
+    if (old.power != _state.power) {
+        notify(VTX_FIELD_POWER, old.power, _state.power);
+    }
+    if (old.pitMode != _state.pitMode || !old.valid) {
+        notify(VTX_FIELD_PIT_MODE, old.pitMode, _state.pitMode);
+    }
+    if (old.temperature != _state.temperature) {
+        notify(VTX_FIELD_TEMPERATURE, old.temperature, _state.temperature);
+    }
+    if (old.actualPower != _state.actualPower) {
+        notify(VTX_FIELD_ACTUAL_POWER, old.actualPower, _state.actualPower);
+    }
+}
+
+void VTXProtocol::notify(VTXStateField field, int32_t oldValue, int32_t newValue) {
+    for (uint8_t i = 0; i < VTX_MAX_STATE_LISTENERS; i++) {
+        const StateListener& l = _listeners[i];
+        if (l.callback && (l.fieldMask & field)) {
+            l.callback(field, oldValue, newValue, l.context);
+        }
+    }
+}
+
+int8_t VTXProtocol::commandSlot(VTXStateField field) {
+    switch (field) {
+        case VTX_FIELD_FREQUENCY:   return 0;
+        case VTX_FIELD_POWER:       return 1;
+        case VTX_FIELD_PIT_MODE:    return 2;
+        default:                    return -1;
+    }
+}
+
+VTXCommandResult VTXProtocol::getCommandResult(VTXStateField field) const {
+    const int8_t slot = commandSlot(field);
+    return slot >= 0 ? _commands[slot].result() : VTX_RESULT_NONE;
+}
+
+void VTXProtocol::beginCommand(VTXStateField field) {
+    const int8_t slot = commandSlot(field);
+    if (slot < 0) {
+        return;
+    }
+    
+    _commands[slot].begin(millis(), _retryPolicy);
+    _requestedFields |= field;
+    recordEvent(VTX_REC_COMMAND, field, VTX_RESULT_PENDING);
+    
+    // The user took over pit mode
+    if (field == VTX_FIELD_PIT_MODE && !_safeBootSending) {
+        _safeBootPending = false;
+    }
+    
+    // Without RX the change can never be confirmed, don't pretend otherwise
+    if (!BETAVTX_ENABLE_RX || !_transport || !_transport->hasRx()) {
+        finishCommand(field, VTX_RESULT_UNCONFIRMED);
+    }
+}
+
+void VTXProtocol::commandSent(VTXStateField field) {
+    const int8_t slot = commandSlot(field);
+    if (slot >= 0) {
+        _commands[slot].sent(millis(), _responseTimeoutMs);
+    }
+}
+
+void VTXProtocol::commandAwaitingReply(uint8_t fields, uint32_t timeoutMs) {
+    static const VTXStateField slots[VTX_COMMAND_SLOTS] = {
+        VTX_FIELD_FREQUENCY, VTX_FIELD_POWER, VTX_FIELD_PIT_MODE
+    };
+    
+    const uint32_t now = millis();
+    for (uint8_t i = 0; i < VTX_COMMAND_SLOTS; i++) {
+        if (fields & slots[i]) {
+            _commands[i].rearm(now, timeoutMs);
+        }
+    }
+}
+
+void VTXProtocol::finishCommand(VTXStateField field, VTXCommandResult result) {
+    const int8_t slot = commandSlot(field);
+    if (slot < 0 || !_commands[slot].isPending()) {
+        return;
+    }
+    
+    _commands[slot].finish(result);
+    commandFinished(field, result);
+}
+
+bool VTXProtocol::commandPending(VTXStateField field) const {
+    const int8_t slot = commandSlot(field);
+    return slot >= 0 && _commands[slot].isPending();
+}
+
+void VTXProtocol::serviceCommands() {
+    static const VTXStateField fields[VTX_COMMAND_SLOTS] = {
+        VTX_FIELD_FREQUENCY, VTX_FIELD_POWER, VTX_FIELD_PIT_MODE
+    };
+    
+    if (_linkDownPending) {
+        _linkDownPending = false;
+        linkDown();
+    }
+    
+    const uint32_t now = millis();
+    for (uint8_t i = 0; i < VTX_COMMAND_SLOTS; i++) {
+        VTXRetryTracker& cmd = _commands[i];
+        if (!cmd.isPending()) {
+            continue;
+        }
+        
+        if (cmd.update(now)) {
+            commandFinished(fields[i], cmd.result());
+        } else if (cmd.resendDue(now)) {
+            recordEvent(VTX_REC_RETRY, fields[i], cmd.attempts());
+            cmd.resendQueued();
+            resendCommand(fields[i]);
+        }
+    }
+}
+
+void VTXProtocol::commandFinished(VTXStateField field, VTXCommandResult result) {
+    recordEvent(VTX_REC_COMMAND, field, result);
+    
+    if (_commandCallback) {
+        _commandCallback(field, result, _commandContext);
+    }
+    
+    if (field == VTX_FIELD_PIT_MODE && _safeBootPending) {
+        if (result == VTX_RESULT_CONFIRMED) {
+            _safeBootStats.confirmedUs = micros() - _beginUs;
+            _safeBootPending = false;
+        } else if (result == VTX_RESULT_FAILED_RETRIES || result == VTX_RESULT_FAILED_DEADLINE) {
+            // VTX may still be booting: start over with a fresh retry budget
+            startSafeBoot();
+        } else {
+            _safeBootPending = false;
+        }
+    }
+    
+    if (_restoreFields & field) {
+        if (result == VTX_RESULT_CONFIRMED) {
+            _restoreFields &= ~field;
+            if (_restoreFields == 0 && _linkState == VTX_LINK_RESTORING) {
+                linkUp();
+            }
+        } else {
+            _linkStats.restoreFailures++;
+            if (result == VTX_RESULT_FAILED_RETRIES || result == VTX_RESULT_FAILED_DEADLINE) {
+                // Answers queries but loses sets: probe again, the next readback restores
+                linkDown();
+            }
+            // Otherwise (rejected, taken over by a sweep) the link stays restoring
+            // until a later command for the field is confirmed
+        }
+    }
+    
+    // Move matching waiters over; they are resumed at the end of update(),
+    // outside the response parser
+    VTXCommandWaiter** link = &_waiters;
+    while (*link) {
+        VTXCommandWaiter* waiter = *link;
+        if (waiter->field == field) {
+            *link = waiter->next;
+            waiter->result = result;
+            waiter->next = _finishedWaiters;
+            _finishedWaiters = waiter;
+        } else {
+            link = &waiter->next;
+        }
+    }
+}
+
+void VTXProtocol::addCommandWaiter(VTXCommandWaiter* waiter) {
+    waiter->result = VTX_RESULT_PENDING;
+    waiter->next = _waiters;
+    _waiters = waiter;
+}
+
+void VTXProtocol::removeCommandWaiter(VTXCommandWaiter* waiter) {
+    VTXCommandWaiter** lists[] = { &_waiters, &_finishedWaiters };
+    for (uint8_t i = 0; i < 2; i++) {
+        VTXCommandWaiter** link = lists[i];
+        while (*link) {
+            if (*link == waiter) {
+                *link = waiter->next;
+                return;
+            }
+            link = &(*link)->next;
+        }
+    }
+}
+
+void VTXProtocol::resumeCommandWaiters() {
+    // A resumed waiter may start new commands and add waiters, so unlink first
+    while (_finishedWaiters) {
+        VTXCommandWaiter* waiter = _finishedWaiters;
+        _finishedWaiters = waiter->next;
+        waiter->next = nullptr;
+        waiter->resume(waiter);
+    }
+}
+
+void VTXProtocol::update(uint32_t budgetUs) {
+    const uint32_t startUs = micros();
+    _budgetEndUs = startUs + budgetUs;
+    _budgeted = true;
+    
+    // Frames wait in the TX FIFO instead of in flush()
+    const bool blocking = _blockingTx;
+    _blockingTx = false;
+    update();
+    _blockingTx = blocking;
+    _budgeted = false;
+    
+    const uint32_t elapsed = micros() - startUs;
+    _updateCalls++;
+    _updateTotalUs += elapsed;
+    if (elapsed > _updateMaxUs) {
+        _updateMaxUs = elapsed;
+    }
+    if (elapsed > budgetUs) {
+        _updateOverruns++;
+    }
+}
+
+VTXUpdateStatistics VTXProtocol::getUpdateStatistics() const {
+    VTXUpdateStatistics stats = {};
+    stats.calls = _updateCalls;
+    stats.maxUs = _updateMaxUs;
+    stats.overruns = _updateOverruns;
+    if (_updateCalls > 0) {
+        stats.avgUs = (uint32_t)(_updateTotalUs / _updateCalls);
+    }
+    return stats;
+}
+
+void VTXProtocol::resetUpdateStatistics() {
+    _updateCalls = 0;
+    _updateMaxUs = 0;
+    _updateOverruns = 0;
+    _updateTotalUs = 0;
+}
+
+void VTXProtocol::adoptFrequency(uint16_t freq) {
+    finishCommand(VTX_FIELD_FREQUENCY, VTX_RESULT_UNCONFIRMED);
+    _requestedFields |= VTX_FIELD_FREQUENCY;
+    requestedFrequency(freq);
+}
+
+int8_t VTXProtocol::scheduleSlot(VTXStateField field) {
+    switch (field) {
+        case VTX_FIELD_FREQUENCY:   return 0;
+        case VTX_FIELD_PIT_MODE:    return 1;
+        default:                    return -1;
+    }
+}
+
+bool VTXProtocol::scheduleFrequency(uint16_t freq, uint32_t atUs) {
+    ScheduledCommand& cmd = _scheduled[scheduleSlot(VTX_FIELD_FREQUENCY)];
+    cmd.pending = false;
+    return schedule(VTX_FIELD_FREQUENCY, freq,
+                    encodeFrequencyFrame(freq, cmd.frame, VTX_SCHEDULE_MAX_FRAME), atUs);
+}
+
+bool VTXProtocol::schedulePitMode(bool enable, uint32_t atUs) {
+    ScheduledCommand& cmd = _scheduled[scheduleSlot(VTX_FIELD_PIT_MODE)];
+    cmd.pending = false;
+    return schedule(VTX_FIELD_PIT_MODE, enable ? 1 : 0,
+                    encodePitModeFrame(enable, cmd.frame, VTX_SCHEDULE_MAX_FRAME), atUs);
+}
+
+bool VTXProtocol::schedule(VTXStateField field, uint16_t value, uint8_t length, uint32_t atUs) {
+    if (!_transport || length == 0) {
+        return false;
+    }
+    
+    // The deadline is the end of the frame, the spin aims at its start
+    const uint32_t startUs = atUs - wireTimeUs(length);
+    if ((int32_t)(startUs - micros()) < 0) {
+        return false;
+    }
+    
+    const int8_t slot = scheduleSlot(field);
+    ScheduledCommand& cmd = _scheduled[slot];
+    cmd.value = value;
+    cmd.length = length;
+    cmd.pending = true;
+    
+    VTXScheduleResult& result = _scheduleResults[slot];
+    result = VTXScheduleResult();
+    result.deadlineUs = atUs;
+    result.plannedStartUs = startUs;
+    return true;
+}
+
+void VTXProtocol::cancelSchedule(VTXStateField field) {
+    const int8_t slot = scheduleSlot(field);
+    if (slot >= 0) {
+        _scheduled[slot].pending = false;
+    }
+}
+
+bool VTXProtocol::isScheduled(VTXStateField field) const {
+    const int8_t slot = scheduleSlot(field);
+    return slot >= 0 && _scheduled[slot].pending;
+}
+
+VTXScheduleResult VTXProtocol::getScheduleResult(VTXStateField field) const {
+    const int8_t slot = scheduleSlot(field);
+    return slot >= 0 ? _scheduleResults[slot] : VTXScheduleResult();
+}
+
+bool VTXProtocol::serviceSchedule() {
+    static const VTXStateField fields[VTX_SCHEDULE_SLOTS] = { VTX_FIELD_FREQUENCY, VTX_FIELD_PIT_MODE };
+    
+    // Long enough for a request started just before to be sent and answered
+    const uint32_t holdUs = wireTimeUs(VTX_SCHEDULE_MAX_FRAME) + _responseTimeoutMs * 1000UL;
+    
+    bool holding = false;
+    for (uint8_t i = 0; i < VTX_SCHEDULE_SLOTS; i++) {
+        if (!_scheduled[i].pending) {
+            continue;
+        }
+        
+        // Bytes still in the TX FIFO go out first
+        const uint32_t startUs = _scheduleResults[i].plannedStartUs - wireTimeUs(_transport->txPending());
+        int32_t remaining = (int32_t)(startUs - micros());
+        const bool spinFits = !_budgeted || remaining <= (int32_t)(_budgetEndUs - micros());
+        if (remaining > BETAVTX_SCHEDULE_SPIN_US || (remaining > 0 && !spinFits)) {
+            if ((uint32_t)remaining <= holdUs) {
+                holding = true;
+            }
+            continue;
+        }
+        
+        // delayMicroseconds() busy-waits on the targets (and moves the host's virtual clock)
+        while (remaining > 0) {
+            delayMicroseconds(remaining);
+            remaining = (int32_t)(startUs - micros());
+        }
+        sendScheduled(fields[i]);
+    }
+    _scheduleHold = holding;
+    return holding;
+}
+
+void VTXProtocol::sendScheduled(VTXStateField field) {
+    const int8_t slot = scheduleSlot(field);
+    ScheduledCommand& cmd = _scheduled[slot];
+    VTXScheduleResult& result = _scheduleResults[slot];
+    cmd.pending = false;
+    
+    result.startUs = micros() + wireTimeUs(_transport->txPending());
+    _transport->write(cmd.frame, cmd.length);
+    result.startErrorUs = (int32_t)(result.startUs - result.plannedStartUs);
+    result.sent = true;
+    finishTx();
+    
+    debugPrintHex(cmd.frame, cmd.length, "Scheduled");
+#if BETAVTX_ENABLE_RECORDER
+    if (_recorder) {
+        _recorder->recordFrame(VTX_REC_TX, _device.family, 1, cmd.frame, cmd.length, result.startUs);
+    }
+#endif
+    scheduledCommandSent(field, cmd.value, cmd.length);
+}
+
+#if BETAVTX_ENABLE_RX
+bool VTXProtocol::setEventDrivenRx(bool enable) {
+    if (!_transport || !_transport->hasRx()) {
+        return false;
+    }
+    if (enable == _rxEventDriven) {
+        return true;
+    }
+    
+    if (!enable) {
+        _transport->setReceiveCallback(nullptr, nullptr);
+        _rxEventDriven = false;
+        return true;
+    }
+    
+    // The receive context owns the parser from here on
+    resetRxParser();
+    _rxEventDriven = true;
+    if (!_transport->setReceiveCallback(receiveCallback, this)) {
+        _rxEventDriven = false;
+        return false;
+    }
+    return true;
+}
+
+uint8_t VTXProtocol::serviceRx(uint8_t maxFrames) {
+    uint8_t frames = 0;
+    VTXRxFrame frame;
+    
+    // Also drains what is left after switching back to polling
+    while (frames < maxFrames && _rxQueue.pop(frame)) {
+        frames += dispatchRxFrame(frame);
+        if (budgetSpent()) {
+            return frames;
+        }
+    }
+    
+    if (_rxEventDriven || !_transport) {
+        return frames;
+    }
+    
+    // Byte by byte when limited, so bytes past the last wanted frame stay buffered
+    uint8_t buf[VTX_RX_FRAME_MAX];
+    const size_t chunk = (maxFrames == 0xFF) ? sizeof(buf) : 1;
+    size_t n;
+    while (frames < maxFrames && (n = _transport->read(buf, chunk)) > 0) {
+        for (size_t i = 0; i < n; i++) {
+            frame.event = parseRxByte(buf[i], frame);
+            if (frame.event != VTX_RX_NONE) {
+                frame.timeUs = micros();
+                frames += dispatchRxFrame(frame);
+            }
+        }
+        // The rest stays in the UART buffer for the next call
+        if (budgetSpent()) {
+            break;
+        }
+    }
+    return frames;
+}
+
+uint8_t VTXProtocol::dispatchRxFrame(const VTXRxFrame& frame) {
+    _rxTimeUs = frame.timeUs;
+#if BETAVTX_ENABLE_RECORDER
+    if (_recorder) {
+        _recorder->recordFrame(VTX_REC_RX, _device.family, frame.event, frame.data, frame.len, frame.timeUs);
+    }
+#endif
+    handleRxFrame(frame);
+    return frame.event == VTX_RX_FRAME ? 1 : 0;
+}
+
+void VTXProtocol::receiveCallback(void* context) {
+    static_cast<VTXProtocol*>(context)->receiveEvent();
+}
+
+void VTXProtocol::receiveEvent() {
+    uint8_t buf[VTX_RX_FRAME_MAX];
+    VTXRxFrame frame;
+    bool queued = false;
+    size_t n;
+    
+    while ((n = _transport->read(buf, sizeof(buf))) > 0) {
+        const uint32_t now = micros();
+        
+        // Replies are sent back to back; a long pause ends any partial frame
+        if (now - _rxLastReadUs > wireTimeUs(VTX_RX_RESYNC_GAP_BYTES)) {
+            resetRxParser();
+        }
+        _rxLastReadUs = now;
+        
+        for (size_t i = 0; i < n; i++) {
+            frame.event = parseRxByte(buf[i], frame);
+            if (frame.event != VTX_RX_NONE) {
+                frame.timeUs = now;
+                queued = _rxQueue.push(frame) || queued;
+            }
+        }
+    }
+    
+    const VTXReceiveCallback notify = _rxNotify;
+    if (queued && notify) {
+        notify(_rxNotifyContext);
+    }
+}
+#endif // BETAVTX_ENABLE_RX
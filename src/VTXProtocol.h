@@ -1,7 +1,7 @@
 /**
  * @file VTXProtocol.h
  * @brief Abstract base class for VTX protocol implementations
- * 
+ *
  * Based on Betaflight VTX control implementation
  * https://github.com/betaflight/betaflight
  */
@@ -9,13 +9,82 @@
 #ifndef VTXPROTOCOL_H
 #define VTXPROTOCOL_H
 
-#include <Arduino.h>
-#include <HardwareSerial.h>
+#include "VTXPlatform.h"
+#include "VTXTransport.h"
+#include "HardwareSerialTransport.h"
+#include "VTXState.h"
+#include "VTXSeqlock.h"
+#include "VTXSpscRing.h"
+#include "VTXRetry.h"
+#include "VTXRtt.h"
+#include "VTXTelemetry.h"
+#include "VTXRecorder.h"
+#include "VTXDeviceProfile.h"
+
+#define VTX_COMMAND_SLOTS   3   // Frequency, power, pit mode
+
+#define VTX_SCHEDULE_SLOTS      2   // Frequency, pit mode
+#define VTX_SCHEDULE_MAX_FRAME  20  // Longest request on the wire (TRAMP: VTX_MAX_DUMMY_BYTES + 16)
+
+#define VTX_RX_FRAME_MAX        24  // Largest SmartAudio/TRAMP/MSP VTX reply
+#define VTX_RX_NONE             0   // Frame incomplete
+#define VTX_RX_FRAME            1   // Complete frame, checksum OK; higher codes are protocol errors
+#define VTX_RX_RESYNC_GAP_BYTES 10  // Idle character times that restart the event-driven parser
+
+/**
+ * @brief Parser output handed from the receive context to update()
+ */
+struct VTXRxFrame {
+    uint32_t timeUs;    // micros() when the last byte was read
+    uint8_t event;      // VTX_RX_FRAME or a protocol specific error
+    uint8_t len;
+    uint8_t data[VTX_RX_FRAME_MAX];
+};
+
+#if BETAVTX_ENABLE_COROUTINES
+class VTXCommandAwaitable;
+#endif
 
 class VTXProtocol {
 public:
     virtual ~VTXProtocol() {}
-    
+
+    /**
+     * @brief Initialize VTX communication over any transport
+     * @param transport Byte transport (HardwareSerial adapter, ESP-IDF UART, POSIX tty)
+     * @param debugSerial Optional debug output for raw command dumps (default: nullptr)
+     * @return true if initialization successful
+     */
+    bool begin(VTXTransport* transport, Print* debugSerial = nullptr) {
+        if (!transport) {
+            return false;
+        }
+
+        _transport = transport;
+#if BETAVTX_ENABLE_DEBUG
+        _debugSerial = debugSerial;
+#else
+        (void)debugSerial;
+#endif
+        _beginUs = micros();
+        _safeBootStats = VTXSafeBootStatistics();
+#if BETAVTX_ENABLE_RX
+        // suspend() released the receive callback, begin() doesn't restore it
+        if (_suspended) {
+            _rxEventDriven = false;
+        }
+#endif
+        _suspended = false;
+        if (!start()) {
+            return false;
+        }
+        if (_safeBoot) {
+            startSafeBoot();
+        }
+        return true;
+    }
+
+#ifdef ARDUINO
     /**
      * @brief Initialize VTX communication (TX-only mode)
      * @param serial Pointer to HardwareSerial port
@@ -23,32 +92,687 @@ public:
      * @param debugSerial Optional debug serial port for raw command output (default: nullptr)
      * @return true if initialization successful
      */
-    virtual bool begin(HardwareSerial* serial, uint8_t txPin, HardwareSerial* debugSerial = nullptr) = 0;
-    
+    bool begin(HardwareSerial* serial, uint8_t txPin, Print* debugSerial = nullptr) {
+        if (!serial) {
+            return false;
+        }
+
+        _serialTransport.attach(serial, txPin);
+        return begin(&_serialTransport, debugSerial);
+    }
+#endif
+
     virtual void update() = 0;
-    virtual bool isReady() = 0;
     
+    /**
+     * @brief update() that yields once budgetUs has been spent
+     *
+     * Work goes in priority order: a scheduled command that is due, received
+     * frames, retries and the handshake, then status polling and new frames.
+     * What is left over waits for the next call: the frame parsers keep
+     * their state, unread bytes stay in the UART buffer, and frames are
+     * handed to the TX FIFO without waiting for it to drain, as with
+     * setBlockingTx(false). The scheduled command spin only runs if it fits.
+     * A call overruns by at most one step, e.g. one chunk of received bytes.
+     */
+    void update(uint32_t budgetUs);
+    
+    /**
+     * @return Worst case and average run time of update(budgetUs)
+     */
+    VTXUpdateStatistics getUpdateStatistics() const;
+    void resetUpdateStatistics();
+    
+    virtual bool isReady() = 0;
+
     /**
      * @param freq Frequency in MHz
      */
     virtual bool setFrequency(uint16_t freq) = 0;
-    
+
     /**
      * @param power Power level in mW
      */
     virtual bool setPower(uint16_t power) = 0;
-    
+
     /**
      * @param enable true to enable pit mode
      */
     virtual bool setPitMode(bool enable) = 0;
+    
+    /**
+     * @brief Put the VTX into pit mode from begin(), ahead of any handshake
+     *
+     * Call before begin(). The pit-on frame goes out as soon as the port is
+     * open and is repeated until the VTX confirms it, retry policy after retry
+     * policy; TX-only links send it once. Calling setPitMode() ends safe boot.
+     */
+    void setSafeBoot(bool enable) { _safeBoot = enable; }
+    
+    /**
+     * @return Time from begin() to the pit-on frame and to its confirmation
+     */
+    VTXSafeBootStatistics getSafeBootStatistics() const { return _safeBootStats; }
+    
+    /**
+     * @brief Change the frequency at a given time instead of now
+     *
+     * The set frame is encoded right away. From one request and one reply
+     * timeout before its start, update() sends nothing new (polls, retries
+     * and setter calls wait for the hold to end) but still handles replies,
+     * so the line is idle; within BETAVTX_SCHEDULE_SPIN_US of the start it
+     * busy-waits and transmits so that the last byte leaves the wire at
+     * atUs. After that the change is tracked like setFrequency(). Replaces
+     * an earlier schedule.
+     *
+     * @param atUs micros() time the frame must be complete
+     * @return false if the frame can't be encoded or its start has already passed
+     */
+    bool scheduleFrequency(uint16_t freq, uint32_t atUs);
+    
+    /**
+     * @brief Enter or leave pit mode at a given time, see scheduleFrequency()
+     *
+     * Holds the line the same way: setters called during the hold wait for it to end.
+     */
+    bool schedulePitMode(bool enable, uint32_t atUs);
+    
+    /**
+     * @param field VTX_FIELD_FREQUENCY or VTX_FIELD_PIT_MODE
+     */
+    void cancelSchedule(VTXStateField field);
+    bool isScheduled(VTXStateField field) const;
+    
+    /**
+     * @brief Start time achieved by the field's last scheduled command
+     */
+    VTXScheduleResult getScheduleResult(VTXStateField field) const;
+    
+    /**
+     * @brief Send a scheduled command that is due; update() calls it first
+     *
+     * Call it from a faster loop than update() if update() may not run
+     * within BETAVTX_SCHEDULE_SPIN_US of a start. Same task as update().
+     * While the line is held, update() still handles replies and retry
+     * timers but sends nothing new.
+     *
+     * @return true while the line is held for a scheduled command
+     */
+    bool serviceSchedule();
+    
+    /**
+     * @brief Set deadline, retry count and backoff used for subsequent set commands
+     */
+    void setRetryPolicy(const VTXRetryPolicy& policy) { _retryPolicy = policy; }
+    
+    /**
+     * @brief Result of the most recent set command for a field
+     * @param field VTX_FIELD_FREQUENCY, VTX_FIELD_POWER or VTX_FIELD_PIT_MODE
+     */
+    VTXCommandResult getCommandResult(VTXStateField field) const;
+    
+    /**
+     * @brief Register a callback fired when a set command is confirmed or fails
+     */
+    void setCommandCallback(VTXCommandCallback callback, void* context = nullptr) {
+        _commandCallback = callback;
+        _commandContext = context;
+    }
+    
+    /**
+     * @brief Wait for the current set command of waiter->field to finish
+     *
+     * waiter->resume is called from a later update() with waiter->result
+     * set. A newer command for the same field replaces the one waited on.
+     * The waiter must stay valid until resumed or removed.
+     */
+    void addCommandWaiter(VTXCommandWaiter* waiter);
+    
+    /**
+     * @brief Stop waiting (e.g. the waiting coroutine is destroyed)
+     */
+    void removeCommandWaiter(VTXCommandWaiter* waiter);
+    
+#if BETAVTX_ENABLE_COROUTINES
+    /**
+     * @brief Awaitable set commands, resumed by update() on confirmation or failure
+     *
+     *   VTXCommandResult r = co_await vtx.setFrequencyAsync(5732);
+     *
+     * See VTXAwait.h.
+     */
+    VTXCommandAwaitable setFrequencyAsync(uint16_t freq);
+    VTXCommandAwaitable setPowerAsync(uint16_t power);
+    VTXCommandAwaitable setPitModeAsync(bool enable);
+#endif
+    
+#if BETAVTX_ENABLE_RX
+    /**
+     * @brief Parse replies in the UART receive callback instead of update()
+     *
+     * Frames are decoded as soon as their last byte lands and handed to
+     * update() through a lock-free queue, together with their arrival time
+     * for the RTT estimate. While enabled only the transport's event task
+     * reads the port. Call from the task running update().
+     *
+     * @return false if the transport has no receive callback (polling stays on)
+     */
+    bool setEventDrivenRx(bool enable);
+    bool isEventDrivenRx() const { return _rxEventDriven; }
+    
+    /**
+     * @brief Called from the receive context after a frame was queued
+     *
+     * Use it to wake the task running update() so new state is applied
+     * without waiting for the next loop pass. It runs in a task, not an
+     * ISR, so e.g. xTaskNotifyGive() can be called directly.
+     */
+    void setRxNotify(VTXReceiveCallback notify, void* context = nullptr) {
+        _rxNotifyContext = context;
+        _rxNotify = notify;
+    }
+    
+    /**
+     * @return Frames dropped because update() fell behind the receive callback
+     */
+    uint32_t getRxOverruns() const { return _rxQueue.overruns(); }
+#endif
+    
+    /**
+     * @return Smoothed round-trip estimate used to derive timeouts and request gaps
+     */
+    VTXRttEstimator::Statistics getRttStatistics() const { return _rtt.getStatistics(); }
+    
+    /**
+     * @return Link supervisor state (down after VTX_LINK_DOWN_TIMEOUTS missed replies)
+     */
+    VTXLinkState getLinkState() const { return _linkState; }
+    
+    /**
+     * @brief Register a callback fired from update() when the link state changes
+     */
+    void setLinkCallback(VTXLinkCallback callback, void* context = nullptr) {
+        _linkCallback = callback;
+        _linkContext = context;
+    }
+    
+    /**
+     * @param timeouts Replies missed in a row before the link counts as down
+     */
+    void setLinkDownThreshold(uint8_t timeouts) { _linkDownThreshold = timeouts ? timeouts : 1; }
+    
+    /**
+     * @brief Release the transport so another engine can share it
+     *
+     * Scheduled commands are cancelled and the receive callback is
+     * released. Cached state, device info, RTT estimate, statistics,
+     * listeners and set commands still pending are kept. Don't call
+     * update() or the setters until resume().
+     */
+    void suspend();
+    
+    /**
+     * @brief Take the transport back after suspend()
+     *
+     * Re-applies only the line settings (no port restart where the transport
+     * supports it), drops bytes received meanwhile and probes the device
+     * again like after begin(), without discarding cached state. The link
+     * state goes back to VTX_LINK_UNKNOWN until the first reply.
+     *
+     * @return false if the line settings could not be applied
+     */
+    bool resume();
+    
+    bool isSuspended() const { return _suspended; }
+    
+    /**
+     * @return Link-down count and time taken to restore settings after the device came back
+     */
+    VTXLinkStatistics getLinkStatistics() const { return _linkStats; }
+    
+    /**
+     * @brief Try a custom device profile table before the built-in one
+     *
+     * The table must outlive this object. Entries are tried in order and
+     * the first match wins; devices matching none use the built-in table.
+     *
+     * @param profiles Table, nullptr for the built-in profiles only
+     * @param count Number of entries
+     */
+    void setDeviceProfiles(const VTXDeviceProfile* profiles, uint8_t count) {
+        _profiles = profiles;
+        _profileCount = profiles ? count : 0;
+        updateProfile();
+    }
+    
+    /**
+     * @return Timing profile the link currently runs with
+     */
+    const VTXDeviceProfile& getDeviceProfile() const { return *_profile; }
+    
+    /**
+     * @return Fingerprint collected from the device's replies so far
+     */
+    const VTXDeviceInfo& getDeviceInfo() const { return _device; }
+    
+    /**
+     * @brief Attach a telemetry history fed with temperature, output power and link errors
+     * @param history History owned by the caller, nullptr to detach
+     */
+    void setTelemetry(VTXTelemetryHistory* history) { _telemetry = history; }
+    VTXTelemetryHistory* getTelemetry() const { return _telemetry; }
+    
+#if BETAVTX_ENABLE_RECORDER
+    /**
+     * @brief Log frames, missed replies, command results and state changes
+     *
+     * Records are made in update() and the setters, see VTXRecorder.h.
+     * nullptr stops logging.
+     */
+    void setRecorder(VTXFlightRecorder* recorder) { _recorder = recorder; }
+    VTXFlightRecorder* getRecorder() const { return _recorder; }
+#endif
+    
+    /**
+     * @brief Encode a complete set-frequency frame as it goes on the wire
+     *
+     * Includes the dummy/stabilization bytes, so the result can be handed to
+     * transmitRaw() later without further processing.
+     *
+     * @param freq Frequency in MHz
+     * @param buf Output buffer
+     * @param maxLen Size of buf
+     * @return Number of bytes written, 0 if buf is too small
+     */
+    virtual uint8_t encodeFrequencyFrame(uint16_t freq, uint8_t* buf, uint8_t maxLen) = 0;
+    
+    /**
+     * @brief Encode a complete pit mode frame as it goes on the wire, see encodeFrequencyFrame()
+     */
+    virtual uint8_t encodePitModeFrame(bool enable, uint8_t* buf, uint8_t maxLen) = 0;
+    
+    /**
+     * @brief Queue pre-encoded bytes on the transport without waiting for TX to drain
+     * @return Number of bytes accepted
+     */
+    size_t transmitRaw(const uint8_t* buf, uint8_t len) {
+        return _transport ? _transport->write(buf, len) : 0;
+    }
+    
+    /**
+     * @return Bytes queued on the transport that have not gone out yet
+     */
+    size_t txPending() {
+        return _transport ? _transport->txPending() : 0;
+    }
+    
+    /**
+     * @brief Take over a frequency sent with transmitRaw() as the requested one
+     *
+     * Nothing is sent. A frequency command still pending finishes as
+     * VTX_RESULT_UNCONFIRMED, so neither its retries nor a later link
+     * restore send the old frequency again.
+     */
+    void adoptFrequency(uint16_t freq);
+    
+    /**
+     * @brief Choose whether frames wait for the UART to drain before returning
+     *
+     * Blocking (default) matches the original behaviour. Non-blocking lets a
+     * single event loop drive many links; frames are then only queued.
+     */
+    void setBlockingTx(bool blocking) { _blockingTx = blocking; }
+    
+    /**
+     * @return Time in microseconds needed to shift len bytes out at the link's baud rate
+     */
+    uint32_t wireTimeUs(uint16_t len) const {
+        if (_baud == 0) {
+            return 0;
+        }
+        const uint32_t bitsPerByte = (_framing == VTX_FRAMING_8N2) ? 11 : 10;
+        return (uint32_t)(((uint64_t)len * bitsPerByte * 1000000ULL) / _baud);
+    }
+    
+    /**
+     * @brief Snapshot of the last state reported by the VTX
+     *
+     * Safe to call from another core/task than the one running update():
+     * the snapshot is published through a sequence lock, so readers never
+     * see a half-updated frequency/power/pit/temperature tuple.
+     */
+    VTXState getState() const { return _published.read(); }
+    
+    /**
+     * @return Counter that changes whenever a new snapshot is published
+     */
+    uint32_t getStateVersion() const { return _published.version(); }
+    
+    uint16_t getFrequency() const { return getState().frequency; }
+    uint16_t getPower() const { return getState().power; }
+    bool getPitMode() const { return getState().pitMode; }
+    int16_t getTemperature() const { return getState().temperature; }
+    
+    /**
+     * @brief Register a callback fired from update() when a state field changes
+     * @param callback Function to call
+     * @param context User pointer passed back to the callback
+     * @param fieldMask Combination of VTXStateField bits to listen to
+     * @return false if all listener slots are taken
+     */
+    bool addStateListener(VTXStateCallback callback, void* context = nullptr,
+                          uint8_t fieldMask = VTX_FIELD_ALL);
+    
+    /// True if addStateListener() has a slot left
+    bool hasFreeListenerSlot() const;
+    
+    void removeStateListener(VTXStateCallback callback, void* context = nullptr);
 
 protected:
-    HardwareSerial* _serial = nullptr;
-    HardwareSerial* _debugSerial = nullptr;
-    uint8_t _txPin = 0;
-    
+    VTXTransport* _transport = nullptr;
+#if BETAVTX_ENABLE_DEBUG
+    Print* _debugSerial = nullptr;
+#endif
+
+#ifdef ARDUINO
+    HardwareSerialTransport _serialTransport;
+#endif
+
     bool _isReady = false;
+    uint32_t _baud = 0;
+    VTXFraming _framing = VTX_FRAMING_8N1;
+    bool _blockingTx = true;
+    
+    VTXRetryPolicy _retryPolicy = VTX_RETRY_POLICY_DEFAULT;
+    uint32_t _responseTimeoutMs = 200;      // Confirmation wait per attempt
+    
+    VTXRttEstimator _rtt;
+    
+    VTXState _state = {};      // Owned by the update() task
+    
+    VTXDeviceInfo _device = {};
+    const VTXDeviceProfile* _profile = &vtxDefaultProfiles[vtxDefaultProfileCount - 1];
+
+    /**
+     * @brief Protocol specific startup, called by begin() once the transport is set
+     * @return true if initialization successful
+     */
+    virtual bool start() = 0;
+
+    /**
+     * @brief Open and configure the transport, remembering the line settings
+     * @return true if the port is ready
+     */
+    bool openTransport(uint32_t baud, VTXFraming framing) {
+        if (!_transport->open() || !_transport->configure(baud, framing)) {
+            return false;
+        }
+        _baud = baud;
+        _framing = framing;
+        return true;
+    }
+    
+    /**
+     * @brief Whether an update(budgetUs) call has used up its time
+     *
+     * Engines check it between the steps of update() and return early.
+     */
+    bool budgetSpent() const {
+        return _budgeted && (int32_t)(micros() - _budgetEndUs) >= 0;
+    }
+    
+    /**
+     * @brief Whether the last serviceSchedule() kept the line idle for a scheduled command
+     *
+     * Engines hold back new requests meanwhile, replies are still handled.
+     */
+    bool scheduleHold() const { return _scheduleHold; }
+    
+    /**
+     * @brief Wait for queued bytes to leave the wire if TX is blocking
+     */
+    void finishTx() {
+        if (_blockingTx) {
+            _transport->flush();
+        }
+    }
+    
+    /**
+     * @brief Take over a scheduled frame that has just been transmitted
+     *
+     * Record value as the desired setting and track the command as if the
+     * setter had sent it.
+     *
+     * @param len Bytes sent, dummy bytes included
+     */
+    virtual void scheduledCommandSent(VTXStateField field, uint16_t value, uint8_t len) = 0;
+    
+    /**
+     * @brief Record freq as the desired frequency without sending or tracking anything
+     */
+    virtual void requestedFrequency(uint16_t freq) = 0;
+    
+    /**
+     * @brief Re-send the last command for a field after a timeout
+     */
+    virtual void resendCommand(VTXStateField field) = 0;
+    
+    /**
+     * @brief Start tracking a new set command; TX-only links finish as unconfirmed
+     */
+    void beginCommand(VTXStateField field);
+    
+    /**
+     * @brief Record that an attempt for the field's command went out
+     */
+    void commandSent(VTXStateField field);
+    
+    /**
+     * @brief Restart the confirmation wait of the attempts in flight for these fields
+     * @param fields VTXStateField bits
+     */
+    void commandAwaitingReply(uint8_t fields, uint32_t timeoutMs);
+    
+    /**
+     * @brief Finish a pending command with a result (confirmed, rejected, ...)
+     */
+    void finishCommand(VTXStateField field, VTXCommandResult result);
+    
+    bool commandPending(VTXStateField field) const;
+    
+    /**
+     * @brief Run retry timers and re-send timed-out commands; call from update()
+     *
+     * Also where a link-down found while sending is acted on.
+     */
+    void serviceCommands();
+    
+    /**
+     * @brief Resume waiters whose command finished; call at the end of update()
+     */
+    void resumeCommandWaiters();
+    
+    /**
+     * @brief Forget the fingerprint and link state of a previous device; call from start()
+     */
+    void resetDevice(VTXDeviceFamily family) {
+        _device = VTXDeviceInfo();
+        _device.family = family;
+        _profileStrikes = 0;
+        _profileLocked = false;
+        updateProfile();
+        
+        _linkState = VTX_LINK_UNKNOWN;
+        _linkMisses = 0;
+        _linkDownPending = false;
+        _restoreFields = 0;
+    }
+    
+    /**
+     * @brief The device stopped answering; restart detection from scratch
+     *
+     * It may come back reset to defaults, so cached device details are stale.
+     */
+    virtual void linkLost() = 0;
+    
+    /**
+     * @brief Re-send the last requested value of each field in the mask
+     */
+    virtual void restoreSettings(uint8_t fields) = 0;
+    
+    /**
+     * @brief Device state has been read again after a link-down
+     *
+     * Re-applies requested settings the device no longer has; the link is
+     * up again once those commands have finished.
+     *
+     * @param mismatched Fields whose readback differs from the last requested value
+     */
+    void linkReady(uint8_t mismatched);
+    
+    /**
+     * @brief Pick the fastest profile matching the fingerprint and measured RTT
+     */
+    void updateProfile();
+    
+    /**
+     * @return Zero bytes to send ahead of each frame
+     */
+    uint8_t dummyBytes() const {
+        return _profile->dummyBytes < VTX_MAX_DUMMY_BYTES ? _profile->dummyBytes : VTX_MAX_DUMMY_BYTES;
+    }
+    
+    /**
+     * @brief Mark that a request expecting a reply has finished transmitting
+     * @param len Frame length, used to find the end of TX when not blocking
+     */
+    void rttRequestSent(uint8_t len) {
+        // Previous request never got a reply
+        if (_rttArmed && _transport->hasRx()) {
+            recordTelemetry(VTX_METRIC_LINK_ERRORS, VTX_TELEMETRY_ERROR);
+            recordEvent(VTX_REC_TIMEOUT, 0);
+            
+            // A device that stops answering on a fast profile gets the conservative one for good
+            if (_profile->maxResponseUs && ++_profileStrikes >= VTX_PROFILE_MAX_STRIKES) {
+                _profileLocked = true;
+                updateProfile();
+            }
+            
+            // Acted on from serviceCommands(), not from inside a send
+            if (++_linkMisses >= _linkDownThreshold && _linkState != VTX_LINK_DOWN) {
+                _linkDownPending = true;
+            }
+        }
+        
+        // Karn: a second request before the reply makes the sample ambiguous
+        _rttAmbiguous = _rttArmed;
+        _rttArmed = true;
+        _rttSentUs = micros() + (_blockingTx ? 0 : wireTimeUs(len));
+    }
+    
+    /**
+     * @brief Complete a round trip on a valid reply
+     */
+    void rttResponseReceived() {
+        if (_rttArmed && !_rttAmbiguous) {
+#if BETAVTX_ENABLE_RX
+            // Arrival time of the frame, not when update() got to it
+            _rtt.sample(_rxTimeUs - _rttSentUs);
+#else
+            _rtt.sample(micros() - _rttSentUs);
+#endif
+        }
+        _rttArmed = false;
+        _rttAmbiguous = false;
+        recordTelemetry(VTX_METRIC_LINK_ERRORS, 0);
+        
+        _profileStrikes = 0;
+        updateProfile();
+        
+        _linkMisses = 0;
+        _linkDownPending = false;
+        if (_linkState == VTX_LINK_UNKNOWN) {
+            setLinkState(VTX_LINK_UP);
+        } else if (_linkState == VTX_LINK_DOWN) {
+            _restoreStartMs = millis();
+            setLinkState(VTX_LINK_RESTORING);
+        }
+    }
+    
+#if BETAVTX_ENABLE_RX
+    /**
+     * @brief Feed one received byte to the protocol's frame parser
+     *
+     * Runs in the transport's receive context when event-driven, so it
+     * must only touch parser state. A completed frame is copied to frame
+     * and applied later by handleRxFrame().
+     *
+     * @return VTX_RX_FRAME, a protocol error code, or VTX_RX_NONE while incomplete
+     */
+    virtual uint8_t parseRxByte(uint8_t c, VTXRxFrame& frame) = 0;
+    
+    /**
+     * @brief Drop a partially received frame
+     */
+    virtual void resetRxParser() = 0;
+    
+    /**
+     * @brief Apply a parsed frame or framing error; runs in update()
+     */
+    virtual void handleRxFrame(const VTXRxFrame& frame) = 0;
+    
+    /**
+     * @brief Parse received bytes (polling) or drain the event queue; call from update()
+     * @param maxFrames Stop after this many valid frames, later bytes stay buffered
+     * @return Valid frames handled
+     */
+    uint8_t serviceRx(uint8_t maxFrames = 0xFF);
+#endif
+    
+    /**
+     * @brief Feed the attached telemetry history, if any
+     */
+    void recordTelemetry(VTXTelemetryMetric metric, int16_t value) {
+        if (_telemetry) {
+            _telemetry->record(metric, value, millis());
+        }
+    }
+    
+    /**
+     * @brief Log a request to the attached flight recorder, if any
+     * @param buf Frame without dummy bytes
+     */
+    void recordTx(const uint8_t* buf, uint8_t len) {
+#if BETAVTX_ENABLE_RECORDER
+        if (_recorder) {
+            _recorder->recordFrame(VTX_REC_TX, _device.family, 0, buf, len, micros());
+        }
+#else
+        (void)buf;
+        (void)len;
+#endif
+    }
+    
+    /**
+     * @brief Log an event to the attached flight recorder, if any
+     */
+    void recordEvent(VTXRecordType type, uint8_t code, uint16_t value = 0) {
+#if BETAVTX_ENABLE_RECORDER
+        if (_recorder) {
+            _recorder->recordEvent(type, _device.family, code, value);
+        }
+#else
+        (void)type;
+        (void)code;
+        (void)value;
+#endif
+    }
+    
+    /**
+     * @brief Replace the cached state and notify listeners of changed fields
+     * @param state State decoded from the latest VTX response
+     */
+    void publishState(const VTXState& state);
     
     /**
      * @brief Print raw command in HEX format to debug serial
@@ -57,8 +781,9 @@ protected:
      * @param label Optional label (e.g., "SmartAudio", "TRAMP")
      */
     void debugPrintHex(const uint8_t* buf, uint8_t len, const char* label = "TX") {
+#if BETAVTX_ENABLE_DEBUG
         if (!_debugSerial) return;
-        
+
         _debugSerial->print("[");
         _debugSerial->print(label);
         _debugSerial->print("] ");
@@ -68,7 +793,116 @@ protected:
             if (i < len - 1) _debugSerial->print(" ");
         }
         _debugSerial->println();
+#else
+        (void)buf;
+        (void)len;
+        (void)label;
+#endif
+    }
+    
+    /**
+     * @brief Print a line to debug serial, compiled out with BETAVTX_ENABLE_DEBUG=0
+     */
+    void debugPrintln(const char* msg) {
+#if BETAVTX_ENABLE_DEBUG
+        if (_debugSerial) {
+            _debugSerial->println(msg);
+        }
+#else
+        (void)msg;
+#endif
     }
+
+private:
+    struct StateListener {
+        VTXStateCallback callback;
+        void* context;
+        uint8_t fieldMask;
+    };
+    StateListener _listeners[VTX_MAX_STATE_LISTENERS] = {};
+    VTXSeqlock<VTXState> _published;
+    
+    VTXRetryTracker _commands[VTX_COMMAND_SLOTS];
+    
+    uint32_t _rttSentUs = 0;
+    bool _rttArmed = false;
+    bool _rttAmbiguous = false;
+    VTXCommandCallback _commandCallback = nullptr;
+    void* _commandContext = nullptr;
+    VTXCommandWaiter* _waiters = nullptr;        // Command still pending
+    VTXCommandWaiter* _finishedWaiters = nullptr; // Result set, resumed by update()
+    VTXTelemetryHistory* _telemetry = nullptr;
+#if BETAVTX_ENABLE_RECORDER
+    VTXFlightRecorder* _recorder = nullptr;
+#endif
+    
+    const VTXDeviceProfile* _profiles = nullptr;
+    uint8_t _profileCount = 0;
+    uint8_t _profileStrikes = 0;
+    bool _profileLocked = false;    // Timing bound profiles ruled out after missed replies
+    
+    bool _safeBoot = false;
+    bool _safeBootPending = false;  // Pit-on not confirmed yet
+    bool _safeBootSending = false;  // setPitMode() call is our own
+    uint32_t _beginUs = 0;
+    VTXSafeBootStatistics _safeBootStats = {};
+    
+    VTXLinkState _linkState = VTX_LINK_UNKNOWN;
+    uint8_t _linkDownThreshold = VTX_LINK_DOWN_TIMEOUTS;
+    uint8_t _linkMisses = 0;
+    bool _linkDownPending = false;
+    uint8_t _requestedFields = 0;   // Fields set through a command since construction
+    uint8_t _restoreFields = 0;     // Restore commands still running
+    uint32_t _restoreStartMs = 0;
+    VTXLinkStatistics _linkStats = {};
+    VTXLinkCallback _linkCallback = nullptr;
+    void* _linkContext = nullptr;
+    
+    struct ScheduledCommand {
+        bool pending;
+        uint8_t length;
+        uint16_t value;
+        uint8_t frame[VTX_SCHEDULE_MAX_FRAME];
+    };
+    bool _suspended = false;
+    bool _budgeted = false;         // Inside update(budgetUs)
+    uint32_t _budgetEndUs = 0;
+    uint32_t _updateCalls = 0;
+    uint32_t _updateMaxUs = 0;
+    uint32_t _updateOverruns = 0;
+    uint64_t _updateTotalUs = 0;
+    
+    ScheduledCommand _scheduled[VTX_SCHEDULE_SLOTS] = {};
+    bool _scheduleHold = false;     // Set by serviceSchedule()
+    VTXScheduleResult _scheduleResults[VTX_SCHEDULE_SLOTS] = {};
+    
+#if BETAVTX_ENABLE_RX
+    VTXSpscRing<VTXRxFrame, BETAVTX_RX_FRAME_QUEUE_SIZE> _rxQueue;
+    volatile bool _rxEventDriven = false;
+    uint32_t _rxTimeUs = 0;         // Arrival of the frame being handled
+    uint32_t _rxLastReadUs = 0;     // Receive context
+    VTXReceiveCallback _rxNotify = nullptr;
+    void* _rxNotifyContext = nullptr;
+    
+    static void receiveCallback(void* context);
+    void receiveEvent();
+    uint8_t dispatchRxFrame(const VTXRxFrame& frame);
+#endif
+    
+    static int8_t commandSlot(VTXStateField field);
+    static int8_t scheduleSlot(VTXStateField field);
+    bool schedule(VTXStateField field, uint16_t value, uint8_t length, uint32_t atUs);
+    void sendScheduled(VTXStateField field);
+    void commandFinished(VTXStateField field, VTXCommandResult result);
+    void startSafeBoot();
+    void linkDown();
+    void linkUp();
+    void setLinkState(VTXLinkState state);
+    void notify(VTXStateField field, int32_t oldValue, int32_t newValue);
 };
 
+#if BETAVTX_ENABLE_COROUTINES
+#include "VTXAwait.h"
+#endif
+
 #endif // VTXPROTOCOL_H
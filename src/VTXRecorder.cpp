@@ -0,0 +1,188 @@
+/**
+ * @file VTXRecorder.cpp
+ * @brief Flight recorder: compact binary event log of a VTX link
+ */
+
+#include "VTXRecorder.h"
+
+bool VTXFlightRecorder::begin(VTXRecordSink* sink) {
+    if (!sink || sink->slots() == 0) {
+        return false;
+    }
+    end();
+
+    // Carry on after the newest file, whatever slot it is in
+    bool found = false;
+    uint32_t newest = 0;
+    uint16_t session = 0;
+    for (uint8_t slot = 0; slot < sink->slots(); slot++) {
+        VTXRecordFileHeader header;
+        if (sink->readSlot(slot, (uint8_t*)&header, sizeof(header)) != sizeof(header) ||
+            header.magic != VTX_RECORD_MAGIC) {
+            continue;
+        }
+        if (!found || (int32_t)(header.sequence - newest) > 0) {
+            newest = header.sequence;
+            session = header.session;
+            found = true;
+        }
+    }
+    _sequence = found ? newest + 1 : 0;
+    _session = found ? session + 1 : 0;
+
+    _sealed[0].store(0, std::memory_order_relaxed);
+    _sealed[1].store(0, std::memory_order_relaxed);
+    _active = 0;
+    _fill = 0;
+    _next = 0;
+    _seq = 0;
+    _stats = VTXRecorderStatistics();
+
+    _sink = sink;
+    if (!startFile()) {
+        _sink = nullptr;
+        return false;
+    }
+    return true;
+}
+
+void VTXFlightRecorder::end() {
+    if (!_sink) {
+        return;
+    }
+    sync();
+    service();
+    _sink->close();
+    _fileOpen = false;
+    _sink = nullptr;
+}
+
+VTXRecord* VTXFlightRecorder::nextRecord(VTXRecordType type, uint8_t source, uint8_t code) {
+    if (!_sink) {
+        return nullptr;
+    }
+
+    _stats.records++;
+    const uint16_t seq = _seq++;
+
+    // service() still owns this block: drop rather than wait for the file system
+    if (_sealed[_active].load(std::memory_order_acquire) != 0) {
+        _stats.dropped++;
+        return nullptr;
+    }
+
+    VTXRecord* record = &_blocks[_active][_fill];
+    record->seq = seq;
+    record->type = type;
+    record->source = source;
+    record->code = code;
+    return record;
+}
+
+void VTXFlightRecorder::recordFrame(VTXRecordType type, uint8_t source, uint8_t code,
+                                    const uint8_t* buf, uint8_t len, uint32_t timeUs) {
+    VTXRecord* record = nextRecord(type, source, code);
+    if (!record) {
+        return;
+    }
+
+    const uint8_t kept = len < VTX_RECORD_DATA_MAX ? len : VTX_RECORD_DATA_MAX;
+    record->timeUs = timeUs;
+    record->size = len;
+    record->value = 0;
+    memcpy(record->data, buf, kept);
+    memset(record->data + kept, 0, VTX_RECORD_DATA_MAX - kept);
+
+    if (++_fill == BETAVTX_RECORDER_BLOCK_RECORDS) {
+        sync();
+    }
+}
+
+void VTXFlightRecorder::recordEvent(VTXRecordType type, uint8_t source, uint8_t code, uint16_t value) {
+    VTXRecord* record = nextRecord(type, source, code);
+    if (!record) {
+        return;
+    }
+
+    record->timeUs = micros();
+    record->size = 0;
+    record->value = value;
+    memset(record->data, 0, VTX_RECORD_DATA_MAX);
+
+    if (++_fill == BETAVTX_RECORDER_BLOCK_RECORDS) {
+        sync();
+    }
+}
+
+void VTXFlightRecorder::sync() {
+    if (_fill == 0) {
+        return;
+    }
+    _sealed[_active].store(_fill, std::memory_order_release);
+    _active ^= 1;
+    _fill = 0;
+}
+
+uint8_t VTXFlightRecorder::service() {
+    if (!_sink) {
+        return 0;
+    }
+
+    uint8_t written = 0;
+    uint8_t count;
+    while ((count = _sealed[_next].load(std::memory_order_acquire)) != 0) {
+        const uint32_t bytes = (uint32_t)count * VTX_RECORD_SIZE;
+        const uint32_t startUs = micros();
+
+        bool ok = true;
+        if (!_fileOpen || _fileBytes + bytes > _maxFileBytes) {
+            ok = startFile();
+        }
+        if (ok && _sink->write((const uint8_t*)_blocks[_next], bytes)) {
+            _fileBytes += bytes;
+            _stats.blocks++;
+            written++;
+        } else {
+            _stats.writeErrors++;
+        }
+
+        const uint32_t writeUs = micros() - startUs;
+        if (writeUs > _stats.maxWriteUs) {
+            _stats.maxWriteUs = writeUs;
+        }
+
+        // Back to the recording task
+        _sealed[_next].store(0, std::memory_order_release);
+        _next ^= 1;
+    }
+    return written;
+}
+
+bool VTXFlightRecorder::startFile() {
+    if (_fileOpen) {
+        _sink->close();
+        _fileOpen = false;
+        _sequence++;
+    }
+
+    VTXRecordFileHeader header;
+    header.magic = VTX_RECORD_MAGIC;
+    header.version = VTX_RECORD_VERSION;
+    header.recordSize = VTX_RECORD_SIZE;
+    header.session = _session;
+    header.sequence = _sequence;
+    header.startMs = millis();
+
+    if (!_sink->openSlot(_sequence % _sink->slots())) {
+        return false;
+    }
+    if (!_sink->write((const uint8_t*)&header, sizeof(header))) {
+        // Truncated again by the next attempt
+        _sink->close();
+        return false;
+    }
+    _fileOpen = true;
+    _fileBytes = sizeof(header);
+    _stats.files++;
+    return true;
+}
@@ -0,0 +1,208 @@
+/**
+ * @file VTXRecorder.h
+ * @brief Flight recorder: compact binary event log of a VTX link
+ *
+ * Attach a recorder with VTXProtocol::setRecorder() and the engine logs
+ * every frame it sends and parses, missed replies, command results, link
+ * state changes and its handshake state machine as fixed-size records.
+ * Recording only copies 32 bytes into one of two RAM blocks. service()
+ * writes full blocks to a VTXRecordSink (a LittleFS/SPIFFS file on the
+ * target, a plain file on a host) from wherever slow I/O is acceptable,
+ * so RAM use is fixed at two blocks. While both blocks wait for the sink,
+ * new records are dropped and counted; their sequence numbers are
+ * skipped, so the gap shows in the log.
+ *
+ * Each file starts with a VTXRecordFileHeader. Files rotate through the
+ * sink's slots once they reach a size limit, overwriting the oldest one.
+ * Numbers are little-endian; examples/recorder-decode prints a log on a
+ * host.
+ */
+
+#ifndef VTXRECORDER_H
+#define VTXRECORDER_H
+
+#include <atomic>
+
+#include "VTXPlatform.h"
+
+#define VTX_RECORD_SIZE         32
+#define VTX_RECORD_DATA_MAX     20          // Frame bytes kept; longer frames are cut
+#define VTX_RECORD_MAGIC        0x52585456UL    // "VTXR"
+#define VTX_RECORD_VERSION      1
+
+#define VTX_RECORDER_FILE_BYTES 65536       // Default size at which a file is rotated
+
+enum VTXRecordType : uint8_t {
+    VTX_REC_TX = 1,     // Frame handed to the transport without dummy bytes (code 1: scheduled, with them)
+    VTX_REC_RX,         // Frame parsed at timeUs; code VTX_RX_FRAME or the protocol's parser error
+    VTX_REC_TIMEOUT,    // The last request got no reply, noticed when the next one is sent
+    VTX_REC_COMMAND,    // code VTXStateField, value VTXCommandResult (VTX_RESULT_PENDING when started)
+    VTX_REC_RETRY,      // Command resent: code VTXStateField, value attempts so far
+    VTX_REC_LINK,       // code new VTXLinkState, value the old one
+    VTX_REC_PHASE,      // Engine state machine: code new phase, value the old one (engine specific)
+    VTX_REC_MARK        // VTXFlightRecorder::mark() from the application
+};
+
+/**
+ * @brief One event, as stored in the log
+ */
+struct VTXRecord {
+    uint32_t timeUs;                // micros()
+    uint16_t seq;                   // One up per record, dropped ones included
+    uint8_t type;                   // VTXRecordType
+    uint8_t source;                 // VTXDeviceFamily of the engine, 0 for marks
+    uint8_t code;
+    uint8_t size;                   // Frame length; data holds up to VTX_RECORD_DATA_MAX bytes of it
+    uint16_t value;
+    uint8_t data[VTX_RECORD_DATA_MAX];
+};
+
+static_assert(sizeof(VTXRecord) == VTX_RECORD_SIZE, "VTXRecord must stay 32 bytes");
+
+/**
+ * @brief Start of every log file, followed by VTXRecord entries
+ */
+struct VTXRecordFileHeader {
+    uint32_t magic;                 // VTX_RECORD_MAGIC
+    uint8_t version;                // VTX_RECORD_VERSION
+    uint8_t recordSize;             // VTX_RECORD_SIZE
+    uint16_t session;               // One up per begin(), the files of one run share it
+    uint32_t sequence;              // One up per file, across sessions
+    uint32_t startMs;               // millis() when the file was started
+};
+
+static_assert(sizeof(VTXRecordFileHeader) == 16, "VTXRecordFileHeader must stay 16 bytes");
+
+/**
+ * @brief Storage for the log: a fixed set of file slots written in turn
+ *
+ * Only service(), begin() and end() of the recorder call it.
+ */
+class VTXRecordSink {
+public:
+    virtual ~VTXRecordSink() {}
+
+    /**
+     * @return Number of files the log rotates through
+     */
+    virtual uint8_t slots() const = 0;
+
+    /**
+     * @brief Read the start of a slot's file
+     * @return Bytes read, 0 if there is no such file
+     */
+    virtual size_t readSlot(uint8_t slot, uint8_t* buf, size_t len) = 0;
+
+    /**
+     * @brief Truncate a slot's file and open it for writing
+     */
+    virtual bool openSlot(uint8_t slot) = 0;
+
+    /**
+     * @return false unless all of buf was written to the open file
+     */
+    virtual bool write(const uint8_t* buf, size_t len) = 0;
+
+    /**
+     * @brief Close the open file, so what was written survives a power loss
+     */
+    virtual void close() = 0;
+};
+
+struct VTXRecorderStatistics {
+    uint32_t records;               // Recorded or dropped since begin()
+    uint32_t dropped;               // Both blocks were waiting for the sink
+    uint32_t blocks;                // Blocks written
+    uint32_t writeErrors;           // Blocks the sink failed to take; their records are lost
+    uint32_t files;                 // Files started
+    uint32_t maxWriteUs;            // Longest sink write of a block
+};
+
+class VTXFlightRecorder {
+public:
+    /**
+     * @param maxFileBytes A file is rotated before a block would take it past this size
+     */
+    explicit VTXFlightRecorder(uint32_t maxFileBytes = VTX_RECORDER_FILE_BYTES)
+        : _maxFileBytes(maxFileBytes) {}
+
+    /**
+     * @brief Start a new file after the newest one in the sink
+     * @return false if the sink could not open it
+     */
+    bool begin(VTXRecordSink* sink);
+
+    /**
+     * @brief Write what is left and close the file
+     *
+     * Call from the task that records, or once it has stopped.
+     */
+    void end();
+
+    bool isRecording() const { return _sink != nullptr; }
+
+    /**
+     * @brief Log a frame; called by the engines
+     *
+     * This and the other record calls must come from one task, the one
+     * running update(). They never block.
+     */
+    void recordFrame(VTXRecordType type, uint8_t source, uint8_t code,
+                     const uint8_t* buf, uint8_t len, uint32_t timeUs);
+
+    /**
+     * @brief Log an event without frame bytes; called by the engines
+     */
+    void recordEvent(VTXRecordType type, uint8_t source, uint8_t code, uint16_t value);
+
+    /**
+     * @brief Put a marker of your own into the log (arming, crash, button)
+     */
+    void mark(uint8_t code, uint16_t value = 0) { recordEvent(VTX_REC_MARK, 0, code, value); }
+
+    /**
+     * @brief Hand the partly filled block to service(), e.g. on disarm
+     *
+     * Call from the task that records.
+     */
+    void sync();
+
+    /**
+     * @brief Write full blocks to the sink, rotating files as needed
+     *
+     * This is where the file system is touched. Call it from loop() or a
+     * low-priority task; it may run concurrently with the record calls.
+     *
+     * @return Blocks written
+     */
+    uint8_t service();
+
+    VTXRecorderStatistics getStatistics() const { return _stats; }
+
+    /**
+     * @return Sequence number of the file being written
+     */
+    uint32_t getFileSequence() const { return _sequence; }
+
+private:
+    uint32_t _maxFileBytes;
+    VTXRecordSink* _sink = nullptr;
+    uint16_t _session = 0;
+    uint32_t _sequence = 0;
+    uint32_t _fileBytes = 0;
+    bool _fileOpen = false;
+
+    VTXRecord _blocks[2][BETAVTX_RECORDER_BLOCK_RECORDS];
+    std::atomic<uint8_t> _sealed[2] = {{0}, {0}};  // Records in a block handed to service(), 0 while filling
+    uint8_t _active = 0;            // Block being filled (recording task)
+    uint8_t _fill = 0;
+    uint8_t _next = 0;              // Block service() writes next
+    uint16_t _seq = 0;
+
+    VTXRecorderStatistics _stats = {};
+
+    VTXRecord* nextRecord(VTXRecordType type, uint8_t source, uint8_t code);
+    bool startFile();
+};
+
+#endif // VTXRECORDER_H
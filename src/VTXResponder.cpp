@@ -0,0 +1,386 @@
+/**
+ * @file VTXResponder.cpp
+ * @brief Device side of the SmartAudio, TRAMP and MSP VTX protocols
+ */
+
+#include "VTXResponder.h"
+#include "VTXBandTable.h"
+#include "SmartAudio.h"
+#include "TRAMP.h"
+#include "MSPVTX.h"
+
+#define VTX_RESPONDER_READ_CHUNK    32
+
+bool VTXResponder::begin(VTXTransport* transport) {
+    end();
+    if (!transport || !transport->open()) {
+        return false;
+    }
+    if (!transport->configure(_baud, _framing)) {
+        transport->close();
+        return false;
+    }
+
+    _transport = transport;
+    _byteUs = ((_framing == VTX_FRAMING_8N2) ? 11 : 10) * 1000000UL / _baud;
+    _stats = VTXResponderStatistics();
+    reset();
+    return true;
+}
+
+void VTXResponder::end() {
+    if (!_transport) {
+        return;
+    }
+    _transport->close();
+    _transport = nullptr;
+}
+
+void VTXResponder::update() {
+    if (!_transport) {
+        return;
+    }
+
+    uint8_t buf[VTX_RESPONDER_READ_CHUNK];
+    size_t n;
+    int pending;
+    while ((pending = _transport->available()) > 0 && (n = _transport->read(buf, sizeof(buf))) > 0) {
+        const uint32_t now = micros();
+        for (size_t i = 0; i < n; i++) {
+            // The last byte pending at the read arrived just before it, the others one character time apart
+            const size_t after = (size_t)pending > i ? pending - 1 - i : 0;
+            receive(buf[i], now - after * _byteUs);
+        }
+    }
+
+    const uint32_t now = micros();
+    while (_pendingCount > 0 && (int32_t)(now - _pending[0].dueUs) >= 0) {
+        _transport->write(_pending[0].data, _pending[0].len);
+        _stats.replies++;
+        _pendingCount--;
+        for (uint8_t i = 0; i < _pendingCount; i++) {
+            _pending[i] = _pending[i + 1];
+        }
+    }
+}
+
+void VTXResponder::reset() {
+    _freq = VTX_RESPONDER_DEFAULT_FREQ;
+    _powerIndex = 0;
+    _pit = false;
+    _pendingCount = 0;
+}
+
+void VTXResponder::reply(const uint8_t* buf, uint8_t len, uint32_t requestUs) {
+    if (_dropReplies > 0 || _pendingCount == VTX_RESPONDER_PENDING || len > VTX_RESPONDER_REPLY_MAX) {
+        if (_dropReplies > 0) {
+            _dropReplies--;
+        }
+        _stats.dropped++;
+        return;
+    }
+
+    PendingReply& slot = _pending[_pendingCount++];
+    slot.dueUs = requestUs + turnaroundUs();
+    slot.len = len;
+    memcpy(slot.data, buf, len);
+}
+
+uint32_t VTXResponder::turnaroundUs() {
+    // xorshift32
+    _rng ^= _rng << 13;
+    _rng ^= _rng >> 17;
+    _rng ^= _rng << 5;
+    return _turnaroundMinUs + _rng % (_turnaroundMaxUs - _turnaroundMinUs + 1);
+}
+
+#if BETAVTX_ENABLE_SMARTAUDIO
+
+static const uint8_t saDefaultPowerDbm[] = { 14, 23, 26, 28, 29 };
+
+SmartAudioResponder::SmartAudioResponder()
+    : VTXResponder(VTX_SMARTAUDIO_BAUD_4800, VTX_FRAMING_8N2, 2000, 6000) {
+    setPowerTable(saDefaultPowerDbm, sizeof(saDefaultPowerDbm));
+}
+
+void SmartAudioResponder::setPowerTable(const uint8_t* dbm, uint8_t count) {
+    if (count > VTX_RESPONDER_POWER_LEVELS) {
+        count = VTX_RESPONDER_POWER_LEVELS;
+    }
+    memcpy(_powerDbm, dbm, count);
+    _powerLevels = count;
+}
+
+void SmartAudioResponder::reset() {
+    VTXResponder::reset();
+    _parser.reset();
+    _channel = 0;
+    _freqMode = true;
+    _unlocked = true;
+}
+
+void SmartAudioResponder::receive(uint8_t c, uint32_t arrivalUs) {
+    const uint8_t event = _parser.feed(c);
+    if (event == VTX_RX_NONE) {
+        return;
+    }
+    if (event != VTX_RX_FRAME) {
+        _stats.errors++;
+        return;
+    }
+
+    const uint8_t* frame = _parser.frame();
+    if (!SmartAudioParser::isRequest(frame)) {
+        return;
+    }
+    _stats.requests++;
+    handle(frame[2] >> 1, &frame[4], frame[3], arrivalUs);
+}
+
+void SmartAudioResponder::handle(uint8_t cmd, const uint8_t* data, uint8_t len, uint32_t requestUs) {
+    uint8_t out[VTX_RESPONDER_REPLY_MAX];
+
+    switch (cmd) {
+        case SA_CMD_GET_SETTINGS: {
+            out[0] = _channel;
+            out[1] = _powerIndex;
+            out[2] = (_freqMode ? SA_MODE_GET_FREQ_MODE : 0) | (_pit ? SA_MODE_GET_PITMODE : 0) |
+                     (_pit ? SA_MODE_GET_IN_RANGE : 0) | (_unlocked ? SA_MODE_GET_UNLOCK : 0);
+            out[3] = _freq >> 8;
+            out[4] = _freq & 0xFF;
+            if (_version < 3) {
+                send(_version == 1 ? SA_CMD_GET_SETTINGS : SA_CMD_GET_SETTINGS_V2, out, 5, requestUs);
+                break;
+            }
+            // v2.1: current dBm, highest power index, dBm per index
+            out[5] = _pit ? 0 : _powerDbm[_powerIndex];
+            out[6] = _powerLevels - 1;
+            memcpy(&out[7], _powerDbm, _powerLevels);
+            send(SA_CMD_GET_SETTINGS_V21, out, 7 + _powerLevels, requestUs);
+            break;
+        }
+
+        case SA_CMD_SET_POWER:
+            if (len < 1) break;
+            _powerIndex = data[0] < _powerLevels ? data[0] : _powerLevels - 1;
+            out[0] = _powerIndex;
+            out[1] = 0x01;
+            send(SA_CMD_SET_POWER, out, 2, requestUs);
+            break;
+
+        case SA_CMD_SET_CHAN:
+            if (len < 1 || data[0] >= VTX_MAX_BAND * VTX_MAX_CHANNEL) break;
+            _channel = data[0];
+            _freqMode = false;
+            _freq = vtxDefaultFrequencyTable[_channel / VTX_MAX_CHANNEL][_channel % VTX_MAX_CHANNEL];
+            out[0] = _channel;
+            out[1] = 0x01;
+            send(SA_CMD_SET_CHAN, out, 2, requestUs);
+            break;
+
+        case SA_CMD_SET_FREQ: {
+            if (len < 2) break;
+            const uint16_t freq = (data[0] << 8) | data[1];
+            if (freq & SA_FREQ_GETPIT) {
+                out[0] = (SA_FREQ_GETPIT | _pitFreq) >> 8;
+                out[1] = _pitFreq & 0xFF;
+            } else {
+                _freq = freq;
+                _freqMode = true;
+                out[0] = data[0];
+                out[1] = data[1];
+            }
+            out[2] = 0x01;
+            send(SA_CMD_SET_FREQ, out, 3, requestUs);
+            break;
+        }
+
+        case SA_CMD_SET_MODE:
+            // Pit mode came with v2
+            if (len < 1 || _version < 2) break;
+            if (data[0] & SA_MODE_CLR_PITMODE) {
+                _pit = false;
+            } else if (data[0] & (SA_MODE_SET_IN_RANGE | SA_MODE_SET_OUT_RANGE)) {
+                _pit = true;
+            }
+            if (data[0] & SA_MODE_SET_UNLOCK) {
+                _unlocked = true;
+            }
+            out[0] = data[0];
+            out[1] = 0x01;
+            send(SA_CMD_SET_MODE, out, 2, requestUs);
+            break;
+    }
+}
+
+void SmartAudioResponder::send(uint8_t cmd, const uint8_t* data, uint8_t len, uint32_t requestUs) {
+    uint8_t buf[VTX_RESPONDER_REPLY_MAX];
+    if (len > VTX_RESPONDER_REPLY_MAX - 5) {
+        return;
+    }
+    buf[0] = SA_PREAMBLE_1;
+    buf[1] = SA_PREAMBLE_2;
+    buf[2] = cmd;
+    buf[3] = len;
+    memcpy(&buf[4], data, len);
+    buf[4 + len] = SmartAudioParser::crc8(buf, 4 + len);
+    reply(buf, 5 + len, requestUs);
+}
+
+#endif // BETAVTX_ENABLE_SMARTAUDIO
+
+#if BETAVTX_ENABLE_TRAMP
+
+TrampResponder::TrampResponder()
+    : VTXResponder(TRAMP_BAUD, VTX_FRAMING_8N1, 1000, 4000) {
+    // Queries share their code with the reply; set requests only come from the host
+    _parser.setAcceptRequests(true);
+}
+
+void TrampResponder::reset() {
+    VTXResponder::reset();
+    _parser.reset();
+    _power = 25;
+}
+
+void TrampResponder::receive(uint8_t c, uint32_t arrivalUs) {
+    const uint8_t event = _parser.feed(c);
+    if (event == VTX_RX_NONE) {
+        return;
+    }
+    if (event != VTX_RX_FRAME) {
+        _stats.errors++;
+        return;
+    }
+
+    const uint8_t* packet = _parser.frame();
+    if (!TrampParser::isRequest(packet)) {
+        return;
+    }
+    _stats.requests++;
+    handle(packet[1], packet[2] | (packet[3] << 8), arrivalUs);
+}
+
+void TrampResponder::handle(uint8_t code, uint16_t param, uint32_t requestUs) {
+    switch (code) {
+        case TRAMP_CMD_RESET:
+            send(TRAMP_CMD_RESET, _minFreq, _maxFreq, _maxPower, 0, requestUs);
+            break;
+        case TRAMP_CMD_STATUS:
+            send(TRAMP_CMD_STATUS, _freq, _power,
+                 (_raceLock ? TRAMP_CONTROL_RACE_LOCK : 0) | (_pit ? 0x0100 : 0), _pit ? 0 : _power, requestUs);
+            break;
+        case TRAMP_CMD_TEMP:
+            send(TRAMP_CMD_TEMP, 0, 0, (uint16_t)_temperature, 0, requestUs);
+            break;
+        case TRAMP_CMD_SET_FREQ:
+            if (!_raceLock && param >= _minFreq && param <= _maxFreq) {
+                _freq = param;
+            }
+            break;
+        case TRAMP_CMD_SET_POWER:
+            if (!_raceLock) {
+                _power = param < _maxPower ? param : _maxPower;
+            }
+            break;
+        case TRAMP_CMD_SET_ACTIVE:
+            _pit = param == 0;
+            break;
+    }
+}
+
+void TrampResponder::send(uint8_t code, uint16_t a, uint16_t b, uint16_t c, uint16_t d, uint32_t requestUs) {
+    uint8_t buf[TRAMP_PACKET_SIZE] = {
+        TRAMP_HEADER, code,
+        (uint8_t)a, (uint8_t)(a >> 8), (uint8_t)b, (uint8_t)(b >> 8),
+        (uint8_t)c, (uint8_t)(c >> 8), (uint8_t)d, (uint8_t)(d >> 8)
+    };
+    buf[14] = TrampParser::checksum(buf);
+    reply(buf, sizeof(buf), requestUs);
+}
+
+#endif // BETAVTX_ENABLE_TRAMP
+
+#if BETAVTX_ENABLE_MSP
+
+#define MSP_RESPONDER_VTXDEV        5       // vtxDevType_e VTXDEV_MSP
+#define MSP_RESPONDER_CONFIG_SIZE   15      // MSP_VTX_CONFIG up to the vtxtable sizes
+#define MSP_RESPONDER_MAX_FREQ      5999
+
+MSPResponder::MSPResponder()
+    : VTXResponder(MSP_VTX_BAUD, VTX_FRAMING_8N1, 500, 2000) {
+    _powerIndex = 1;
+}
+
+void MSPResponder::reset() {
+    VTXResponder::reset();
+    _parser.reset();
+    _powerIndex = 1;
+}
+
+void MSPResponder::receive(uint8_t c, uint32_t arrivalUs) {
+    const uint16_t checksumErrors = _parser.checksumErrors();
+    if (!_parser.feed(c)) {
+        if (_parser.checksumErrors() != checksumErrors) {
+            _stats.errors++;
+        }
+        return;
+    }
+
+    const MSPFrame& frame = _parser.frame();
+    if (frame.direction != MSP_DIR_REQUEST) {
+        return;
+    }
+    _stats.requests++;
+    handle(frame.cmd, frame.payload, frame.size, arrivalUs);
+}
+
+void MSPResponder::handle(uint8_t cmd, const uint8_t* data, uint8_t len, uint32_t requestUs) {
+    switch (cmd) {
+        case MSP_VTX_CONFIG: {
+            uint8_t band = 0;
+            uint8_t channel = 0;
+            vtxFrequencyToBandChannel(_freq, &band, &channel);
+            uint8_t payload[MSP_RESPONDER_CONFIG_SIZE] = {
+                MSP_RESPONDER_VTXDEV, band, channel, _powerIndex, (uint8_t)(_pit ? 1 : 0)
+            };
+            mspWriteU16(&payload[5], _freq);
+            payload[7] = 1;     // Ready
+            payload[11] = 1;    // vtxtable available: bands, channels, power levels
+            payload[12] = VTX_MAX_BAND;
+            payload[13] = VTX_MAX_CHANNEL;
+            payload[14] = _powerLevels;
+            send(MSP_VTX_CONFIG, payload, sizeof(payload), requestUs);
+            break;
+        }
+
+        case MSP_SET_VTX_CONFIG: {
+            if (len < 2) break;
+            // Band/channel index below 64, frequency in MHz above
+            const uint16_t freq = mspReadU16(data);
+            if (freq < VTX_MAX_BAND * VTX_MAX_CHANNEL) {
+                _freq = vtxBandChannelToFrequency(freq / VTX_MAX_CHANNEL + 1, freq % VTX_MAX_CHANNEL + 1);
+            } else if (freq <= MSP_RESPONDER_MAX_FREQ) {
+                _freq = freq;
+            }
+            if (len >= 3 && data[2] >= 1 && data[2] <= _powerLevels) {
+                _powerIndex = data[2];
+            }
+            if (len >= 4) {
+                _pit = data[3] != 0;
+            }
+            send(MSP_SET_VTX_CONFIG, nullptr, 0, requestUs);
+            break;
+        }
+    }
+}
+
+void MSPResponder::send(uint8_t cmd, const uint8_t* payload, uint8_t size, uint32_t requestUs) {
+    uint8_t buf[VTX_RESPONDER_REPLY_MAX];
+    const uint8_t len = mspEncode(MSP_DIR_RESPONSE, cmd, payload, size, buf, sizeof(buf));
+    if (len > 0) {
+        reply(buf, len, requestUs);
+    }
+}
+
+#endif // BETAVTX_ENABLE_MSP
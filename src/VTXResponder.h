@@ -0,0 +1,262 @@
+/**
+ * @file VTXResponder.h
+ * @brief Device side of the SmartAudio, TRAMP and MSP VTX protocols
+ *
+ * A responder stands in for a VTX: it decodes the host's requests with the
+ * engines' frame parsers, applies set commands at once and answers after a
+ * configurable turnaround time. Version, power table and limits are set
+ * before begin(). It runs over any VTXTransport, so the same code serves
+ * as a bench VTX on an ESP32 UART and as the device model of host
+ * simulations (see examples/latency-bench).
+ *
+ * Replies can be dropped on purpose to exercise the engines' retry path.
+ * Frames that are not requests, such as the echo of our own replies on a
+ * single-wire line, are ignored.
+ */
+
+#ifndef VTXRESPONDER_H
+#define VTXRESPONDER_H
+
+#include "VTXPlatform.h"
+#include "VTXTransport.h"
+#include "VTXFrameParser.h"
+#include "MSPCodec.h"
+
+#define VTX_RESPONDER_REPLY_MAX     32      // Largest reply: SmartAudio v2.1 settings with 8 power levels
+#define VTX_RESPONDER_PENDING       4       // Replies waiting for their turnaround time
+#define VTX_RESPONDER_POWER_LEVELS  8
+
+#define VTX_RESPONDER_DEFAULT_FREQ  5800
+
+/**
+ * @brief Request and reply counters since begin()
+ */
+struct VTXResponderStatistics {
+    uint32_t requests;
+    uint32_t replies;
+    uint32_t dropped;               // Replies lost on purpose or because too many were pending
+    uint32_t errors;                // Frames with a bad checksum, length or preamble
+};
+
+class VTXResponder {
+public:
+    virtual ~VTXResponder() {}
+
+    /**
+     * @brief Open the transport at the protocol's line settings and power on
+     * @return false if the transport could not be opened
+     */
+    bool begin(VTXTransport* transport);
+
+    void end();
+
+    /**
+     * @brief Decode received requests and send the replies that are due
+     *
+     * The turnaround is counted from the estimated arrival of a request's
+     * last byte, so call this at least once per turnaround time.
+     */
+    void update();
+
+    /**
+     * @brief Back to the settings of a freshly powered device
+     */
+    virtual void reset();
+
+    /**
+     * @brief Time from the end of a request to the start of its reply
+     *
+     * Each reply picks a pseudo-random time in [minUs, maxUs].
+     */
+    void setTurnaround(uint32_t minUs, uint32_t maxUs) {
+        _turnaroundMinUs = minUs;
+        _turnaroundMaxUs = maxUs < minUs ? minUs : maxUs;
+    }
+
+    void setSeed(uint32_t seed) { _rng = seed ? seed : 1; }
+
+    /**
+     * @brief Lose the next count replies (the commands themselves are still applied)
+     */
+    void dropReplies(uint8_t count) { _dropReplies = count; }
+
+    uint16_t getFrequency() const { return _freq; }
+    uint8_t getPowerIndex() const { return _powerIndex; }
+    bool getPitMode() const { return _pit; }
+
+    VTXResponderStatistics getStatistics() const { return _stats; }
+
+protected:
+    uint16_t _freq = VTX_RESPONDER_DEFAULT_FREQ;
+    uint8_t _powerIndex = 0;
+    bool _pit = false;
+    VTXResponderStatistics _stats = {};
+
+    VTXResponder(uint32_t baud, VTXFraming framing, uint32_t turnaroundMinUs, uint32_t turnaroundMaxUs)
+        : _baud(baud), _framing(framing),
+          _turnaroundMinUs(turnaroundMinUs), _turnaroundMaxUs(turnaroundMaxUs) {}
+
+    /**
+     * @brief Feed one received byte, arrived at arrivalUs
+     */
+    virtual void receive(uint8_t c, uint32_t arrivalUs) = 0;
+
+    /**
+     * @brief Queue a reply to a request whose last byte arrived at requestUs
+     */
+    void reply(const uint8_t* buf, uint8_t len, uint32_t requestUs);
+
+private:
+    struct PendingReply {
+        uint32_t dueUs;
+        uint8_t len;
+        uint8_t data[VTX_RESPONDER_REPLY_MAX];
+    };
+
+    VTXTransport* _transport = nullptr;
+    uint32_t _baud;
+    VTXFraming _framing;
+    uint32_t _byteUs = 0;
+    uint32_t _turnaroundMinUs;
+    uint32_t _turnaroundMaxUs;
+    uint32_t _rng = 1;
+    uint8_t _dropReplies = 0;
+
+    PendingReply _pending[VTX_RESPONDER_PENDING];   // Oldest first
+    uint8_t _pendingCount = 0;
+
+    uint32_t turnaroundUs();
+};
+
+#if BETAVTX_ENABLE_SMARTAUDIO
+
+/**
+ * @brief SmartAudio device at 4800 8N2
+ *
+ * Answers GET_SETTINGS in the configured version (v1, v2 or v2.1 with its
+ * dBm power list), SET_POWER, SET_CHAN, SET_FREQ (including the pit
+ * frequency query) and SET_MODE. Power goes by index in every version.
+ */
+class SmartAudioResponder : public VTXResponder {
+public:
+    SmartAudioResponder();
+
+    /**
+     * @param version 1, 2 or 3 for v2.1
+     */
+    void setVersion(uint8_t version) { _version = version; }
+
+    /**
+     * @brief Power levels and their output in dBm, reported by v2.1
+     *
+     * Default: 14, 23, 26, 28 and 29 dBm (25 to 800 mW). SET_POWER beyond
+     * the last level is clamped to it.
+     */
+    void setPowerTable(const uint8_t* dbm, uint8_t count);
+
+    void setPitFrequency(uint16_t freq) { _pitFreq = freq; }
+
+    void reset() override;
+
+protected:
+    void receive(uint8_t c, uint32_t arrivalUs) override;
+
+private:
+    SmartAudioParser _parser;
+    uint8_t _version = 2;
+    uint8_t _powerDbm[VTX_RESPONDER_POWER_LEVELS];
+    uint8_t _powerLevels = 0;
+    uint16_t _pitFreq = 5584;
+    uint8_t _channel = 0;
+    bool _freqMode = true;
+    bool _unlocked = true;
+
+    void handle(uint8_t cmd, const uint8_t* data, uint8_t len, uint32_t requestUs);
+    void send(uint8_t cmd, const uint8_t* data, uint8_t len, uint32_t requestUs);
+};
+
+#endif // BETAVTX_ENABLE_SMARTAUDIO
+
+#if BETAVTX_ENABLE_TRAMP
+
+/**
+ * @brief TRAMP device at 9600 8N1
+ *
+ * Answers the 'r' (limits), 'v' (status) and 's' (temperature) queries and
+ * applies 'F', 'P' and 'I', which are never answered.
+ */
+class TrampResponder : public VTXResponder {
+public:
+    TrampResponder();
+
+    /**
+     * @brief Limits reported by 'r'; power requests above maxPower are clamped
+     */
+    void setLimits(uint16_t minFreq, uint16_t maxFreq, uint16_t maxPower) {
+        _minFreq = minFreq;
+        _maxFreq = maxFreq;
+        _maxPower = maxPower;
+    }
+
+    void setTemperature(int16_t celsius) { _temperature = celsius; }
+
+    /**
+     * @brief Reject frequency and power changes, as after an unlock-less race lock
+     */
+    void setRaceLock(bool locked) { _raceLock = locked; }
+
+    uint16_t getPower() const { return _power; }
+
+    void reset() override;
+
+protected:
+    void receive(uint8_t c, uint32_t arrivalUs) override;
+
+private:
+    TrampParser _parser;
+    uint16_t _minFreq = 5600;
+    uint16_t _maxFreq = 5950;
+    uint16_t _maxPower = 600;
+    uint16_t _power = 25;
+    int16_t _temperature = 42;
+    bool _raceLock = false;
+
+    void handle(uint8_t code, uint16_t param, uint32_t requestUs);
+    void send(uint8_t code, uint16_t a, uint16_t b, uint16_t c, uint16_t d, uint32_t requestUs);
+};
+
+#endif // BETAVTX_ENABLE_TRAMP
+
+#if BETAVTX_ENABLE_MSP
+
+/**
+ * @brief VTX taking MSP VTX commands at 115200 8N1
+ *
+ * Answers MSP_VTX_CONFIG with a vtxtable of 5 bands and 8 channels and
+ * acknowledges MSP_SET_VTX_CONFIG.
+ */
+class MSPResponder : public VTXResponder {
+public:
+    MSPResponder();
+
+    /**
+     * @param levels vtxtable power levels; set requests beyond it are ignored
+     */
+    void setPowerLevels(uint8_t levels) { _powerLevels = levels; }
+
+    void reset() override;
+
+protected:
+    void receive(uint8_t c, uint32_t arrivalUs) override;
+
+private:
+    MSPParser _parser;
+    uint8_t _powerLevels = 5;
+
+    void handle(uint8_t cmd, const uint8_t* data, uint8_t len, uint32_t requestUs);
+    void send(uint8_t cmd, const uint8_t* payload, uint8_t size, uint32_t requestUs);
+};
+
+#endif // BETAVTX_ENABLE_MSP
+
+#endif // VTXRESPONDER_H
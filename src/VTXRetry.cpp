@@ -0,0 +1,91 @@
+/**
+ * @file VTXRetry.cpp
+ * @brief Shared retry policy for confirmed VTX commands
+ */
+
+#include "VTXRetry.h"
+
+void VTXRetryTracker::begin(uint32_t nowMs, const VTXRetryPolicy& policy) {
+    _policy = policy;
+    _result = VTX_RESULT_PENDING;
+    _attempts = 0;
+    _backoff = false;
+    _resendQueued = false;
+    _startMs = nowMs;
+    _finishedMs = nowMs;
+    _responseDeadline = nowMs;
+    _nextAttempt = nowMs;
+    _rng ^= micros();
+}
+
+void VTXRetryTracker::sent(uint32_t nowMs, uint32_t responseTimeoutMs) {
+    if (_result != VTX_RESULT_PENDING) {
+        return;
+    }
+
+    _attempts++;
+    _backoff = false;
+    _resendQueued = false;
+    _responseDeadline = nowMs + responseTimeoutMs;
+}
+
+void VTXRetryTracker::rearm(uint32_t nowMs, uint32_t responseTimeoutMs) {
+    if (_result != VTX_RESULT_PENDING || _attempts == 0 || _backoff) {
+        return;
+    }
+
+    _responseDeadline = nowMs + responseTimeoutMs;
+}
+
+bool VTXRetryTracker::update(uint32_t nowMs) {
+    if (_result != VTX_RESULT_PENDING) {
+        return false;
+    }
+
+    if ((int32_t)(nowMs - _startMs) >= (int32_t)_policy.deadlineMs) {
+        _result = VTX_RESULT_FAILED_DEADLINE;
+    } else if (_attempts > 0 && !_backoff && (int32_t)(nowMs - _responseDeadline) >= 0) {
+        // Attempt timed out without confirmation
+        if (_attempts > _policy.maxRetries) {
+            _result = VTX_RESULT_FAILED_RETRIES;
+        } else {
+            _backoff = true;
+            _nextAttempt = nowMs + backoffMs();
+        }
+    }
+
+    if (_result != VTX_RESULT_PENDING) {
+        _finishedMs = nowMs;
+        return true;
+    }
+    return false;
+}
+
+bool VTXRetryTracker::resendDue(uint32_t nowMs) const {
+    return _result == VTX_RESULT_PENDING && _backoff && !_resendQueued && (int32_t)(nowMs - _nextAttempt) >= 0;
+}
+
+uint32_t VTXRetryTracker::backoffMs() {
+    // initial * 2^(attempt-1), capped
+    uint32_t backoff = _policy.initialBackoffMs;
+    for (uint8_t i = 1; i < _attempts && backoff < _policy.maxBackoffMs; i++) {
+        backoff <<= 1;
+    }
+    if (backoff > _policy.maxBackoffMs) {
+        backoff = _policy.maxBackoffMs;
+    }
+
+    if (_policy.jitterPercent > 0 && backoff > 0) {
+        // xorshift32, good enough to decorrelate retries on a shared bench
+        _rng ^= _rng << 13;
+        _rng ^= _rng >> 17;
+        _rng ^= _rng << 5;
+
+        const uint32_t spread = backoff * _policy.jitterPercent / 100;
+        if (spread > 0) {
+            backoff = backoff - spread + (_rng % (2 * spread + 1));
+        }
+    }
+
+    return backoff;
+}
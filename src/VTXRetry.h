@@ -0,0 +1,120 @@
+/**
+ * @file VTXRetry.h
+ * @brief Shared retry policy for confirmed VTX commands
+ *
+ * Each set command gets an end-to-end deadline, a bounded number of
+ * retries and exponential backoff with jitter between attempts. The
+ * tracker always ends in an explicit result so callers know within a
+ * bounded time whether a change landed.
+ */
+
+#ifndef VTXRETRY_H
+#define VTXRETRY_H
+
+#include "VTXPlatform.h"
+#include "VTXState.h"
+
+struct VTXRetryPolicy {
+    uint16_t deadlineMs;        // Give up this long after the first attempt
+    uint8_t maxRetries;         // Re-sends after the first attempt
+    uint16_t initialBackoffMs;  // Wait after the first timeout, doubled per retry
+    uint16_t maxBackoffMs;
+    uint8_t jitterPercent;      // Random +/- spread applied to each backoff
+};
+
+#define VTX_RETRY_POLICY_DEFAULT    { 1000, 3, 40, 320, 25 }
+
+enum VTXCommandResult {
+    VTX_RESULT_NONE,                // No command issued yet
+    VTX_RESULT_PENDING,             // Waiting for confirmation
+    VTX_RESULT_CONFIRMED,           // VTX reported the requested value
+    VTX_RESULT_UNCONFIRMED,         // Sent on a TX-only link, can't be confirmed
+    VTX_RESULT_REJECTED,            // Not sent, device refuses it (e.g. race lock)
+    VTX_RESULT_FAILED_RETRIES,      // All retries timed out
+    VTX_RESULT_FAILED_DEADLINE      // Deadline expired before confirmation
+};
+
+/**
+ * @brief Called from update() when a tracked command reaches a final result
+ * @param field VTX_FIELD_FREQUENCY, VTX_FIELD_POWER or VTX_FIELD_PIT_MODE
+ * @param result Final result
+ * @param context User pointer given at registration
+ */
+typedef void (*VTXCommandCallback)(VTXStateField field, VTXCommandResult result, void* context);
+
+/**
+ * @brief Intrusive record for code waiting on a set command (see VTXAwait.h)
+ *
+ * Owned by the waiter; the protocol only links it into its lists, so
+ * waiting needs no allocation.
+ */
+struct VTXCommandWaiter {
+    VTXStateField field;
+    VTXCommandResult result;
+    void (*resume)(VTXCommandWaiter* waiter);   // Called from update() once result is final
+    VTXCommandWaiter* next;
+};
+
+class VTXRetryTracker {
+public:
+    /**
+     * @brief Start tracking a new command, replacing any previous one
+     */
+    void begin(uint32_t nowMs, const VTXRetryPolicy& policy);
+
+    /**
+     * @brief Record that an attempt went out
+     * @param responseTimeoutMs How long to wait for confirmation of this attempt
+     */
+    void sent(uint32_t nowMs, uint32_t responseTimeoutMs);
+
+    /**
+     * @brief Restart the confirmation wait of the attempt in flight, without counting
+     *        a new attempt (e.g. when the query that verifies it goes out)
+     */
+    void rearm(uint32_t nowMs, uint32_t responseTimeoutMs);
+
+    /**
+     * @brief Advance timers; detects timeouts, schedules backoff and final failure
+     * @return true if the result changed to a final state during this call
+     */
+    bool update(uint32_t nowMs);
+
+    /**
+     * @return true if the backoff after a timeout has elapsed and a re-send is allowed
+     */
+    bool resendDue(uint32_t nowMs) const;
+
+    /**
+     * @brief Record that a re-send was handed to the engine; no further resendDue()
+     *        until it goes out (engines hold it back while a reply is outstanding)
+     */
+    void resendQueued() { _resendQueued = true; }
+
+    void finish(VTXCommandResult result) { _result = result; }
+
+    VTXCommandResult result() const { return _result; }
+    bool isPending() const { return _result == VTX_RESULT_PENDING; }
+    uint8_t attempts() const { return _attempts; }
+
+    /**
+     * @return Milliseconds from the first attempt to the final result (or now)
+     */
+    uint32_t elapsedMs(uint32_t nowMs) const { return (isPending() ? nowMs : _finishedMs) - _startMs; }
+
+private:
+    VTXRetryPolicy _policy = VTX_RETRY_POLICY_DEFAULT;
+    VTXCommandResult _result = VTX_RESULT_NONE;
+    uint8_t _attempts = 0;
+    bool _backoff = false;
+    bool _resendQueued = false;
+    uint32_t _startMs = 0;
+    uint32_t _finishedMs = 0;
+    uint32_t _responseDeadline = 0;
+    uint32_t _nextAttempt = 0;
+    uint32_t _rng = 0x9E3779B9u;
+
+    uint32_t backoffMs();
+};
+
+#endif // VTXRETRY_H
@@ -0,0 +1,77 @@
+/**
+ * @file VTXRtt.h
+ * @brief Smoothed round-trip time estimator for a VTX link
+ *
+ * Jacobson/Karels style: SRTT and RTTVAR are updated from every
+ * unambiguous request/response pair, and the response timeout is
+ * SRTT + 4 * RTTVAR clamped to caller supplied limits.
+ */
+
+#ifndef VTXRTT_H
+#define VTXRTT_H
+
+#include "VTXPlatform.h"
+
+class VTXRttEstimator {
+public:
+    struct Statistics {
+        uint32_t srttUs;        // Smoothed round trip
+        uint32_t rttvarUs;      // Smoothed mean deviation
+        uint32_t lastUs;        // Most recent sample
+        uint32_t samples;
+    };
+
+    void reset() {
+        _srtt = 0;
+        _rttvar = 0;
+        _last = 0;
+        _samples = 0;
+    }
+
+    /**
+     * @brief Feed one measured round trip
+     */
+    void sample(uint32_t rttUs) {
+        _last = rttUs;
+        if (_samples == 0) {
+            _srtt = rttUs;
+            _rttvar = rttUs / 2;
+        } else {
+            const uint32_t err = rttUs > _srtt ? rttUs - _srtt : _srtt - rttUs;
+            _rttvar = (3 * _rttvar + err) / 4;
+            _srtt = (7 * _srtt + rttUs) / 8;
+        }
+        if (_samples < UINT32_MAX) {
+            _samples++;
+        }
+    }
+
+    bool hasSamples() const { return _samples > 0; }
+
+    /**
+     * @brief Response timeout derived from the estimate
+     * @param minUs Lower clamp
+     * @param maxUs Upper clamp
+     * @param initialUs Returned while no samples exist
+     */
+    uint32_t timeoutUs(uint32_t minUs, uint32_t maxUs, uint32_t initialUs) const {
+        if (_samples == 0) {
+            return initialUs;
+        }
+        const uint32_t rto = _srtt + 4 * _rttvar;
+        return rto < minUs ? minUs : (rto > maxUs ? maxUs : rto);
+    }
+
+    Statistics getStatistics() const {
+        Statistics stats = { _srtt, _rttvar, _last, _samples };
+        return stats;
+    }
+
+private:
+    uint32_t _srtt = 0;
+    uint32_t _rttvar = 0;
+    uint32_t _last = 0;
+    uint32_t _samples = 0;
+};
+
+#endif // VTXRTT_H
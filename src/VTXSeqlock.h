@@ -0,0 +1,83 @@
+/**
+ * @file VTXSeqlock.h
+ * @brief Single-writer sequence lock for publishing small POD snapshots
+ *
+ * The writer (the task calling update()) never blocks. Readers on any core
+ * copy the payload and retry if the sequence changed or was odd (write in
+ * progress) while they were copying, so they always see a consistent value.
+ */
+
+#ifndef VTXSEQLOCK_H
+#define VTXSEQLOCK_H
+
+#include <atomic>
+#include <type_traits>
+
+#include "VTXPlatform.h"
+
+template <typename T>
+class VTXSeqlock {
+    static_assert(std::is_trivially_copyable<T>::value, "VTXSeqlock payload must be trivially copyable");
+
+public:
+    VTXSeqlock() {
+        for (size_t i = 0; i < WORDS; i++) {
+            _words[i].store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief Publish a new value (single writer only)
+     */
+    void write(const T& value) {
+        uint32_t buf[WORDS] = {};
+        memcpy(buf, &value, sizeof(T));
+
+        const uint32_t seq = _seq.load(std::memory_order_relaxed);
+        _seq.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        for (size_t i = 0; i < WORDS; i++) {
+            _words[i].store(buf[i], std::memory_order_relaxed);
+        }
+
+        _seq.store(seq + 2, std::memory_order_release);
+    }
+
+    /**
+     * @brief Read a consistent copy, retrying across concurrent writes
+     */
+    T read() const {
+        uint32_t buf[WORDS];
+        uint32_t before;
+        uint32_t after;
+
+        do {
+            before = _seq.load(std::memory_order_acquire);
+            for (size_t i = 0; i < WORDS; i++) {
+                buf[i] = _words[i].load(std::memory_order_relaxed);
+            }
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = _seq.load(std::memory_order_relaxed);
+        } while ((before & 1) || before != after);
+
+        T value;
+        memcpy(&value, buf, sizeof(T));
+        return value;
+    }
+
+    /**
+     * @return Even sequence number, incremented by 2 on every write
+     */
+    uint32_t version() const {
+        return _seq.load(std::memory_order_acquire) & ~1u;
+    }
+
+private:
+    static const size_t WORDS = (sizeof(T) + sizeof(uint32_t) - 1) / sizeof(uint32_t);
+
+    std::atomic<uint32_t> _seq{0};
+    std::atomic<uint32_t> _words[WORDS];
+};
+
+#endif // VTXSEQLOCK_H
@@ -0,0 +1,308 @@
+/**
+ * @file VTXSniffer.cpp
+ * @brief Listen-only decoder for the traffic between a flight controller and a VTX
+ */
+
+#include "VTXSniffer.h"
+
+#include <stdio.h>
+
+#define VTX_SNIFFER_READ_CHUNK  32
+
+VTXSniffer::VTXSniffer(VTXProtocolType protocol) : _protocol(protocol) {
+    // Set requests are only seen on a bus we don't drive ourselves
+    _trampParser.setAcceptRequests(true);
+}
+
+VTXSniffer::~VTXSniffer() {
+    end();
+}
+
+bool VTXSniffer::begin(VTXTransport* transport) {
+    end();
+    if (!transport || !transport->open()) {
+        return false;
+    }
+
+    uint32_t baud = TRAMP_BAUD;
+    VTXFraming framing = VTX_FRAMING_8N1;
+    if (_protocol == VTX_PROTOCOL_SMARTAUDIO) {
+        baud = VTX_SMARTAUDIO_BAUD_4800;
+        framing = VTX_FRAMING_8N2;
+    } else if (_protocol == VTX_PROTOCOL_MSP) {
+        baud = MSP_VTX_BAUD;
+    }
+    if (!transport->configure(baud, framing)) {
+        transport->close();
+        return false;
+    }
+
+    _transport = transport;
+    _byteUs = ((framing == VTX_FRAMING_8N2) ? 11 : 10) * 1000000UL / baud;
+    resetParser();
+    resetSummary();
+
+    // The receive context owns the parsers from here on
+    _eventDriven = true;
+    _lastByteUs = micros();
+    if (!_transport->setReceiveCallback(receiveCallback, this)) {
+        _eventDriven = false;
+    }
+    return true;
+}
+
+void VTXSniffer::end() {
+    if (!_transport) {
+        return;
+    }
+    if (_eventDriven) {
+        _transport->setReceiveCallback(nullptr, nullptr);
+        _eventDriven = false;
+    }
+    _transport->close();
+    _transport = nullptr;
+}
+
+uint8_t VTXSniffer::update(uint8_t maxFrames) {
+    uint8_t frames = 0;
+    VTXSnifferFrame frame;
+
+    // Also drains what is left after end()
+    while (frames < maxFrames && _queue.pop(frame)) {
+        process(frame);
+        frames++;
+    }
+
+    if (_eventDriven || !_transport) {
+        return frames;
+    }
+
+    // Byte by byte when limited, so bytes past the last wanted frame stay buffered
+    uint8_t buf[VTX_SNIFFER_READ_CHUNK];
+    const size_t chunk = (maxFrames == 0xFF) ? sizeof(buf) : 1;
+    size_t n;
+    int pending;
+    while (frames < maxFrames && (pending = _transport->available()) > 0 &&
+           (n = _transport->read(buf, chunk)) > 0) {
+        const uint32_t now = micros();
+        for (size_t i = 0; i < n; i++) {
+            if (parseByte(buf[i], frame)) {
+                frame.timeUs = byteTimeUs(now, pending, i);
+                process(frame);
+                frames++;
+            }
+        }
+    }
+    return frames;
+}
+
+void VTXSniffer::setCapture(Print* capture) {
+    _capture = capture;
+    if (_capture) {
+        _capture->println("time_us,direction,command,event,bytes");
+    }
+}
+
+VTXSnifferSummary VTXSniffer::getSummary() const {
+    VTXSnifferSummary summary = _summary;
+    summary.overruns = _queue.overruns() - _overrunBase;
+    summary.responseAvgUs = _responseCount ? (uint32_t)(_responseTotalUs / _responseCount) : 0;
+    return summary;
+}
+
+void VTXSniffer::resetSummary() {
+    _summary = VTXSnifferSummary();
+    _overrunBase = _queue.overruns();
+    _responseTotalUs = 0;
+    _responseCount = 0;
+    _pendingCount = 0;
+}
+
+void VTXSniffer::printSummary(Print& out) const {
+    const VTXSnifferSummary summary = getSummary();
+    out.print("requests=");
+    out.print(summary.requests);
+    out.print(" responses=");
+    out.print(summary.responses);
+    out.print(" unanswered=");
+    out.print(summary.unanswered);
+    out.print(" errors=");
+    out.print(summary.errors);
+    out.print(" overruns=");
+    out.print(summary.overruns);
+    out.print(" response_us=");
+    out.print(summary.responseMinUs);
+    out.print("/");
+    out.print(summary.responseAvgUs);
+    out.print("/");
+    out.println(summary.responseMaxUs);
+}
+
+// ===== Private Methods =====
+
+void VTXSniffer::receiveCallback(void* context) {
+    static_cast<VTXSniffer*>(context)->receiveEvent();
+}
+
+void VTXSniffer::receiveEvent() {
+    uint8_t buf[VTX_SNIFFER_READ_CHUNK];
+    VTXSnifferFrame frame;
+    size_t n;
+
+    int pending;
+    while ((pending = _transport->available()) > 0 && (n = _transport->read(buf, sizeof(buf))) > 0) {
+        const uint32_t now = micros();
+
+        // Frames are sent back to back; a long pause ends any partial frame.
+        // Measured between bytes, as a busy line keeps reads far apart.
+        if (byteTimeUs(now, pending, 0) - _lastByteUs > (VTX_RX_RESYNC_GAP_BYTES + 1) * _byteUs) {
+            resetParser();
+        }
+        _lastByteUs = byteTimeUs(now, pending, n - 1);
+
+        for (size_t i = 0; i < n; i++) {
+            if (parseByte(buf[i], frame)) {
+                frame.timeUs = byteTimeUs(now, pending, i);
+                _queue.push(frame);
+            }
+        }
+    }
+}
+
+bool VTXSniffer::parseByte(uint8_t c, VTXSnifferFrame& frame) {
+    const uint8_t* data = nullptr;
+    uint8_t size = 0;
+
+    if (_protocol == VTX_PROTOCOL_SMARTAUDIO) {
+        frame.event = _saParser.feed(c);
+        if (frame.event == VTX_RX_FRAME) {
+            data = _saParser.frame();
+            size = _saParser.frameLength();
+            const bool request = SmartAudioParser::isRequest(data);
+            frame.direction = request ? VTX_SNIFF_REQUEST : VTX_SNIFF_RESPONSE;
+            frame.command = request ? data[2] >> 1 : data[2];
+        }
+    } else if (_protocol == VTX_PROTOCOL_TRAMP) {
+        frame.event = _trampParser.feed(c);
+        if (frame.event == VTX_RX_FRAME) {
+            data = _trampParser.frame();
+            size = TRAMP_PACKET_SIZE;
+            frame.direction = TrampParser::isRequest(data) ? VTX_SNIFF_REQUEST : VTX_SNIFF_RESPONSE;
+            frame.command = data[1];
+        }
+    } else {
+        const uint16_t checksumErrors = _mspParser.checksumErrors();
+        frame.event = _mspParser.feed(c) ? VTX_RX_FRAME :
+                      (_mspParser.checksumErrors() != checksumErrors ? MSP_RX_BAD_CHECKSUM : VTX_RX_NONE);
+        if (frame.event == VTX_RX_FRAME) {
+            // Re-encoded, the parser keeps the payload only
+            const MSPFrame& msp = _mspParser.frame();
+            data = _mspFrame;
+            size = mspEncode(msp.direction, msp.cmd, msp.payload, msp.size, _mspFrame, sizeof(_mspFrame));
+            frame.direction = (msp.direction == MSP_DIR_REQUEST) ? VTX_SNIFF_REQUEST : VTX_SNIFF_RESPONSE;
+            frame.command = msp.cmd;
+        }
+    }
+
+    if (frame.event == VTX_RX_NONE) {
+        return false;
+    }
+    if (frame.event != VTX_RX_FRAME) {
+        frame.direction = VTX_SNIFF_REQUEST;
+        frame.command = 0;
+    }
+    frame.size = size;
+    memcpy(frame.data, data, size < VTX_SNIFFER_FRAME_MAX ? size : VTX_SNIFFER_FRAME_MAX);
+    return true;
+}
+
+void VTXSniffer::resetParser() {
+    _saParser.reset();
+    _trampParser.reset();
+    _mspParser.reset();
+}
+
+void VTXSniffer::process(const VTXSnifferFrame& frame) {
+    expireRequests(frame.timeUs);
+
+    if (frame.event != VTX_RX_FRAME) {
+        _summary.errors++;
+    } else if (frame.direction == VTX_SNIFF_REQUEST) {
+        _summary.requests++;
+
+        // TRAMP set requests are never answered
+        const bool query = frame.command == TRAMP_CMD_RESET || frame.command == TRAMP_CMD_STATUS ||
+                           frame.command == TRAMP_CMD_TEMP;
+        if (_protocol != VTX_PROTOCOL_TRAMP || query) {
+            if (_pendingCount == VTX_SNIFFER_MAX_PENDING) {
+                _summary.unanswered++;
+                popRequest();
+            }
+            _pendingUs[_pendingCount++] = frame.timeUs;
+        }
+    } else {
+        _summary.responses++;
+
+        // Replies come in request order
+        if (_pendingCount > 0) {
+            const uint32_t us = frame.timeUs - _pendingUs[0];
+            popRequest();
+            if (_responseCount == 0 || us < _summary.responseMinUs) {
+                _summary.responseMinUs = us;
+            }
+            if (us > _summary.responseMaxUs) {
+                _summary.responseMaxUs = us;
+            }
+            _responseTotalUs += us;
+            _responseCount++;
+        }
+    }
+
+    if (_callback) {
+        _callback(frame, _callbackContext);
+    }
+    if (_capture) {
+        captureFrame(frame);
+    }
+}
+
+uint32_t VTXSniffer::byteTimeUs(uint32_t readUs, int pending, size_t index) const {
+    // The last byte pending at the read arrived just before it, the others one character time apart
+    const size_t after = (size_t)pending > index ? pending - 1 - index : 0;
+    return readUs - after * _byteUs;
+}
+
+void VTXSniffer::expireRequests(uint32_t nowUs) {
+    while (_pendingCount > 0 && nowUs - _pendingUs[0] > VTX_SNIFFER_REPLY_TIMEOUT_US) {
+        _summary.unanswered++;
+        popRequest();
+    }
+}
+
+void VTXSniffer::popRequest() {
+    _pendingCount--;
+    for (uint8_t i = 0; i < _pendingCount; i++) {
+        _pendingUs[i] = _pendingUs[i + 1];
+    }
+}
+
+void VTXSniffer::captureFrame(const VTXSnifferFrame& frame) {
+    static const char hex[] = "0123456789ABCDEF";
+    // time, direction, command, event, up to VTX_SNIFFER_FRAME_MAX bytes, newline
+    char line[48 + 2 * VTX_SNIFFER_FRAME_MAX];
+
+    const char* direction = (frame.event != VTX_RX_FRAME) ? "ERR" :
+                            (frame.direction == VTX_SNIFF_REQUEST) ? "REQ" : "RSP";
+    int len = snprintf(line, sizeof(line), "%lu,%s,%u,%u,",
+                       (unsigned long)frame.timeUs, direction, frame.command, frame.event);
+
+    const uint8_t bytes = frame.size < VTX_SNIFFER_FRAME_MAX ? frame.size : VTX_SNIFFER_FRAME_MAX;
+    for (uint8_t i = 0; i < bytes; i++) {
+        line[len++] = hex[frame.data[i] >> 4];
+        line[len++] = hex[frame.data[i] & 0x0F];
+    }
+    line[len++] = '\n';
+
+    // One write per line, so a capture to a UART goes out as a block
+    _capture->write((const uint8_t*)line, len);
+}
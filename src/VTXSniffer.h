@@ -0,0 +1,150 @@
+/**
+ * @file VTXSniffer.h
+ * @brief Listen-only decoder for the traffic between a flight controller and a VTX
+ *
+ * Attach it to the RX pin of a UART tapped onto a SmartAudio, TRAMP or MSP
+ * VTX line. It never transmits. Both directions are decoded with the
+ * engines' frame parsers and every frame is timestamped when its last byte
+ * arrives.
+ *
+ * Where the transport has a receive callback, decoding runs in the driver's
+ * event task. Frames reach update() through a lock-free queue of
+ * BETAVTX_SNIFFER_QUEUE_SIZE entries. update() keeps the summary, calls the
+ * frame callback and writes the capture.
+ */
+
+#ifndef VTXSNIFFER_H
+#define VTXSNIFFER_H
+
+#include "BetaVTXControl.h"
+#include "VTXFrameParser.h"
+#include "MSPCodec.h"
+#include "VTXSpscRing.h"
+
+#define VTX_SNIFFER_FRAME_MAX   24      // Frame bytes kept; longer MSP frames are cut
+#define VTX_SNIFFER_MAX_PENDING 8       // Requests sent ahead of their replies that are matched up
+#define VTX_SNIFFER_REPLY_TIMEOUT_US 500000  // Longer without a reply counts a request as unanswered
+
+enum VTXSnifferDirection : uint8_t {
+    VTX_SNIFF_REQUEST,      // Flight controller to VTX
+    VTX_SNIFF_RESPONSE      // VTX to flight controller
+};
+
+/**
+ * @brief One decoded frame, or a parser error
+ */
+struct VTXSnifferFrame {
+    uint32_t timeUs;                // micros() at the arrival of the last byte (estimated)
+    uint8_t event;                  // VTX_RX_FRAME or the protocol's parser error
+    VTXSnifferDirection direction;
+    uint8_t command;                // SmartAudio command number, TRAMP code letter or MSP command
+    uint8_t size;                   // Frame length on the wire
+    uint8_t data[VTX_SNIFFER_FRAME_MAX];  // Frame as on the wire, preamble to checksum
+};
+
+/**
+ * @brief Called from update() for every frame and parser error
+ */
+typedef void (*VTXSnifferCallback)(const VTXSnifferFrame& frame, void* context);
+
+struct VTXSnifferSummary {
+    uint32_t requests;
+    uint32_t responses;
+    uint32_t unanswered;            // Requests without a reply within VTX_SNIFFER_REPLY_TIMEOUT_US
+    uint32_t errors;                // Bad preamble, length or checksum
+    uint32_t overruns;              // Frames lost because update() fell behind
+    uint32_t responseMinUs;         // End of request to end of its reply, 0 until measured
+    uint32_t responseAvgUs;
+    uint32_t responseMaxUs;
+};
+
+class VTXSniffer {
+public:
+    explicit VTXSniffer(VTXProtocolType protocol);
+    ~VTXSniffer();
+
+    /**
+     * @brief Open the transport at the protocol's line settings and start listening
+     * @param transport Port wired to the VTX line; its TX is never used
+     * @return false if the transport could not be opened
+     */
+    bool begin(VTXTransport* transport);
+
+    void end();
+
+    /**
+     * @brief Process received frames; call regularly from one task
+     *
+     * Without a receive callback this also reads the port.
+     *
+     * @param maxFrames Stop after this many frames
+     * @return Frames processed
+     */
+    uint8_t update(uint8_t maxFrames = 0xFF);
+
+    void setFrameCallback(VTXSnifferCallback callback, void* context = nullptr) {
+        _callback = callback;
+        _callbackContext = context;
+    }
+
+    /**
+     * @brief Write every frame as a CSV line, starting with a header line
+     *
+     * Columns: time_us, direction (REQ, RSP or ERR), command, event and the
+     * frame bytes in hex. nullptr stops the capture.
+     */
+    void setCapture(Print* capture);
+
+    /**
+     * @return true if frames are decoded in the transport's receive callback
+     */
+    bool isEventDriven() const { return _eventDriven; }
+
+    /**
+     * @brief Counters since begin() or resetSummary(); call from the task running update()
+     */
+    VTXSnifferSummary getSummary() const;
+    void resetSummary();
+
+    /**
+     * @brief Print the summary as one line
+     */
+    void printSummary(Print& out) const;
+
+private:
+    VTXProtocolType _protocol;
+    VTXTransport* _transport = nullptr;
+    bool _eventDriven = false;
+    uint32_t _byteUs = 0;           // Wire time of one character
+    uint32_t _lastByteUs = 0;       // Estimated arrival of the last byte read in the callback
+
+    SmartAudioParser _saParser;
+    TrampParser _trampParser;
+    MSPParser _mspParser;
+    uint8_t _mspFrame[MSP_FRAME_OVERHEAD + MSP_MAX_PAYLOAD];
+
+    VTXSpscRing<VTXSnifferFrame, BETAVTX_SNIFFER_QUEUE_SIZE> _queue;
+    uint32_t _overrunBase = 0;      // Queue overruns at the last resetSummary()
+
+    VTXSnifferCallback _callback = nullptr;
+    void* _callbackContext = nullptr;
+    Print* _capture = nullptr;
+
+    VTXSnifferSummary _summary = {};
+    uint64_t _responseTotalUs = 0;
+    uint32_t _responseCount = 0;
+    uint32_t _pendingUs[VTX_SNIFFER_MAX_PENDING];   // Requests awaiting a reply, oldest first
+    uint8_t _pendingCount = 0;
+
+    static void receiveCallback(void* context);
+    void receiveEvent();
+    bool parseByte(uint8_t c, VTXSnifferFrame& frame);
+    void resetParser();
+    void process(const VTXSnifferFrame& frame);
+    uint32_t byteTimeUs(uint32_t readUs, int pending, size_t index) const;
+    void expireRequests(uint32_t nowUs);
+    void popRequest();
+    void captureFrame(const VTXSnifferFrame& frame);
+};
+
+#endif // VTXSNIFFER_H
@@ -0,0 +1,72 @@
+/**
+ * @file VTXSpscRing.h
+ * @brief Lock-free single-producer/single-consumer ring of small POD items
+ *
+ * Used to hand received frames from the UART event context (producer) to
+ * the task running update() (consumer). Each index is written by one side
+ * only, so no locks or read-modify-write atomics are needed.
+ */
+
+#ifndef VTXSPSCRING_H
+#define VTXSPSCRING_H
+
+#include <atomic>
+#include <type_traits>
+
+#include "VTXPlatform.h"
+
+template <typename T, uint8_t N>
+class VTXSpscRing {
+    static_assert(N >= 2 && N <= 128 && (N & (N - 1)) == 0, "VTXSpscRing size must be a power of two");
+    static_assert(std::is_trivially_copyable<T>::value, "VTXSpscRing items must be trivially copyable");
+
+public:
+    /**
+     * @brief Append an item (producer only)
+     * @return false if the ring is full; the item is dropped
+     */
+    bool push(const T& item) {
+        const uint8_t head = _head.load(std::memory_order_relaxed);
+        const uint8_t tail = _tail.load(std::memory_order_acquire);
+        if ((uint8_t)(head - tail) == N) {
+            // Only the producer writes it, no read-modify-write needed
+            _overruns.store(_overruns.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+            return false;
+        }
+        _items[head & (N - 1)] = item;
+        _head.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    /**
+     * @brief Take the oldest item (consumer only)
+     * @return false if the ring is empty
+     */
+    bool pop(T& item) {
+        const uint8_t tail = _tail.load(std::memory_order_relaxed);
+        const uint8_t head = _head.load(std::memory_order_acquire);
+        if (head == tail) {
+            return false;
+        }
+        item = _items[tail & (N - 1)];
+        _tail.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return _head.load(std::memory_order_acquire) == _tail.load(std::memory_order_acquire);
+    }
+
+    /**
+     * @return Items dropped because the consumer fell behind (written by the producer)
+     */
+    uint32_t overruns() const { return _overruns.load(std::memory_order_relaxed); }
+
+private:
+    T _items[N];
+    std::atomic<uint8_t> _head{0};     // Written by the producer
+    std::atomic<uint8_t> _tail{0};     // Written by the consumer
+    std::atomic<uint32_t> _overruns{0};
+};
+
+#endif // VTXSPSCRING_H
@@ -0,0 +1,103 @@
+/**
+ * @file VTXState.h
+ * @brief Cached VTX state snapshot and change notification types
+ */
+
+#ifndef VTXSTATE_H
+#define VTXSTATE_H
+
+#include "VTXPlatform.h"
+
+#define VTX_MAX_STATE_LISTENERS 4
+
+/**
+ * @brief Last state reported by the VTX
+ *
+ * Values are only meaningful once @c valid is set, i.e. after the first
+ * status response has been parsed. TX-only links never become valid.
+ */
+struct VTXState {
+    uint16_t frequency;     // MHz
+    uint16_t power;         // mW (SmartAudio: derived from power index)
+    uint16_t actualPower;   // mW measured by the VTX (TRAMP only)
+    int16_t temperature;    // Degrees C (TRAMP only)
+    uint8_t powerIndex;     // Raw device power index (SmartAudio only)
+    bool pitMode;
+    bool valid;
+};
+
+/**
+ * @brief State fields, usable as a bit mask when registering listeners
+ */
+enum VTXStateField {
+    VTX_FIELD_FREQUENCY     = 0x01,
+    VTX_FIELD_POWER         = 0x02,
+    VTX_FIELD_PIT_MODE      = 0x04,
+    VTX_FIELD_TEMPERATURE   = 0x08,
+    VTX_FIELD_ACTUAL_POWER  = 0x10,
+    VTX_FIELD_ALL           = 0x1F
+};
+
+/**
+ * @brief Called from update() when a field changes value
+ * @param field Field that changed
+ * @param oldValue Previous value (pit mode: 0/1)
+ * @param newValue New value
+ * @param context User pointer given at registration
+ */
+typedef void (*VTXStateCallback)(VTXStateField field, int32_t oldValue, int32_t newValue, void* context);
+
+#define VTX_LINK_DOWN_TIMEOUTS  3   // Replies missed in a row before the link counts as down
+
+/**
+ * @brief Whether the VTX is answering, as seen by the link supervisor
+ */
+enum VTXLinkState {
+    VTX_LINK_UNKNOWN,       // No reply since begin() (TX-only links stay here)
+    VTX_LINK_UP,
+    VTX_LINK_DOWN,          // Replies missing, probing for the device
+    VTX_LINK_RESTORING      // Device is back, re-applying the last requested settings
+};
+
+/**
+ * @brief Called from update() when the link state changes
+ */
+typedef void (*VTXLinkCallback)(VTXLinkState state, void* context);
+
+struct VTXLinkStatistics {
+    uint16_t linkDowns;         // Times the link went down
+    uint32_t lastRecoveryMs;    // First reply after link-down until settings were restored
+    uint32_t maxRecoveryMs;
+    uint16_t restoreFailures;   // Restore commands that finished without confirmation
+};
+
+/**
+ * @brief Time-to-pit of a safe boot, measured from begin()
+ */
+struct VTXSafeBootStatistics {
+    uint32_t firstFrameUs;      // Pit-on frame handed to the transport
+    uint32_t confirmedUs;       // VTX reported pit mode, 0 until then (or on TX-only links)
+};
+
+/**
+ * @brief Run time of update(budgetUs) calls since the last reset
+ */
+struct VTXUpdateStatistics {
+    uint32_t calls;
+    uint32_t maxUs;             // Worst case
+    uint32_t avgUs;
+    uint32_t overruns;          // Calls that returned after their budget
+};
+
+/**
+ * @brief Timing of a scheduled command, in micros()
+ */
+struct VTXScheduleResult {
+    uint32_t deadlineUs;        // Requested end of the frame on the wire
+    uint32_t plannedStartUs;    // deadlineUs minus the frame's wire time
+    uint32_t startUs;           // First byte on the wire (estimated from the TX FIFO level)
+    int32_t startErrorUs;       // startUs - plannedStartUs, negative if early
+    bool sent;                  // false until the frame went out, or if cancelled
+};
+
+#endif // VTXSTATE_H
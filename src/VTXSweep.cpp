@@ -0,0 +1,147 @@
+/**
+ * @file VTXSweep.cpp
+ * @brief High-rate channel sweep with pre-encoded frames and absolute deadlines
+ */
+
+#include "VTXSweep.h"
+
+bool VTXSweep::begin(VTXProtocol* vtx, const uint16_t* freqs, uint8_t count, uint32_t dwellUs, bool loop) {
+    if (!vtx || !freqs || count == 0 || count > VTX_SWEEP_MAX_STEPS) {
+        return false;
+    }
+
+    _running = false;
+    _vtx = vtx;
+    _count = 0;
+    _loop = loop;
+
+    uint8_t maxLen = 0;
+    for (uint8_t i = 0; i < count; i++) {
+        Step& step = _steps[i];
+        step.freq = freqs[i];
+        step.length = vtx->encodeFrequencyFrame(freqs[i], step.frame, VTX_SWEEP_MAX_FRAME);
+        if (step.length == 0) {
+            return false;
+        }
+        if (step.length > maxLen) {
+            maxLen = step.length;
+        }
+    }
+    _count = count;
+
+    // A retune can't complete faster than its frame takes on the wire; one byte
+    // of slack so the previous frame has drained when the next one is due
+    const uint32_t minDwell = vtx->wireTimeUs(maxLen + 1);
+    _dwellUs = dwellUs > minDwell ? dwellUs : minDwell;
+
+    return true;
+}
+
+void VTXSweep::start() {
+    if (!_vtx || _count == 0) {
+        return;
+    }
+
+    _index = 0;
+    _retunes = 0;
+    _maxJitterUs = 0;
+    _sumJitterUs = 0;
+    _lateIssues = 0;
+    _failedIssues = 0;
+    _currentFreq = 0;
+
+    _startUs = micros();
+    _nextDeadline = _startUs;
+    _running = true;
+
+    update();
+}
+
+void VTXSweep::stop() {
+    _running = false;
+}
+
+void VTXSweep::update() {
+    if (!_running) {
+        return;
+    }
+
+    uint32_t now = micros();
+    int32_t remaining = (int32_t)(_nextDeadline - now);
+    if (remaining > VTX_SWEEP_SPIN_US) {
+        return;
+    }
+
+    // Close enough: spin the last few hundred microseconds for an exact start.
+    // delayMicroseconds() busy-waits on the targets (and moves the host's virtual clock)
+    while (remaining > 0) {
+        delayMicroseconds(remaining);
+        now = micros();
+        remaining = (int32_t)(_nextDeadline - now);
+    }
+
+    issue(now);
+}
+
+void VTXSweep::issue(uint32_t now) {
+    const Step& step = _steps[_index];
+    // All or nothing: a frame appended to bytes still on the wire, or cut short,
+    // garbles the retune and the one after it. Skipped while the line is busy.
+    if (_vtx->txPending() > 0 || _vtx->transmitRaw(step.frame, step.length) < step.length) {
+        _failedIssues++;
+    } else {
+        issued(step, now);
+    }
+
+    // Absolute schedule: lateness of one step does not shift the next one.
+    // After a stall, go on at the first slot the line is free for again instead
+    // of bursting through the missed ones.
+    _nextDeadline += _dwellUs;
+    const uint32_t lineFreeUs = micros() + _vtx->wireTimeUs(_vtx->txPending());
+    const int32_t behind = (int32_t)(lineFreeUs - _nextDeadline);
+    if (behind > 0) {
+        _nextDeadline += ((uint32_t)(behind - 1) / _dwellUs + 1) * _dwellUs;
+    }
+
+    if (++_index >= _count) {
+        _index = 0;
+        if (!_loop) {
+            _running = false;
+        }
+    }
+}
+
+void VTXSweep::issued(const Step& step, uint32_t now) {
+    const uint32_t jitter = now - _nextDeadline;
+    if (jitter > _maxJitterUs) {
+        _maxJitterUs = jitter;
+    }
+    if (jitter > _dwellUs) {
+        _lateIssues++;
+    }
+    _sumJitterUs += jitter;
+
+    _currentFreq = step.freq;
+    _lastIssueUs = now;
+    _retunes++;
+    _vtx->adoptFrequency(step.freq);
+}
+
+VTXSweep::Statistics VTXSweep::getStatistics() const {
+    Statistics stats = {};
+    stats.retunes = _retunes;
+    stats.maxJitterUs = _maxJitterUs;
+    stats.lateIssues = _lateIssues;
+    stats.failedIssues = _failedIssues;
+
+    if (_retunes > 0) {
+        stats.avgJitterUs = (uint32_t)(_sumJitterUs / _retunes);
+        // Rate measured between the first and last issue
+        stats.elapsedUs = _lastIssueUs - _startUs;
+        if (_retunes > 1 && stats.elapsedUs > 0) {
+            stats.retunesPerSecond = (uint32_t)(((uint64_t)(_retunes - 1) * 1000000ULL) / stats.elapsedUs);
+        }
+    }
+
+    return stats;
+}
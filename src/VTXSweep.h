@@ -0,0 +1,94 @@
+/**
+ * @file VTXSweep.h
+ * @brief High-rate channel sweep with pre-encoded frames and absolute deadlines
+ *
+ * Every set-frequency frame is encoded once in begin(). While running, each
+ * retune is issued at start + step * dwell (no cumulative drift), and the
+ * lateness of every issue is recorded as jitter.
+ *
+ * While a sweep is running call VTXSweep::update() instead of the protocol's
+ * update(), so status polling does not delay retunes. Each frequency issued
+ * becomes the engine's requested one (VTXProtocol::adoptFrequency()), so
+ * retries and link restores after the sweep don't go back to an old one.
+ */
+
+#ifndef VTXSWEEP_H
+#define VTXSWEEP_H
+
+#include "VTXProtocol.h"
+
+#define VTX_SWEEP_MAX_STEPS     64
+#define VTX_SWEEP_MAX_FRAME     20      // Largest wire image (TRAMP: VTX_MAX_DUMMY_BYTES + 16)
+#define VTX_SWEEP_SPIN_US       500     // Busy-wait window before a deadline
+
+class VTXSweep {
+public:
+    struct Statistics {
+        uint32_t retunes;
+        uint32_t elapsedUs;
+        uint32_t retunesPerSecond;  // Achieved rate over elapsedUs
+        uint32_t maxJitterUs;       // Worst issue lateness
+        uint32_t avgJitterUs;
+        uint32_t lateIssues;        // Issued more than one dwell late
+        uint32_t failedIssues;      // Steps skipped: TX still busy, or the frame not taken in full
+    };
+
+    /**
+     * @brief Prepare a sweep
+     * @param vtx Initialized protocol engine
+     * @param freqs Frequencies in MHz, visited in order
+     * @param count Number of entries (max VTX_SWEEP_MAX_STEPS)
+     * @param dwellUs Time to stay on each frequency; raised to the frame wire time if shorter
+     * @param loop Restart from the first entry after the last one
+     * @return false if arguments are invalid or a frame could not be encoded
+     */
+    bool begin(VTXProtocol* vtx, const uint16_t* freqs, uint8_t count, uint32_t dwellUs, bool loop = true);
+
+    void start();
+    void stop();
+    bool isRunning() const { return _running; }
+
+    /**
+     * @brief Issue the next retune if its deadline has been reached; call as often as possible
+     */
+    void update();
+
+    /**
+     * @return Frequency most recently issued, 0 before the first step
+     */
+    uint16_t currentFrequency() const { return _currentFreq; }
+
+    uint32_t getDwellUs() const { return _dwellUs; }
+    Statistics getStatistics() const;
+
+private:
+    struct Step {
+        uint16_t freq;
+        uint8_t length;
+        uint8_t frame[VTX_SWEEP_MAX_FRAME];
+    };
+
+    VTXProtocol* _vtx = nullptr;
+    Step _steps[VTX_SWEEP_MAX_STEPS];
+    uint8_t _count = 0;
+    uint8_t _index = 0;
+    bool _loop = true;
+    bool _running = false;
+
+    uint32_t _dwellUs = 0;
+    uint32_t _startUs = 0;
+    uint32_t _nextDeadline = 0;
+    uint16_t _currentFreq = 0;
+
+    uint32_t _retunes = 0;
+    uint32_t _lastIssueUs = 0;
+    uint32_t _maxJitterUs = 0;
+    uint64_t _sumJitterUs = 0;
+    uint32_t _lateIssues = 0;
+    uint32_t _failedIssues = 0;
+
+    void issue(uint32_t now);
+    void issued(const Step& step, uint32_t now);
+};
+
+#endif // VTXSWEEP_H
@@ -0,0 +1,345 @@
+/**
+ * @file VTXTable.cpp
+ * @brief Betaflight vtxtable definitions loaded at runtime
+ */
+
+#include "VTXTable.h"
+
+#include <ctype.h>
+#if VTX_TABLE_HAS_FILE_IO
+#include <stdio.h>
+#endif
+
+#define VTX_TABLE_INDEX_EMPTY   0xFF
+#define VTX_TABLE_MAX_TOKENS    (6 + VTX_TABLE_MAX_CHANNELS)
+
+static bool tokenEquals(const char* token, const char* word) {
+    while (*token && *word) {
+        if (tolower((unsigned char)*token) != *word) {
+            return false;
+        }
+        token++;
+        word++;
+    }
+    return *token == *word;
+}
+
+static bool parseNumber(const char* token, uint16_t* value) {
+    if (!*token) {
+        return false;
+    }
+
+    uint32_t v = 0;
+    for (const char* p = token; *p; p++) {
+        if (!isdigit((unsigned char)*p)) {
+            return false;
+        }
+        v = v * 10 + (*p - '0');
+        if (v > UINT16_MAX) {
+            return false;
+        }
+    }
+    *value = (uint16_t)v;
+    return true;
+}
+
+VTXTable::VTXTable() {
+    clear();
+}
+
+void VTXTable::clear() {
+    _bandCount = 0;
+    _channelCount = 0;
+    _powerLevelCount = 0;
+    _factoryMask = 0;
+    memset(_frequency, 0, sizeof(_frequency));
+    memset(_bandName, 0, sizeof(_bandName));
+    memset(_bandLetter, 0, sizeof(_bandLetter));
+    memset(_powerValue, 0, sizeof(_powerValue));
+    memset(_powerMw, 0, sizeof(_powerMw));
+    memset(_powerLabel, 0, sizeof(_powerLabel));
+    memset(_frequencyIndex, VTX_TABLE_INDEX_EMPTY, sizeof(_frequencyIndex));
+}
+
+bool VTXTable::parse(const char* text) {
+    clear();
+    _errorLine = 0;
+
+    char line[VTX_TABLE_MAX_LINE];
+    uint16_t lineNo = 0;
+
+    while (*text) {
+        lineNo++;
+
+        const char* end = text;
+        while (*end && *end != '\n') {
+            end++;
+        }
+
+        const size_t len = end - text;
+        if (len >= sizeof(line)) {
+            _errorLine = lineNo;
+            clear();
+            return false;
+        }
+        memcpy(line, text, len);
+        line[len] = '\0';
+
+        if (!parseLine(line)) {
+            _errorLine = lineNo;
+            clear();
+            return false;
+        }
+
+        text = *end ? end + 1 : end;
+    }
+
+    buildIndex();
+    return true;
+}
+
+#if VTX_TABLE_HAS_FILE_IO
+bool VTXTable::loadFile(const char* path) {
+    clear();
+    _errorLine = 0;
+
+    FILE* f = fopen(path, "r");
+    if (!f) {
+        return false;
+    }
+
+    // Line by line, so a full `diff all` dump can be loaded as is. One byte
+    // over parse()'s buffer for the '\n', so both take the same line lengths
+    char line[VTX_TABLE_MAX_LINE + 1];
+    uint16_t lineNo = 0;
+    bool ok = true;
+
+    while (fgets(line, sizeof(line), f)) {
+        lineNo++;
+
+        const size_t len = strlen(line);
+        if (len == sizeof(line) - 1 && line[len - 1] != '\n' && !feof(f)) {
+            ok = false;     // Line too long
+        } else if (!parseLine(line)) {
+            ok = false;
+        }
+        if (!ok) {
+            _errorLine = lineNo;
+            break;
+        }
+    }
+    fclose(f);
+
+    if (!ok) {
+        clear();
+        return false;
+    }
+
+    buildIndex();
+    return true;
+}
+#endif
+
+bool VTXTable::parseLine(char* line) {
+    char* tokens[VTX_TABLE_MAX_TOKENS + 1];
+    uint8_t count = 0;
+
+    for (char* p = line; *p; ) {
+        while (*p && isspace((unsigned char)*p)) {
+            *p++ = '\0';
+        }
+        if (!*p || *p == '#') {
+            break;
+        }
+        if (count > VTX_TABLE_MAX_TOKENS) {
+            return false;
+        }
+        tokens[count++] = p;
+        while (*p && !isspace((unsigned char)*p)) {
+            p++;
+        }
+    }
+
+    // Anything but a vtxtable command is not ours to judge
+    if (count == 0 || !tokenEquals(tokens[0], "vtxtable")) {
+        return true;
+    }
+    if (count < 2) {
+        return false;
+    }
+
+    const char* cmd = tokens[1];
+    uint16_t value;
+
+    if (tokenEquals(cmd, "bands")) {
+        if (count != 3 || !parseNumber(tokens[2], &value) || value > VTX_TABLE_MAX_BANDS) {
+            return false;
+        }
+        _bandCount = value;
+
+    } else if (tokenEquals(cmd, "channels")) {
+        if (count != 3 || !parseNumber(tokens[2], &value) || value > VTX_TABLE_MAX_CHANNELS) {
+            return false;
+        }
+        _channelCount = value;
+
+    } else if (tokenEquals(cmd, "band")) {
+        // band <n> <name> <letter> [FACTORY|CUSTOM] <freq> * channels
+        if (count < 5 || !parseNumber(tokens[2], &value) || value < 1 || value > _bandCount) {
+            return false;
+        }
+        const uint8_t band = value - 1;
+
+        uint8_t first = 5;
+        bool factory = false;
+        if (count > 5 && tokenEquals(tokens[5], "factory")) {
+            factory = true;
+            first = 6;
+        } else if (count > 5 && tokenEquals(tokens[5], "custom")) {
+            first = 6;
+        }
+
+        if (count - first != _channelCount || strlen(tokens[4]) != 1) {
+            return false;
+        }
+
+        strncpy(_bandName[band], tokens[3], VTX_TABLE_BAND_NAME_LEN);
+        _bandName[band][VTX_TABLE_BAND_NAME_LEN] = '\0';
+        _bandLetter[band] = tokens[4][0];
+        if (factory) {
+            _factoryMask |= 1 << band;
+        } else {
+            _factoryMask &= ~(1 << band);
+        }
+
+        for (uint8_t ch = 0; ch < _channelCount; ch++) {
+            if (!parseNumber(tokens[first + ch], &_frequency[band][ch])) {
+                return false;
+            }
+        }
+
+    } else if (tokenEquals(cmd, "powerlevels")) {
+        if (count != 3 || !parseNumber(tokens[2], &value) || value > VTX_TABLE_MAX_POWER_LEVELS) {
+            return false;
+        }
+        _powerLevelCount = value;
+
+    } else if (tokenEquals(cmd, "powervalues")) {
+        if (count - 2 != _powerLevelCount) {
+            return false;
+        }
+        for (uint8_t i = 0; i < _powerLevelCount; i++) {
+            if (!parseNumber(tokens[2 + i], &_powerValue[i])) {
+                return false;
+            }
+        }
+
+    } else if (tokenEquals(cmd, "powerlabels")) {
+        if (count - 2 != _powerLevelCount) {
+            return false;
+        }
+        for (uint8_t i = 0; i < _powerLevelCount; i++) {
+            strncpy(_powerLabel[i], tokens[2 + i], VTX_TABLE_POWER_LABEL_LEN);
+            _powerLabel[i][VTX_TABLE_POWER_LABEL_LEN] = '\0';
+            _powerMw[i] = labelToMw(_powerLabel[i]);
+        }
+
+    } else {
+        return false;
+    }
+
+    return true;
+}
+
+uint8_t VTXTable::hashFrequency(uint16_t freq) {
+    // Fibonacci hashing, top bits of the product
+    return (uint8_t)(((uint32_t)freq * 2654435761u) >> 25) & (VTX_TABLE_INDEX_SIZE - 1);
+}
+
+void VTXTable::buildIndex() {
+    memset(_frequencyIndex, VTX_TABLE_INDEX_EMPTY, sizeof(_frequencyIndex));
+
+    for (uint8_t band = 0; band < _bandCount; band++) {
+        for (uint8_t ch = 0; ch < _channelCount; ch++) {
+            const uint16_t freq = _frequency[band][ch];
+            if (freq == 0) {
+                continue;
+            }
+
+            uint8_t slot = hashFrequency(freq);
+            bool duplicate = false;
+            while (_frequencyIndex[slot] != VTX_TABLE_INDEX_EMPTY) {
+                const uint8_t entry = _frequencyIndex[slot];
+                if (_frequency[entry >> 4][entry & 0x0F] == freq) {
+                    duplicate = true;   // First band/channel wins, as in the default table lookup
+                    break;
+                }
+                slot = (slot + 1) & (VTX_TABLE_INDEX_SIZE - 1);
+            }
+            if (!duplicate) {
+                _frequencyIndex[slot] = (band << 4) | ch;
+            }
+        }
+    }
+}
+
+bool VTXTable::findFrequency(uint16_t freq, uint8_t* band, uint8_t* channel) const {
+    if (freq == 0) {
+        return false;
+    }
+
+    uint8_t slot = hashFrequency(freq);
+    while (_frequencyIndex[slot] != VTX_TABLE_INDEX_EMPTY) {
+        const uint8_t entry = _frequencyIndex[slot];
+        if (_frequency[entry >> 4][entry & 0x0F] == freq) {
+            *band = (entry >> 4) + 1;
+            *channel = (entry & 0x0F) + 1;
+            return true;
+        }
+        slot = (slot + 1) & (VTX_TABLE_INDEX_SIZE - 1);
+    }
+    return false;
+}
+
+uint8_t VTXTable::findPowerLevel(uint16_t powerMw) const {
+    uint8_t best = 0;
+    uint16_t bestDiff = UINT16_MAX;
+
+    for (uint8_t i = 0; i < _powerLevelCount; i++) {
+        if (_powerMw[i] == 0) {
+            continue;
+        }
+        const uint16_t diff = powerMw > _powerMw[i] ? powerMw - _powerMw[i] : _powerMw[i] - powerMw;
+        if (diff < bestDiff) {
+            bestDiff = diff;
+            best = i + 1;
+        }
+    }
+    return best;
+}
+
+uint8_t VTXTable::findPowerValue(uint16_t value) const {
+    for (uint8_t i = 0; i < _powerLevelCount; i++) {
+        if (_powerValue[i] == value) {
+            return i + 1;
+        }
+    }
+    return 0;
+}
+
+uint16_t VTXTable::labelToMw(const char* label) {
+    // "25", "200", "1W", "2W"; anything else (e.g. "MAX") has no mW value
+    uint16_t value = 0;
+    const char* p = label;
+    while (isdigit((unsigned char)*p)) {
+        value = value * 10 + (*p - '0');
+        p++;
+    }
+    if (p == label) {
+        return 0;
+    }
+    if (*p == 'W' || *p == 'w') {
+        return value * 1000;
+    }
+    return *p == '\0' ? value : 0;
+}
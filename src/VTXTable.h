@@ -0,0 +1,149 @@
+/**
+ * @file VTXTable.h
+ * @brief Betaflight vtxtable definitions loaded at runtime
+ *
+ * Parses the `vtxtable` block of a Betaflight CLI dump:
+ *
+ *   vtxtable bands 5
+ *   vtxtable channels 8
+ *   vtxtable band 1 BOSCAM_A A FACTORY 5865 5845 5825 5805 5785 5765 5745 5725
+ *   ...
+ *   vtxtable powerlevels 4
+ *   vtxtable powervalues 0 1 2 3
+ *   vtxtable powerlabels 25 200 500 800
+ *
+ * Band, channel and power level numbers are 1-based as in Betaflight.
+ * Lookups by (band, channel) and power level are direct array reads,
+ * reverse lookups by MHz go through a small open-addressing index and
+ * reverse lookups by mW scan at most VTX_TABLE_MAX_POWER_LEVELS entries.
+ */
+
+#ifndef VTXTABLE_H
+#define VTXTABLE_H
+
+#include "VTXPlatform.h"
+
+// File loading needs stdio files: host builds and ESP32 (VFS)
+#if !defined(ARDUINO) || defined(ESP_PLATFORM)
+#define VTX_TABLE_HAS_FILE_IO 1
+#else
+#define VTX_TABLE_HAS_FILE_IO 0
+#endif
+
+// Betaflight limits
+#define VTX_TABLE_MAX_BANDS         8
+#define VTX_TABLE_MAX_CHANNELS      8
+#define VTX_TABLE_MAX_POWER_LEVELS  8
+#define VTX_TABLE_BAND_NAME_LEN     8
+#define VTX_TABLE_POWER_LABEL_LEN   3
+
+#define VTX_TABLE_MAX_LINE          160
+#define VTX_TABLE_INDEX_SIZE        128     // Power of two, over twice bands * channels
+
+class VTXTable {
+public:
+    VTXTable();
+
+    void clear();
+
+    /**
+     * @brief Parse a vtxtable text block; other CLI lines and '#' comments are ignored
+     * @param text NUL-terminated text
+     * @return false on a malformed vtxtable line (see errorLine()); the table is left empty
+     */
+    bool parse(const char* text);
+
+    /**
+     * @brief Parse a vtxtable block, or a whole CLI dump, from a file (host, or a mounted VFS on ESP32)
+     */
+#if VTX_TABLE_HAS_FILE_IO
+    bool loadFile(const char* path);
+#endif
+
+    /**
+     * @return Line number of the last parse error, 0 if none
+     */
+    uint16_t errorLine() const { return _errorLine; }
+
+    /**
+     * @return true once bands, channels and at least one power level are defined
+     */
+    bool isValid() const { return _bandCount > 0 && _channelCount > 0 && _powerLevelCount > 0; }
+
+    uint8_t bandCount() const { return _bandCount; }
+    uint8_t channelCount() const { return _channelCount; }
+    uint8_t powerLevelCount() const { return _powerLevelCount; }
+
+    /**
+     * @return Frequency in MHz, 0 if out of range or the slot is unused
+     */
+    uint16_t frequency(uint8_t band, uint8_t channel) const {
+        if (band < 1 || band > _bandCount || channel < 1 || channel > _channelCount) {
+            return 0;
+        }
+        return _frequency[band - 1][channel - 1];
+    }
+
+    const char* bandName(uint8_t band) const { return validBand(band) ? _bandName[band - 1] : ""; }
+    char bandLetter(uint8_t band) const { return validBand(band) ? _bandLetter[band - 1] : 0; }
+
+    /**
+     * @return true if the band matches the VTX's built-in table (channel commands may be used)
+     */
+    bool isFactoryBand(uint8_t band) const { return validBand(band) && (_factoryMask & (1 << (band - 1))); }
+
+    /**
+     * @return Device specific value sent to the VTX for a power level, 0 if out of range
+     */
+    uint16_t powerValue(uint8_t level) const { return validLevel(level) ? _powerValue[level - 1] : 0; }
+
+    /**
+     * @return Power in mW from the level's label, 0 if the label is not numeric
+     */
+    uint16_t powerMw(uint8_t level) const { return validLevel(level) ? _powerMw[level - 1] : 0; }
+
+    const char* powerLabel(uint8_t level) const { return validLevel(level) ? _powerLabel[level - 1] : ""; }
+
+    /**
+     * @brief Reverse lookup of a frequency
+     * @return false if no band/channel maps to freq
+     */
+    bool findFrequency(uint16_t freq, uint8_t* band, uint8_t* channel) const;
+
+    /**
+     * @return Level whose mW is closest to powerMw (lower one on ties), 0 if none has a mW value
+     */
+    uint8_t findPowerLevel(uint16_t powerMw) const;
+
+    /**
+     * @return Level with the given device value, 0 if none
+     */
+    uint8_t findPowerValue(uint16_t value) const;
+
+private:
+    uint8_t _bandCount = 0;
+    uint8_t _channelCount = 0;
+    uint8_t _powerLevelCount = 0;
+    uint8_t _factoryMask = 0;
+    uint16_t _frequency[VTX_TABLE_MAX_BANDS][VTX_TABLE_MAX_CHANNELS];
+    char _bandName[VTX_TABLE_MAX_BANDS][VTX_TABLE_BAND_NAME_LEN + 1];
+    char _bandLetter[VTX_TABLE_MAX_BANDS];
+    uint16_t _powerValue[VTX_TABLE_MAX_POWER_LEVELS];
+    uint16_t _powerMw[VTX_TABLE_MAX_POWER_LEVELS];
+    char _powerLabel[VTX_TABLE_MAX_POWER_LEVELS][VTX_TABLE_POWER_LABEL_LEN + 1];
+
+    // (band - 1) << 4 | (channel - 1) per MHz hash slot, 0xFF when empty
+    uint8_t _frequencyIndex[VTX_TABLE_INDEX_SIZE];
+
+    uint16_t _errorLine = 0;
+
+    bool validBand(uint8_t band) const { return band >= 1 && band <= _bandCount; }
+    bool validLevel(uint8_t level) const { return level >= 1 && level <= _powerLevelCount; }
+
+    bool parseLine(char* line);
+    void buildIndex();
+    static uint8_t hashFrequency(uint16_t freq);
+    static uint16_t labelToMw(const char* label);
+};
+
+#endif // VTXTABLE_H
@@ -0,0 +1,112 @@
+/**
+ * @file VTXTelemetry.cpp
+ * @brief Fixed-memory multi-resolution telemetry history for a VTX link
+ */
+
+#include "VTXTelemetry.h"
+
+static const uint32_t telemetryPeriodMs[VTX_TELEMETRY_LEVELS] = { 1000, 10000, 60000 };
+
+VTXTelemetryHistory::VTXTelemetryHistory() {
+    clear();
+}
+
+void VTXTelemetryHistory::clear() {
+    memset(_buckets, 0, sizeof(_buckets));
+    memset(_head, 0, sizeof(_head));
+    memset(_bucketStartMs, 0, sizeof(_bucketStartMs));
+    _started = false;
+}
+
+uint32_t VTXTelemetryHistory::bucketPeriodMs(VTXTelemetryResolution resolution) {
+    return resolution < VTX_TELEMETRY_LEVELS ? telemetryPeriodMs[resolution] : 0;
+}
+
+void VTXTelemetryHistory::advance(uint32_t nowMs) {
+    if (!_started) {
+        for (uint8_t level = 0; level < VTX_TELEMETRY_LEVELS; level++) {
+            _bucketStartMs[level] = nowMs;
+        }
+        _started = true;
+        return;
+    }
+
+    for (uint8_t level = 0; level < VTX_TELEMETRY_LEVELS; level++) {
+        const uint32_t period = telemetryPeriodMs[level];
+        const uint32_t elapsed = nowMs - _bucketStartMs[level];
+        if (elapsed < period) {
+            continue;
+        }
+
+        // Skip over silent intervals, but never clear more than the whole ring
+        const uint32_t steps = elapsed / period;
+        const uint32_t clearSteps = steps < VTX_TELEMETRY_BUCKETS ? steps : VTX_TELEMETRY_BUCKETS;
+        for (uint32_t i = 0; i < clearSteps; i++) {
+            _head[level] = (_head[level] + 1) % VTX_TELEMETRY_BUCKETS;
+            for (uint8_t metric = 0; metric < VTX_METRIC_COUNT; metric++) {
+                memset(&_buckets[metric][level][_head[level]], 0, sizeof(VTXTelemetryBucket));
+            }
+        }
+        _bucketStartMs[level] += steps * period;
+    }
+}
+
+void VTXTelemetryHistory::record(VTXTelemetryMetric metric, int16_t value, uint32_t nowMs) {
+    if (metric >= VTX_METRIC_COUNT) {
+        return;
+    }
+
+    advance(nowMs);
+
+    for (uint8_t level = 0; level < VTX_TELEMETRY_LEVELS; level++) {
+        VTXTelemetryBucket& b = _buckets[metric][level][_head[level]];
+        if (b.count == UINT16_MAX) {
+            continue;   // Saturated, keep the average consistent
+        }
+        if (b.count == 0) {
+            b.min = value;
+            b.max = value;
+        } else {
+            if (value < b.min) b.min = value;
+            if (value > b.max) b.max = value;
+        }
+        b.sum += value;
+        b.count++;
+    }
+}
+
+VTXTelemetryBucket VTXTelemetryHistory::getBucket(VTXTelemetryMetric metric,
+                                                  VTXTelemetryResolution resolution,
+                                                  uint8_t age) const {
+    VTXTelemetryBucket empty = {};
+    if (metric >= VTX_METRIC_COUNT || resolution >= VTX_TELEMETRY_LEVELS || age >= VTX_TELEMETRY_BUCKETS) {
+        return empty;
+    }
+
+    const uint8_t index = (_head[resolution] + VTX_TELEMETRY_BUCKETS - age) % VTX_TELEMETRY_BUCKETS;
+    return _buckets[metric][resolution][index];
+}
+
+VTXTelemetryBucket VTXTelemetryHistory::summarize(VTXTelemetryMetric metric,
+                                                  VTXTelemetryResolution resolution,
+                                                  uint8_t count) const {
+    VTXTelemetryBucket total = {};
+    for (uint8_t age = 0; age < count && age < VTX_TELEMETRY_BUCKETS; age++) {
+        merge(total, getBucket(metric, resolution, age));
+    }
+    return total;
+}
+
+void VTXTelemetryHistory::merge(VTXTelemetryBucket& into, const VTXTelemetryBucket& from) {
+    if (from.count == 0) {
+        return;
+    }
+    if (into.count == 0) {
+        into = from;
+        return;
+    }
+    if (from.min < into.min) into.min = from.min;
+    if (from.max > into.max) into.max = from.max;
+    into.sum += from.sum;
+    into.count = (into.count + from.count < UINT16_MAX) ? into.count + from.count : UINT16_MAX;
+}
@@ -0,0 +1,93 @@
+/**
+ * @file VTXTelemetry.h
+ * @brief Fixed-memory multi-resolution telemetry history for a VTX link
+ *
+ * Each metric keeps three ring buffers of min/avg/max buckets (1 s, 10 s
+ * and 1 min by default). Every sample goes into the current bucket of all
+ * three levels, so recording is O(1) and memory never grows. Attach one
+ * history per link with VTXProtocol::setTelemetry().
+ */
+
+#ifndef VTXTELEMETRY_H
+#define VTXTELEMETRY_H
+
+#include "VTXPlatform.h"
+
+// Buckets kept per resolution; memory is 3 metrics * 3 levels * buckets * 12 bytes
+#ifndef VTX_TELEMETRY_BUCKETS
+#define VTX_TELEMETRY_BUCKETS   60
+#endif
+
+#define VTX_TELEMETRY_ERROR     1000    // LINK_ERRORS sample for a failed exchange
+
+enum VTXTelemetryMetric {
+    VTX_METRIC_TEMPERATURE,     // Degrees C (TRAMP 's' reply)
+    VTX_METRIC_POWER,           // Output power in mW (measured where the VTX reports it)
+    VTX_METRIC_LINK_ERRORS,     // 0 per good reply, VTX_TELEMETRY_ERROR per timeout/corrupt frame
+    VTX_METRIC_COUNT
+};
+
+enum VTXTelemetryResolution {
+    VTX_TELEMETRY_1S,
+    VTX_TELEMETRY_10S,
+    VTX_TELEMETRY_1MIN,
+    VTX_TELEMETRY_LEVELS
+};
+
+struct VTXTelemetryBucket {
+    int32_t sum;
+    int16_t min;
+    int16_t max;
+    uint16_t count;         // 0: no samples in this interval
+
+    /**
+     * @return Mean of the samples; for LINK_ERRORS the error rate in per mille
+     */
+    int16_t avg() const { return count ? (int16_t)(sum / count) : 0; }
+};
+
+class VTXTelemetryHistory {
+public:
+    VTXTelemetryHistory();
+
+    /**
+     * @brief Add one sample, O(1)
+     */
+    void record(VTXTelemetryMetric metric, int16_t value, uint32_t nowMs);
+
+    /**
+     * @brief Close buckets whose interval has passed
+     *
+     * record() does this itself; call it before reading if the link may
+     * have been silent, so idle intervals show up as empty buckets.
+     */
+    void advance(uint32_t nowMs);
+
+    /**
+     * @param age 0 for the bucket still being filled, 1 for the last closed one, ...
+     * @return Bucket, empty if age is beyond VTX_TELEMETRY_BUCKETS - 1
+     */
+    VTXTelemetryBucket getBucket(VTXTelemetryMetric metric, VTXTelemetryResolution resolution,
+                                 uint8_t age) const;
+
+    /**
+     * @brief Merge the newest buckets into one summary (e.g. last 5 minutes)
+     * @param count Number of buckets, starting with the current one
+     */
+    VTXTelemetryBucket summarize(VTXTelemetryMetric metric, VTXTelemetryResolution resolution,
+                                 uint8_t count) const;
+
+    static uint32_t bucketPeriodMs(VTXTelemetryResolution resolution);
+
+    void clear();
+
+private:
+    VTXTelemetryBucket _buckets[VTX_METRIC_COUNT][VTX_TELEMETRY_LEVELS][VTX_TELEMETRY_BUCKETS];
+    uint8_t _head[VTX_TELEMETRY_LEVELS];
+    uint32_t _bucketStartMs[VTX_TELEMETRY_LEVELS];
+    bool _started = false;
+
+    static void merge(VTXTelemetryBucket& into, const VTXTelemetryBucket& from);
+};
+
+#endif // VTXTELEMETRY_H
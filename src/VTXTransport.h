@@ -0,0 +1,99 @@
+/**
+ * @file VTXTransport.h
+ * @brief Abstract byte transport used by the VTX protocol engines
+ *
+ * Decouples SmartAudio/TRAMP from the ESP32 HardwareSerial API so the same
+ * engines can run over an ESP-IDF UART driver or a POSIX tty on a host.
+ */
+
+#ifndef VTXTRANSPORT_H
+#define VTXTRANSPORT_H
+
+#include "VTXPlatform.h"
+
+enum VTXFraming {
+    VTX_FRAMING_8N1,    // TRAMP
+    VTX_FRAMING_8N2     // SmartAudio
+};
+
+/**
+ * @brief Called from the driver's receive context when bytes have arrived
+ */
+typedef void (*VTXReceiveCallback)(void* context);
+
+class VTXTransport {
+public:
+    virtual ~VTXTransport() {}
+
+    /**
+     * @brief Acquire the underlying port
+     * @return true if the port is usable
+     */
+    virtual bool open() = 0;
+
+    virtual void close() = 0;
+
+    /**
+     * @brief Set line parameters; may be called again to reconfigure an open port
+     * @param baud Baud rate
+     * @param framing Data/stop bit layout
+     * @return true if the port was configured
+     */
+    virtual bool configure(uint32_t baud, VTXFraming framing) = 0;
+
+    /**
+     * @return Number of bytes that can be read without blocking
+     */
+    virtual int available() = 0;
+
+    /**
+     * @brief Non-blocking read
+     * @return Number of bytes copied into buf (0 if none pending)
+     */
+    virtual size_t read(uint8_t* buf, size_t len) = 0;
+
+    /**
+     * @brief Non-blocking write into the transmit buffer
+     * @return Number of bytes accepted
+     */
+    virtual size_t write(const uint8_t* buf, size_t len) = 0;
+
+    /**
+     * @return Bytes accepted by write() that have not left the wire yet
+     */
+    virtual size_t txPending() = 0;
+
+    /**
+     * @brief Block until all pending bytes have been transmitted
+     */
+    virtual void flush() = 0;
+
+    /**
+     * @return false if the port is wired TX-only (responses can never arrive)
+     */
+    virtual bool hasRx() const { return true; }
+
+    /**
+     * @brief Get called as soon as received bytes are available
+     *
+     * The callback runs in the driver's event task, not the caller's, and
+     * should read() everything pending. Pass nullptr to unregister.
+     *
+     * @return false if the transport can't signal reception (poll instead)
+     */
+    virtual bool setReceiveCallback(VTXReceiveCallback callback, void* context) {
+        (void)callback;
+        (void)context;
+        return false;
+    }
+
+    /**
+     * @return Single byte, or -1 if nothing is pending
+     */
+    int read() {
+        uint8_t c;
+        return read(&c, 1) == 1 ? c : -1;
+    }
+};
+
+#endif // VTXTRANSPORT_H